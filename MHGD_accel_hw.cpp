@@ -1,6 +1,7 @@
 #include "MyComplex_1.h"
 #include "hls_math.h"
 #include "MHGD_accel_hw.h"
+#include "qam_slicer.h"
 #include <stdio.h>
 #include <string.h>
 #include "hls_stream.h"
@@ -27,6 +28,10 @@ MyComplex _64QAM_Constellation_hw[64] = {{-7.0, 7.0},  {-5.0, 7.0},  {-3.0, 7.0}
                                          {1.0, -5.0},  {3.0, -5.0},  {5.0, -5.0}, {7.0, -5.0}, //
                                          {-7.0, -7.0}, {-5.0, -7.0}, {-3.0, -7.0},{-1.0, -7.0},
                                          {1.0, -7.0},  {3.0, -7.0},  {5.0, -7.0}, {7.0, -7.0}};
+#if defined(PROFILE_STAGES) && !defined(__SYNTHESIS__)
+thread_local unsigned int mhgd_prof_muls = 0;
+thread_local unsigned int mhgd_prof_csim[256];
+#endif
 
 
 /********************************************************************************************/
@@ -184,8 +189,11 @@ void _64QAM_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod)
 		{
 			temp_1[j].real = x_hat[i].real * hls::sqrt((ap_fixed<40,8>)42.0);
 			temp_1[j].imag = x_hat[i].imag * hls::sqrt((ap_fixed<40,8>)42.0);
+			/*差值减半后再求平方和：最远点距离平方可达2*14^2=392，超出like_float范围；等比缩放不影响argmin*/
 			temp[j].real = temp_1[j].real - _64QAM_Constellation_hw[j].real;
 			temp[j].imag = temp_1[j].imag - _64QAM_Constellation_hw[j].imag;
+			temp[j].real = temp[j].real >> 1;
+			temp[j].imag = temp[j].imag >> 1;
 			distance[j] = temp[j].real * temp[j].real + temp[j].imag * temp[j].imag;
 		}
 		best_id = argmin_hw(distance, 64);
@@ -310,22 +318,22 @@ MyComplex complex_conjugate_hw(MyComplex a) {
 	result.imag = -a.imag;  // 虚部取负
 	return result;
 }
-template <typename T>
+template <typename T, int N>
 void c_eye_generate_hw(T* Mat, float val)
 {
 	#pragma HLS INLINE
 	like_float val_1 = val;
     int i;
-	for (i = 0; i < Ntr_2; i++)
+	for (i = 0; i < N * N; i++)
 	{
 		#pragma HLS unroll
 		Mat[i].real = (like_float)0.0;
 		Mat[i].imag = (like_float)0.0;
 	}
-	for (i = 0; i < Ntr_1; i++)
+	for (i = 0; i < N; i++)
 	{
 		#pragma HLS unroll
-		Mat[i * Ntr_1 + i].real = val;
+		Mat[i * N + i].real = val;
 	}
 }
 template <typename TH, typename TY, typename TV, typename TH_real, typename TH_imag, typename TY_real, typename TY_imag, typename TV_real, typename TV_imag>
@@ -410,21 +418,21 @@ void c_matmultiple_hw(TA* matA, int transA, TB* matB, int transB, int ma, int na
 		}
 	}
 }
-template<typename TA, typename TB, typename TR>
+template<typename TA, typename TB, typename TR, int LEN>
 void my_complex_add_hw(const TA a[], const TB b[], TR r[])
 {
 	#pragma HLS INLINE
-	for (int i = 0; i < Ntr_2; i++) {
+	for (int i = 0; i < LEN; i++) {
 		#pragma HLS pipeline II=1
 		r[i].real = a[i].real + b[i].real; 
 		r[i].imag = a[i].imag + b[i].imag;  
 	}
 }
-template<typename TA, typename TB, typename TR>
+template<typename TA, typename TB, typename TR, int LEN>
 void my_complex_add_hw_1(const TA a[], const TB b[], TR r[])
 {
 	#pragma HLS INLINE
-	for (int i = 0; i < Ntr_1; i++) {
+	for (int i = 0; i < LEN; i++) {
 		#pragma HLS pipeline II=1
 		r[i].real = a[i].real + b[i].real; 
 		r[i].imag = a[i].imag + b[i].imag;  
@@ -474,6 +482,7 @@ MyComplex complex_multiply_hw(TA a, TB b)
     local_temp_2 = a.imag * b.imag;
     local_temp_3 = a.real * b.imag;
     local_temp_4 = a.imag * b.real;
+	PROF_MULS(4);
     result.real = local_temp_1 - local_temp_2;
     result.imag = local_temp_3 + local_temp_4;
     return result;
@@ -499,11 +508,11 @@ MyComplex complex_subtract_hw(TA a, TB b)
     return result;
 }
 // 复数数组减法
-template<typename TA, typename TB, typename TR>
+template<typename TA, typename TB, typename TR, int LEN>
 void my_complex_sub_hw(const TA a[], const TB b[], TR r[])
 {
 	#pragma HLS INLINE
-	for (int i = 0; i < Ntr_1; i++) {
+	for (int i = 0; i < LEN; i++) {
 		#pragma HLS unroll
 		r[i].real = a[i].real - b[i].real;  
 		r[i].imag = a[i].imag - b[i].imag; 
@@ -634,19 +643,19 @@ void Inverse_LU_hw(TA* A)
 	MulMatrix_hw(U_Inverse, L_Inverse, A);
 }
 // 缩放复数数组
-template<typename TX>
+template<typename TX, int LEN>
 void my_complex_scal_hw(const like_float alpha, TX* X, const int incX)
 {
-	for (int i = 0; i < Ntr_1; i++) {
+	for (int i = 0; i < LEN; i++) {
 		#pragma HLS unroll II=2
 		X[i * incX].real *= alpha;  // 实部乘以 alpha
 		X[i * incX].imag *= alpha;  // 虚部乘以 alpha
 	}
 }
-template<typename TX>
+template<typename TX, int LEN>
 void my_complex_scal_hw_1(const like_float alpha, TX* X, const int incX)
 {
-	for (int i = 0; i < mu_double; i++) {
+	for (int i = 0; i < LEN; i++) {
 		#pragma HLS unroll II=2
 		X[i * incX].real *= alpha;  // 实部乘以 alpha
 		X[i * incX].imag *= alpha;  // 虚部乘以 alpha
@@ -699,15 +708,16 @@ T fixed_floor(const T& val) {
     }
     return truncated;
 }
-// 星座点映射
-template<typename TX, typename TX_hat, typename x_real, typename hat_real>
+// 星座点映射：按2*dqam为间隔取整到奇数格点，再按调制阶数MU限幅到±amp_max
+template<typename TX, typename TX_hat, typename x_real, typename hat_real, int N, int MU>
 void map_hw(like_float dqam, TX* x, TX_hat* x_hat)
 {
     const hat_real one(1.0);
+    const hat_real amp_max(qam_traits<MU>::amp_max);
     const like_float divisor = dqam << 1;  // 合并分母运算
 	x_real divisor_1 = divisor;
 	int i;
-	for (i = 0; i < Ntr_1; i++)
+	for (i = 0; i < N; i++)
 	{
 		#pragma HLS pipeline
 		// 实部处理（单次除法+定点floor）
@@ -719,31 +729,12 @@ void map_hw(like_float dqam, TX* x, TX_hat* x_hat)
         x_real temp_imag = x[i].imag / divisor_1;
         x_real floored_imag = fixed_floor<x_real>(temp_imag);
         x_hat[i].imag = (hat_real)((floored_imag << 1) + one);
-		switch (mu_1)
-		{
-		case 2:
-			x_hat[i].real = (x_hat[i].real > hat_real(1.0)) ? hat_real(1.0) : x_hat[i].real;
-			x_hat[i].real = (x_hat[i].real < hat_real(-1.0)) ? hat_real(-1.0) : x_hat[i].real;
-			x_hat[i].imag = (x_hat[i].imag > hat_real(1.0)) ? hat_real(1.0) : x_hat[i].imag;
-			x_hat[i].imag = (x_hat[i].imag < hat_real(-1.0)) ? hat_real(-1.0) : x_hat[i].imag;
-			break;
-		case 4:
-			x_hat[i].real = (x_hat[i].real > hat_real(3.0)) ? hat_real(3.0) : x_hat[i].real;
-			x_hat[i].real = (x_hat[i].real < hat_real(-3.0)) ? hat_real(-3.0) : x_hat[i].real;
-			x_hat[i].imag = (x_hat[i].imag > hat_real(3.0)) ? hat_real(3.0) : x_hat[i].imag;
-			x_hat[i].imag = (x_hat[i].imag < hat_real(-3.0)) ? hat_real(-3.0) : x_hat[i].imag;
-			break;
-		case 6:
-			x_hat[i].real = (x_hat[i].real > hat_real(7.0)) ? hat_real(7.0) : x_hat[i].real;
-			x_hat[i].real = (x_hat[i].real < hat_real(-7.0)) ? hat_real(-7.0) : x_hat[i].real;
-			x_hat[i].imag = (x_hat[i].imag > hat_real(7.0)) ? hat_real(7.0) : x_hat[i].imag;
-			x_hat[i].imag = (x_hat[i].imag < hat_real(-7.0)) ? hat_real(-7.0) : x_hat[i].imag;
-			break;
-		default:
-			break;
-		}
+		x_hat[i].real = (x_hat[i].real > amp_max) ? amp_max : x_hat[i].real;
+		x_hat[i].real = (x_hat[i].real < -amp_max) ? (hat_real)-amp_max : x_hat[i].real;
+		x_hat[i].imag = (x_hat[i].imag > amp_max) ? amp_max : x_hat[i].imag;
+		x_hat[i].imag = (x_hat[i].imag < -amp_max) ? (hat_real)-amp_max : x_hat[i].imag;
 	}
-	my_complex_scal_hw(dqam, x_hat, 1);
+	my_complex_scal_hw<TX_hat, N>(dqam, x_hat, 1);
 }
 // 生成均匀分布随机整数
 void generateUniformRandoms_int_hw(int* x_init)
@@ -754,21 +745,21 @@ void generateUniformRandoms_int_hw(int* x_init)
 	}
 }
 // 复制复数数组
-template<typename TX, typename TY>
+template<typename TX, typename TY, int LEN>
 void my_complex_copy_hw(const TX* X, const int incX, TY* Y, const int incY)
 {
 	#pragma HLS inline
-	for (int i = 0, j = 0; i < Ntr_1; i++, j++) {
+	for (int i = 0, j = 0; i < LEN; i++, j++) {
 		#pragma HLS pipeline
 		Y[j * incY].real = X[i * incX].real;  // 复制实部
 		Y[j * incY].imag = X[i * incX].imag;  // 复制虚部
 	}
 }
 // 复制复数数组
-template<typename TX, typename TY>
+template<typename TX, typename TY, int LEN>
 void my_complex_copy_hw_1(const TX* X, const int incX, TY* Y, const int incY)
 {
-	for (int i = 0, j = 0; i < mu_double; i++, j++) {
+	for (int i = 0, j = 0; i < LEN; i++, j++) {
 		#pragma HLS unroll
 		Y[j * incY].real = X[i * incX].real;  // 复制实部
 		Y[j * incY].imag = X[i * incX].imag;  // 复制虚部
@@ -1305,19 +1296,13 @@ like_float lcg_rand_1_hw_fixed(unsigned int &seed) {
     return *reinterpret_cast<like_float*>(&raw_bits);
 }
 // 生成均匀分布随机整数
+template<int N, int MU>
 void generateUniformRandoms_int_hw_pro_0(unsigned int &seed, int* x_init)
 {
-	// 生成 Nt 个随机数
-	for (int i = 0; i < Ntr_1; ++i) {
+	// 生成 N 个随机数：取31位LCG输出的高MU位，范围0 ~ 2^MU-1（MU=4时即>>27 & 0x0F）
+	for (int i = 0; i < N; ++i) {
 		#pragma HLS pipeline II=1
-		// 生成0-63
-		// x_init[i] = (lcg_rand_hw_opt(seed) >> 25) & 0x3F;
-
-		// 生成 0-15：
-		x_init[i] = (lcg_rand_hw_opt(seed) >> 27) & 0x0F; 
-
-		// 生成 0-3：
-		// x_init[i] = (lcg_rand_hw_opt(seed) >> 29) & 0x03;
+		x_init[i] = (lcg_rand_hw_opt(seed) >> (31 - MU)) & ((1 << MU) - 1);
 	}
 }
 void generateUniformRandoms_float_hw_pro(unsigned int &seed, like_float* p_uni)
@@ -1326,6 +1311,18 @@ void generateUniformRandoms_float_hw_pro(unsigned int &seed, like_float* p_uni)
 		p_uni[i] = lcg_rand_1_hw_fixed(seed);
 	}
 }
+// 生成复高斯随机数（Box-Muller）：v = sqrt(-ln(u1)) * e^(j*2*pi*u2)
+// 实部、虚部各为方差1/2的正态分布，与主机高斯表（读入时已除以sqrt(2)）的统计特性一致
+void gauss_rand_hw(unsigned int &seed, MyComplex_v &v)
+{
+	#pragma HLS pipeline II=1
+	like_float u1 = (like_float)1 - lcg_rand_1_hw_fixed(seed);	// (0,1]，避免log(0)
+	like_float u2 = lcg_rand_1_hw_fixed(seed);
+	like_float mag = hls::sqrt((like_float)(-hls::log(u1)));
+	like_float theta = u2 * (like_float)(2 * M_PI);
+	v.real = mag * hls::cos(theta);
+	v.imag = mag * hls::sin(theta);
+}
 
 //////矩阵乘法
 template<typename TA, typename TB, typename TR>
@@ -1378,6 +1375,267 @@ void c_matmultiple_hw_pro(
 		}
 	}
 }
+/**********************************************************************************/
+/*编译期定长的矩阵/向量乘法：尺寸与转置均为模板参数，内层全展开并用加法树求和。
+  定点加法满足结合律，结果与c_matmultiple_hw_pro逐位一致*/
+// N个复数两两相加的加法树，结果位于p[0]
+template<int N>
+MyComplex complex_adder_tree_hw(MyComplex p[N])
+{
+	#pragma HLS INLINE
+	for (int s = 1; s < N; s *= 2) {
+		#pragma HLS UNROLL
+		for (int i = 0; i + s < N; i += 2 * s) {
+			#pragma HLS UNROLL
+			p[i] = complex_add_hw(p[i], p[i + s]);
+		}
+	}
+	return p[0];
+}
+// y = op(A) * x，A为M×N行主序；CONJ_T=0时y长度为M，CONJ_T=1时op(A)=A^H、y长度为N
+template<int M, int N, int CONJ_T, typename TA, typename TX, typename TR>
+void c_gemv_hw(const TA* A, const TX* x, TR* y)
+{
+	const int ROWS = CONJ_T ? N : M;
+	const int COLS = CONJ_T ? M : N;
+	for (int i = 0; i < ROWS; i++) {
+		#pragma HLS PIPELINE II=1
+		MyComplex p[COLS];
+		#pragma HLS ARRAY_PARTITION variable=p complete
+		for (int l = 0; l < COLS; l++) {
+			#pragma HLS UNROLL
+			TA a;
+			if (CONJ_T) {
+				a.real = A[l * N + i].real;
+				a.imag = -A[l * N + i].imag;
+			}
+			else {
+				a = A[i * N + l];
+			}
+			p[l] = complex_multiply_hw(a, x[l]);
+		}
+		MyComplex sum = complex_adder_tree_hw<COLS>(p);
+		y[i].real = sum.real;
+		y[i].imag = sum.imag;
+	}
+}
+// 内积 a^H * b
+template<int N, typename TA, typename TB>
+MyComplex c_dot_hw(const TA* a, const TB* b)
+{
+	#pragma HLS INLINE
+	MyComplex p[N];
+	#pragma HLS ARRAY_PARTITION variable=p complete
+	for (int l = 0; l < N; l++) {
+		#pragma HLS UNROLL
+		TA a_conj;
+		a_conj.real = a[l].real;
+		a_conj.imag = -a[l].imag;
+		p[l] = complex_multiply_hw(a_conj, b[l]);
+	}
+	return complex_adder_tree_hw<N>(p);
+}
+// 平方范数 a^H * a，只计算实部
+template<int N, typename TA>
+like_float c_norm2_hw(const TA* a)
+{
+	#pragma HLS INLINE
+	like_float p[N];
+	#pragma HLS ARRAY_PARTITION variable=p complete
+	for (int l = 0; l < N; l++) {
+		#pragma HLS UNROLL
+		like_float re2 = a[l].real * a[l].real;
+		like_float im2 = a[l].imag * a[l].imag;
+		p[l] = re2 + im2;
+	}
+	PROF_MULS(2 * N);
+	for (int s = 1; s < N; s *= 2) {
+		#pragma HLS UNROLL
+		for (int i = 0; i + s < N; i += 2 * s) {
+			#pragma HLS UNROLL
+			p[i] = p[i] + p[i + s];
+		}
+	}
+	return p[0];
+}
+// C = op(A) * op(B)，均为N×N行主序；CONJ_A/CONJ_B=1时取共轭转置（如H^H*H、T*H^H）
+template<int N, int CONJ_A, int CONJ_B, typename TA, typename TB, typename TC>
+void c_gemm_hw(const TA* A, const TB* B, TC* C)
+{
+	for (int i = 0; i < N; i++) {
+		for (int j = 0; j < N; j++) {
+			#pragma HLS PIPELINE II=1
+			MyComplex p[N];
+			#pragma HLS ARRAY_PARTITION variable=p complete
+			for (int l = 0; l < N; l++) {
+				#pragma HLS UNROLL
+				TA a;
+				TB b;
+				if (CONJ_A) {
+					a.real = A[l * N + i].real;
+					a.imag = -A[l * N + i].imag;
+				}
+				else {
+					a = A[i * N + l];
+				}
+				if (CONJ_B) {
+					b.real = B[j * N + l].real;
+					b.imag = -B[j * N + l].imag;
+				}
+				else {
+					b = B[l * N + j];
+				}
+				p[l] = complex_multiply_hw(a, b);
+			}
+			MyComplex sum = complex_adder_tree_hw<N>(p);
+			C[i * N + j].real = sum.real;
+			C[i * N + j].imag = sum.imag;
+		}
+	}
+}
+// Gram矩阵 C = A^H * A（A为M×N行主序，C为N×N）。结果Hermitian，只计算下三角N(N+1)/2个元素，对角线为实数；
+// MIRROR=1时按共轭对称补齐上三角，MIRROR=0时上三角保持不变（只读下三角的使用者，如Inverse_LDL_fixed）
+template<int M, int N, int MIRROR, typename TA, typename TC>
+void c_gram_hw(const TA* A, TC* C)
+{
+	int i = 0, j = 0;
+	/*下三角按行展平为一个循环，便于以II=1流水*/
+	for (int p = 0; p < N * (N + 1) / 2; p++) {
+		#pragma HLS PIPELINE II=1
+		MyComplex prod[M];
+		#pragma HLS ARRAY_PARTITION variable=prod complete
+		for (int l = 0; l < M; l++) {
+			#pragma HLS UNROLL
+			TA a;
+			a.real = A[l * N + i].real;
+			a.imag = -A[l * N + i].imag;
+			prod[l] = complex_multiply_hw(a, A[l * N + j]);
+		}
+		MyComplex sum = complex_adder_tree_hw<M>(prod);
+		C[i * N + j].real = sum.real;
+		C[i * N + j].imag = (i == j) ? (Myimage)0 : sum.imag;
+		if (MIRROR && i != j) {
+			C[j * N + i].real = sum.real;
+			C[j * N + i].imag = -sum.imag;
+		}
+		if (j == i) {
+			i++;
+			j = 0;
+		}
+		else {
+			j++;
+		}
+	}
+}
+/*脉动阵列复数矩阵乘 C = op(A) * op(B)，op(A)为M×K，op(B)为K×N，结果C为M×N行主序。
+  CONJ_A=1时A按K×M存储并取共轭转置，CONJ_B=1时B按N×K存储并取共轭转置。
+  输出驻留（output-stationary）结构：M×N个PE，A从左侧逐行错拍流入、B从上方逐列错拍流入，
+  每拍每个PE做一次复数乘加并把A/B寄存后传给右侧/下方PE，共K+M+N-2拍完成*/
+template<int M, int K, int N, int CONJ_A, int CONJ_B, typename TA, typename TB, typename TC>
+void c_gemm_systolic_hw(const TA* A, const TB* B, TC* C)
+{
+	TA a_buf[M][K];	/*op(A)，每行对应左侧一个输入端口*/
+	TB b_buf[K][N];	/*op(B)，每列对应上方一个输入端口*/
+	TA a_reg[M][N];	/*PE(i,j)向右传递的A元素*/
+	TB b_reg[M][N];	/*PE(i,j)向下传递的B元素*/
+	MyComplex acc[M][N];
+	#pragma HLS ARRAY_PARTITION variable=a_buf complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=b_buf complete dim=2
+	#pragma HLS ARRAY_PARTITION variable=a_reg complete dim=0
+	#pragma HLS ARRAY_PARTITION variable=b_reg complete dim=0
+	#pragma HLS ARRAY_PARTITION variable=acc complete dim=0
+	/*载入并完成共轭转置*/
+	for (int i = 0; i < M; i++) {
+		for (int l = 0; l < K; l++) {
+			#pragma HLS PIPELINE II=1
+			if (CONJ_A) {
+				a_buf[i][l].real = A[l * M + i].real;
+				a_buf[i][l].imag = -A[l * M + i].imag;
+			}
+			else {
+				a_buf[i][l] = A[i * K + l];
+			}
+		}
+	}
+	for (int l = 0; l < K; l++) {
+		for (int j = 0; j < N; j++) {
+			#pragma HLS PIPELINE II=1
+			if (CONJ_B) {
+				b_buf[l][j].real = B[j * K + l].real;
+				b_buf[l][j].imag = -B[j * K + l].imag;
+			}
+			else {
+				b_buf[l][j] = B[l * N + j];
+			}
+		}
+	}
+	for (int i = 0; i < M; i++) {
+		#pragma HLS UNROLL
+		for (int j = 0; j < N; j++) {
+			#pragma HLS UNROLL
+			a_reg[i][j].real = 0; a_reg[i][j].imag = 0;
+			b_reg[i][j].real = 0; b_reg[i][j].imag = 0;
+			acc[i][j].real = 0; acc[i][j].imag = 0;
+		}
+	}
+	SYSTOLIC:
+	for (int t = 0; t < K + M + N - 2; t++) {
+		#pragma HLS PIPELINE II=1
+		/*从右下往左上更新，保证每个PE读到的是相邻PE上一拍的寄存值*/
+		for (int i = M - 1; i >= 0; i--) {
+			#pragma HLS UNROLL
+			for (int j = N - 1; j >= 0; j--) {
+				#pragma HLS UNROLL
+				TA a_in;
+				TB b_in;
+				if (j == 0) {
+					/*第i行错拍i个周期进入*/
+					int l = t - i;
+					if (l >= 0 && l < K) {
+						a_in = a_buf[i][l];
+					}
+					else {
+						a_in.real = 0; a_in.imag = 0;
+					}
+				}
+				else {
+					a_in = a_reg[i][j - 1];
+				}
+				if (i == 0) {
+					/*第j列错拍j个周期进入*/
+					int l = t - j;
+					if (l >= 0 && l < K) {
+						b_in = b_buf[l][j];
+					}
+					else {
+						b_in.real = 0; b_in.imag = 0;
+					}
+				}
+				else {
+					b_in = b_reg[i - 1][j];
+				}
+				acc[i][j] = complex_add_hw(acc[i][j], complex_multiply_hw(a_in, b_in));
+				a_reg[i][j] = a_in;
+				b_reg[i][j] = b_in;
+			}
+		}
+	}
+	for (int i = 0; i < M; i++) {
+		for (int j = 0; j < N; j++) {
+			#pragma HLS PIPELINE II=1
+			C[i * N + j].real = acc[i][j].real;
+			C[i * N + j].imag = acc[i][j].imag;
+		}
+	}
+}
+#ifdef GEMM_VERIFY
+/*C仿真比对用的显式实例化（main_hw.cpp中的GEMM_VERIFY）*/
+template void c_gemm_systolic_hw<Ntr_1, Ntr_1, Ntr_1, 1, 0, MyComplex_H, MyComplex_H, MyComplex_HH>(const MyComplex_H*, const MyComplex_H*, MyComplex_HH*);
+template void c_gemm_systolic_hw<Ntr_1, Ntr_1, Ntr_1, 0, 0, MyComplex_H, MyComplex_grad_preconditioner, MyComplex_temp_NtNr>(const MyComplex_H*, const MyComplex_grad_preconditioner*, MyComplex_temp_NtNr*);
+template void c_gemm_systolic_hw<Ntr_1, Ntr_1, Ntr_1, 0, 1, MyComplex_temp_NtNr, MyComplex_H, MyComplex_pmat>(const MyComplex_temp_NtNr*, const MyComplex_H*, MyComplex_pmat*);
+template void c_gemm_systolic_hw<16, 12, 16, 1, 1, MyComplex, MyComplex, MyComplex>(const MyComplex*, const MyComplex*, MyComplex*);
+template void c_gram_hw<Ntr_1, Ntr_1, 1, MyComplex_H, MyComplex_HH>(const MyComplex_H*, MyComplex_HH*);
+#endif
 // blackbox版本
 void c_matmultiple_hw_pro_wrapper(
     ap_fixed<40,8>* matA_real, ap_fixed<40,8>* matA_imag,
@@ -1388,108 +1646,6 @@ void c_matmultiple_hw_pro_wrapper(
     // 这个函数不会被综合，只是作为黑盒的接口
 }
 
-// //脉动阵列版本设计
-// template<typename TA, typename TB, typename TR>
-// void c_matmultiple_hw_pro_maidong(
-//     TA* matA, int transA,
-//     TB* matB, int transB,
-//     int ma, int na, int mb, int nb,
-//     TR* res)
-// {
-// 	// 确定矩阵维度
-//     int m = (transA == 0) ? ma : na;  // 结果矩阵行数
-//     int k = (transA == 0) ? na : ma;  // 公共维度
-//     int n = (transB == 0) ? nb : mb;  // 结果矩阵列数
-// 
-// 	// 一些静态int
-// 	static int ROW_REG_DEPTH = m + k;
-// 	static int COL_REG_DEPTH = n + k;
-// 	static int MAX_DEPTH = (ROW_REG_DEPTH > COL_REG_DEPTH) ? ROW_REG_DEPTH : COL_REG_DEPTH;
-// 
-// 	// 数组声明
-// 	TA hang[m][ROW_REG_DEPTH];
-// 	TB lie[n][COL_REG_DEPTH];
-// 	TA left[m];
-// 	TB up[n];
-// 	TA right[m][n];
-// 	TB down[m][n];
-// 	MyComplex sum[m][n];
-// 
-// 	MyComplex left_in;
-// 	MyComplex up_in;
-// 
-// 	int flag;
-// 
-// 	MyComplex temp = {0.0, 0.0};
-// 	// 行列数组初始化 - 确保未填充区域为0
-//     for(int i = 0; i < m; i++) {
-//         for(int j = 0; j < ROW_REG_DEPTH; j++) {
-// 			#pragma HLS unroll
-//             hang[i][j] = {0, 0};  // 确保所有元素初始化为0
-//         }
-//     }
-//     
-//     for(int i = 0; i < n; i++) {
-//         for(int j = 0; j < COL_REG_DEPTH; j++) {
-// 			#pragma HLS unroll
-//             lie[i][j] = {0, 0};   // 确保所有元素初始化为0
-//         }
-//     }
-// 	//斜线填充
-// 	for(int i=0; i<m; i++){
-// 		for(int j=0; j<k; j++){
-// 			#pragma HLS pipeline
-// 			int r=i+j;
-// 			if(r<ROW_REG_DEPTH){
-// 				hang[i][r].real = matA[i*k+j].real;
-// 				hang[i][r].imag = transA?(-matA[i*k+j].imag):matA[i*k+j].imag;
-// 			}
-// 		}
-// 	}
-// 	for(int i=0; i<n; i++){
-// 		for(int j=0; j<k; j++){
-// 			#pragma HLS pipeline
-// 			int r=i+j;
-// 			if(r<COL_REG_DEPTH){
-// 				lie[i][r].real = matB[j*n+i].real;
-// 				lie[i][r].imag = transB?(-matB[j*n+i].imag):matB[j*n+i].imag;
-// 			}
-// 		}
-// 	}
-// 
-// 	//左侧和上方输入
-// 	for(int cycle=0; cycle<MAX_DEPTH; cycle++){
-// 		flag = cycle;
-// 		for(int i=0; i<m; i++){
-// 			left[i].real = (flag < ROW_REG_DEPTH) ? hang[i][flag].real : 0;
-// 			left[i].imag = (flag < ROW_REG_DEPTH) ? hang[i][flag].imag : 0;
-// 		}
-// 		for(int i=0; i<m; i++){
-// 			up[i].real = (flag < COL_REG_DEPTH) ? lie[i][flag].real : 0;
-// 			up[i].imag = (flag < COL_REG_DEPTH) ? lie[i][flag].imag : 0;
-// 		}
-// 		for(int row=0; row<m; row++){
-// 			for(int col=0; col<n; col++){
-// 				#pragma HLS PIPELINE II=1
-// 				left_in = (col==0) ? left[row] : right[row][col-1];
-// 				up_in = (row==0) ? up[col]: down[row-1][col];
-// 				temp = complex_multiply_hw(left_in, up_in);
-// 				sum[row][col] = complex_add_hw(sum[row][col], temp);
-// 				right[row][col] = left_in;
-// 				down[row][col] = up_in;
-// 			}
-// 		}
-// 	}
-// 
-// 	// 收集结果
-//     for (int i = 0; i < m; i++) {
-//         for (int j = 0; j < n; j++) {
-// 			#pragma HLS unroll
-//             res[i * n + j] = sum[i][j];
-//         }
-//     }
-// }
-// 
 void Inverse_LDL(MyComplex_f* A){
 	//过程量定义
 	MyComplex_f L[Ntr_2];    // 单位下三角矩阵
@@ -1709,6 +1865,129 @@ void Inverse_LDL_pro(MyComplex_f* A){
         }
     }
 }
+/*正数d的倒数：d = m * 2^e（m在[1,2)），以m的高6位小数查1/m的初值（取区间中点的倒数，相对误差不超过2^-7），
+  再做两次牛顿迭代y = y*(2 - m*y)（相对误差约2^-14、2^-28），最后移回2^-e。代替40位除法器，只用一个64项ROM与四次乘法*/
+like_float recip_lut_hw(like_float d)
+{
+	static const ap_fixed<20,2> recip_seed[64] = {
+		0.99224806, 0.97709924, 0.96240602, 0.94814815, 0.93430657, 0.92086331, 0.90780142, 0.89510490,
+		0.88275862, 0.87074830, 0.85906040, 0.84768212, 0.83660131, 0.82580645, 0.81528662, 0.80503145,
+		0.79503106, 0.78527607, 0.77575758, 0.76646707, 0.75739645, 0.74853801, 0.73988439, 0.73142857,
+		0.72316384, 0.71508380, 0.70718232, 0.69945355, 0.69189189, 0.68449198, 0.67724868, 0.67015707,
+		0.66321244, 0.65641026, 0.64974619, 0.64321608, 0.63681592, 0.63054187, 0.62439024, 0.61835749,
+		0.61244019, 0.60663507, 0.60093897, 0.59534884, 0.58986175, 0.58447489, 0.57918552, 0.57399103,
+		0.56888889, 0.56387665, 0.55895197, 0.55411255, 0.54935622, 0.54468085, 0.54008439, 0.53556485,
+		0.53112033, 0.52674897, 0.52244898, 0.51821862, 0.51405622, 0.50996016, 0.50592885, 0.50196078
+	};
+	ap_uint<40> bits = d.range();
+	int p = 0;
+	/*最高位1的位置（d > 0，符号位为0）*/
+	for (int b = 0; b < 39; b++) {
+		#pragma HLS UNROLL
+		if (bits[b]) p = b;
+	}
+	int e = p - 32;
+	like_float m = (e >= 0) ? (like_float)(d >> e) : (like_float)(d << -e);
+	ap_uint<40> mb = m.range();
+	ap_uint<6> idx = mb.range(31, 26);
+	like_float y = recip_seed[idx];
+	for (int it = 0; it < 2; it++) {
+		#pragma HLS UNROLL
+		y = y * ((like_float)2 - m * y);
+	}
+	return (e >= 0) ? (like_float)(y >> e) : (like_float)(y << -e);
+}
+/*定点Hermitian正定矩阵求逆（LDL^H分解），原地计算。
+  利用A = A^H：D为实数，只需N次实数倒数代替复数除法；L、L^-1与结果都只算下三角，上三角按共轭对称补齐*/
+template<int N, int RECIP>
+void Inverse_LDL_fixed(MyComplex* A){
+	MyComplex L[N * N];      // 单位下三角矩阵（只用下三角）
+	MyComplex L_inv[N * N];  // L的逆（只用下三角）
+	like_float D[N];     // 对角阵，实数
+	like_float D_inv[N];
+	MyComplex A_work[N * N];
+	#pragma HLS ARRAY_PARTITION variable=A_work cyclic factor=N dim=1
+	#pragma HLS ARRAY_PARTITION variable=L cyclic factor=N dim=1
+	#pragma HLS ARRAY_PARTITION variable=L_inv cyclic factor=N dim=1
+
+	/*只读入A的下三角，上三角可以未计算（见c_gram_hw的MIRROR=0）*/
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j < N; ++j) {
+			#pragma HLS PIPELINE II=1
+			if (i >= j) {
+				A_work[i * N + j] = A[i * N + j];
+			}
+			else {
+				A_work[i * N + j].real = 0; A_work[i * N + j].imag = 0;
+			}
+			L[i * N + j].real = 0; L[i * N + j].imag = 0;
+			L_inv[i * N + j].real = 0; L_inv[i * N + j].imag = 0;
+		}
+	}
+	/*分解：D(j) = A(j,j)，L(i,j) = A(i,j) / D(j)，再对右下子矩阵做秩1更新*/
+	for (int j = 0; j < N; ++j) {
+		D[j] = A_work[j * N + j].real;
+		if (RECIP == ldl_recip_lut)
+			D_inv[j] = recip_lut_hw(D[j]);
+		else
+			D_inv[j] = hls_internal::generic_divide((ap_fixed<40,8>)1, (ap_fixed<40,8>)D[j]);
+		L[j * N + j].real = 1;
+		for (int i = j + 1; i < N; ++i) {
+			#pragma HLS PIPELINE II=1
+			#pragma HLS LOOP_TRIPCOUNT max=N
+			L[i * N + j].real = A_work[i * N + j].real * D_inv[j];
+			L[i * N + j].imag = A_work[i * N + j].imag * D_inv[j];
+		}
+		for (int i = j + 1; i < N; ++i) {
+			#pragma HLS LOOP_TRIPCOUNT max=N
+			/*L(i,j)*D(j)即更新前的A(i,j)*/
+			MyComplex ld = A_work[i * N + j];
+			for (int jp = j + 1; jp <= i; ++jp) {
+				#pragma HLS PIPELINE II=1
+				#pragma HLS LOOP_TRIPCOUNT max=N
+				MyComplex l_conj;
+				l_conj.real = L[jp * N + j].real;
+				l_conj.imag = -L[jp * N + j].imag;
+				A_work[i * N + jp] = complex_subtract_hw(A_work[i * N + jp], complex_multiply_hw(ld, l_conj));
+			}
+		}
+	}
+	/*L^-1：单位下三角，前代求解，对角为1*/
+	for (int j = 0; j < N; ++j) {
+		L_inv[j * N + j].real = 1;
+		for (int i = j + 1; i < N; ++i) {
+			#pragma HLS LOOP_TRIPCOUNT max=N
+			MyComplex sum;
+			sum.real = 0; sum.imag = 0;
+			for (int k = j; k < i; ++k) {
+				#pragma HLS PIPELINE II=1
+				#pragma HLS LOOP_TRIPCOUNT max=N
+				sum = complex_add_hw(sum, complex_multiply_hw(L[i * N + k], L_inv[k * N + j]));
+			}
+			L_inv[i * N + j].real = -sum.real;
+			L_inv[i * N + j].imag = -sum.imag;
+		}
+	}
+	/*A^-1 = L^-H * D^-1 * L^-1，只算下三角(i>=j)：A^-1(i,j) = sum_{k>=i} conj(L^-1(k,i)) * D^-1(k) * L^-1(k,j)*/
+	for (int i = 0; i < N; ++i) {
+		for (int j = 0; j <= i; ++j) {
+			#pragma HLS LOOP_TRIPCOUNT max=N
+			MyComplex sum;
+			sum.real = 0; sum.imag = 0;
+			for (int k = i; k < N; ++k) {
+				#pragma HLS PIPELINE II=1
+				#pragma HLS LOOP_TRIPCOUNT max=N
+				MyComplex a;
+				a.real = L_inv[k * N + i].real * D_inv[k];
+				a.imag = -L_inv[k * N + i].imag * D_inv[k];
+				sum = complex_add_hw(sum, complex_multiply_hw(a, L_inv[k * N + j]));
+			}
+			A[i * N + j] = sum;
+			A[j * N + i].real = sum.real;
+			A[j * N + i].imag = -sum.imag;
+		}
+	}
+}
 /**********************************************************************************/
 /**********************************************************************************/
 /**********************************************************************************/
@@ -1718,68 +1997,57 @@ void Inverse_LDL_pro(MyComplex_f* A){
 /**********************************************************************************/
 /**********************************************************************************/
 /**********************************************************************************/
+template<int MU>
 void get_dqam_hw(like_float &dqam){
 	#pragma HLS INLINE off
     like_float numerator = 1.5;
-    like_float denominator = hls::pow((ap_fixed<40,8>)2, (ap_fixed<40,8>)mu_1) - (ap_fixed<40,8>)1;
+    like_float denominator = hls::pow((ap_fixed<40,8>)2, (ap_fixed<40,8>)MU) - (ap_fixed<40,8>)1;
 	like_float tttt = numerator/denominator;
 	dqam = hls::sqrt((ap_fixed<40,8>)tttt);
 }
+template<class CFG>
 void constellation_norm_initial(
 	MyComplex* constellation_norm, like_float dqam
 ){
-	my_complex_copy_hw_1<MyComplex, MyComplex>(_16QAM_Constellation_hw, 1, constellation_norm, 1);
-	my_complex_scal_hw_1<MyComplex>(dqam, constellation_norm, 1);
+	my_complex_copy_hw_1<MyComplex, MyComplex, CFG::M>(qam_traits<CFG::Mu>::table(), 1, constellation_norm, 1);
+	my_complex_scal_hw_1<MyComplex, CFG::M>(dqam, constellation_norm, 1);
 }
+template<class CFG>
 void grad_preconditioner_updater_hw(
 	MyComplex_H* H, MyComplex_HH* HH_H, MyComplex_sigma2eye* sigma2eye, 
 	MyComplex_grad_preconditioner* grad_preconditioner, float sigma2_local, like_float dqam
 ){
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
 	int i;
-	MyComplex_f local_f_complex_2[Ntr_2]; 
-	float local_1;
-	float local_2;
-    c_eye_generate_hw<MyComplex_sigma2eye>(sigma2eye, sigma2_local / (float)(dqam * dqam));
-	c_matmultiple_hw_pro<MyComplex_H, MyComplex_H, MyComplex_HH>(H, transA, H, transB, Ntr_1, Ntr_1, Ntr_1, Ntr_1, HH_H);
-    my_complex_add_hw<MyComplex_HH, MyComplex_sigma2eye, MyComplex_grad_preconditioner>(HH_H, sigma2eye, grad_preconditioner);
-	for(i=0; i<Ntr_2; i++){
-		local_f_complex_2[i].real = grad_preconditioner[i].real;
-		local_f_complex_2[i].imag = grad_preconditioner[i].imag;
-	}
-	for(i=0; i<Ntr_2; i++){
-		local_1 = fabsf(local_f_complex_2[i].real);
-        local_2 = fabsf(local_f_complex_2[i].imag);
-		local_f_complex_2[i].real = (local_1 < 0.000001f)?0.0f:local_f_complex_2[i].real;
-		local_f_complex_2[i].imag = (local_2 < 0.000001f)?0.0f:local_f_complex_2[i].imag;
-	}
-    Inverse_LDL_pro(local_f_complex_2);//Inverse_LU(local_f_complex_2);
-	for(i=0; i<Ntr_2; i++){
-		grad_preconditioner[i].real = local_f_complex_2[i].real;
-		grad_preconditioner[i].imag = local_f_complex_2[i].imag;
-	}
-}
+	MyComplex local_complex_2[CFG::Nt * CFG::Nt];
+    c_eye_generate_hw<MyComplex_sigma2eye, CFG::Nt>(sigma2eye, sigma2_local / (float)(dqam * dqam));
+	c_gram_hw<CFG::Nr, CFG::Nt, 0>(H, HH_H);/*HH_H只用于求逆，上三角不需要*/
+	/*在like_float精度下求逆，避免先截断到grad_preconditioner位宽*/
+    my_complex_add_hw<MyComplex_HH, MyComplex_sigma2eye, MyComplex, CFG::Nt * CFG::Nt>(HH_H, sigma2eye, local_complex_2);
+    Inverse_LDL_fixed<CFG::Nt>(local_complex_2);//Inverse_LDL_pro(local_f_complex_2);
+	for(i=0; i<CFG::Nt * CFG::Nt; i++){
+		grad_preconditioner[i].real = local_complex_2[i].real;
+		grad_preconditioner[i].imag = local_complex_2[i].imag;
+	}
+}
+template<int NT>
 void get_alpha(like_float &alpha){
 	like_float exponent = like_float(1) / like_float(3); // 避免浮点字面值隐式转换
-	like_float tttt_pppp = hls::divide<40,8>((ap_fixed<40,8>)Ntr_1, (ap_fixed<40,8>)8);
+	like_float tttt_pppp = hls::divide<40,8>((ap_fixed<40,8>)NT, (ap_fixed<40,8>)8);
 	// like_float exponent_1 = (like_float)Ntr_1 / like_float(8);
     alpha = like_float(1) / hls::pow<40,8>((ap_fixed<40,8>)tttt_pppp, (ap_fixed<40,8>)exponent);
 }
-/*For learning rate line search*/
-template<typename TH, typename T_grad, typename T_pat>
-void learning_rate_line_search_hw(int lr_approx, TH* H, T_grad* grad_preconditioner, int Nr, int Nt, T_pat* pmat)
+/*For learning rate line search：pmat = H * grad_preconditioner * H^H（Nr×Nr）*/
+template<class CFG, typename TH, typename T_grad, typename T_pat>
+void learning_rate_line_search_hw(int lr_approx, TH* H, T_grad* grad_preconditioner, T_pat* pmat)
 {
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
-	MyComplex_temp_NtNr temp_NtNr[Ntr_2];
+	MyComplex_temp_NtNr temp_NtNr[CFG::Nr * CFG::Nt];
     if (!lr_approx)
 	{
-		c_matmultiple_hw_pro(H, transB, grad_preconditioner, transB, Nt, Nt, Nt, Nt, temp_NtNr);
-		c_matmultiple_hw_pro(temp_NtNr, transB, H, transA, Nr, Nt, Nr, Nt, pmat);
+		c_gemm_systolic_hw<CFG::Nr, CFG::Nt, CFG::Nt, 0, 0>(H, grad_preconditioner, temp_NtNr);
+		c_gemm_systolic_hw<CFG::Nr, CFG::Nt, CFG::Nr, 0, 1>(temp_NtNr, H, pmat);
 	}else
 	{
-		 for (int i = 0; i < Ntr_2; i++)
+		 for (int i = 0; i < CFG::Nr * CFG::Nr; i++)
 		{
 			#pragma HLS unroll
 			pmat[i].real = (like_float)0; 
@@ -1787,98 +2055,123 @@ void learning_rate_line_search_hw(int lr_approx, TH* H, T_grad* grad_preconditio
 		}
 	}
 }
+template<class CFG>
 void x_initialize_hw(
 	int mmse_init, MyComplex_sigma2eye* sigma2eye, int Nt, int Nr, float sigma2, MyComplex_HH* HH_H, 
 	MyComplex_H* H, MyComplex_y* y, int num,
 	like_float dqam, MyComplex* x_hat, MyComplex* constellation_norm, unsigned int& seed
 ){
 	int i;
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
-	MyComplex_f local_f_complex_2[Ntr_2]; 
-	MyComplex_temp_NtNt temp_NtNt[Ntr_2];
-	MyComplex_x_mmse x_mmse[Ntr_1];
-	float local_1;
-	float local_2;
-	MyComplex_temp_Nt temp_Nt[Ntr_1];
-	int x_init_1[Ntr_1]={1, 11, 3, 6, 13, 11, 15, 9};
+	MyComplex local_complex_2[CFG::Nt * CFG::Nt];
+	MyComplex_temp_NtNt temp_NtNt[CFG::Nt * CFG::Nt];
+	MyComplex_x_mmse x_mmse[CFG::Nt];
+	MyComplex_temp_Nt temp_Nt[CFG::Nt];
+	int x_init_1[CFG::Nt];
     if (mmse_init_1)
 	{
 		/*x_mmse = la.inv(AHA + noise_var * np.eye(nt)) @ AH @ y*/
-		c_eye_generate_hw<MyComplex_sigma2eye>(sigma2eye, sigma2);
-		my_complex_add_hw<MyComplex_sigma2eye, MyComplex_HH, MyComplex_temp_NtNt>(sigma2eye, HH_H, temp_NtNt);
-		for(i=0; i<Ntr_2; i++){
-			local_f_complex_2[i].real = temp_NtNt[i].real;
-			local_f_complex_2[i].imag = temp_NtNt[i].imag;
-		}
-		for(i=0; i<Ntr_2; i++){
-			local_1 = fabsf(local_f_complex_2[i].real);
-			local_2 = fabsf(local_f_complex_2[i].imag);
-			local_f_complex_2[i].real = (local_1 < 0.000001f)?0.0f:local_f_complex_2[i].real;
-			local_f_complex_2[i].imag = (local_2 < 0.000001f)?0.0f:local_f_complex_2[i].imag;
-		}
-		Inverse_LDL_pro(local_f_complex_2);//Inverse_LU(local_f_complex_2);
-		for(i=0; i<Ntr_2; i++){
-			temp_NtNt[i].real = local_f_complex_2[i].real;
-			temp_NtNt[i].imag = local_f_complex_2[i].imag;
-		}
-		c_matmultiple_hw_pro<MyComplex_H, MyComplex_y, MyComplex_temp_Nt>(H, transA, y, transB, Ntr_1, Ntr_1, Ntr_1, transA, temp_Nt);
-		c_matmultiple_hw_pro<MyComplex_temp_NtNt, MyComplex_temp_Nt, MyComplex_x_mmse>(temp_NtNt, transB, temp_Nt, transB, Ntr_1, Ntr_1, Ntr_1, transA, x_mmse);
+		c_eye_generate_hw<MyComplex_sigma2eye, CFG::Nt>(sigma2eye, sigma2);
+		my_complex_add_hw<MyComplex_sigma2eye, MyComplex_HH, MyComplex, CFG::Nt * CFG::Nt>(sigma2eye, HH_H, local_complex_2);
+		Inverse_LDL_fixed<CFG::Nt>(local_complex_2);//Inverse_LDL_pro(local_f_complex_2);
+		for(i=0; i<CFG::Nt * CFG::Nt; i++){
+			temp_NtNt[i].real = local_complex_2[i].real;
+			temp_NtNt[i].imag = local_complex_2[i].imag;
+		}
+		c_gemv_hw<CFG::Nr, CFG::Nt, 1>(H, y, temp_Nt);
+		c_gemv_hw<CFG::Nt, CFG::Nt, 0>(temp_NtNt, temp_Nt, x_mmse);
 		/*映射到归一化星座图中 xhat = constellation_norm[np.argmin(abs(x_mmse * np.ones(nt, 2 * *mu) - constellation_norm), axis = 1)].reshape(-1, 1)*/
-		map_hw<MyComplex_x_mmse, MyComplex, x_mmse_real_t, Myreal>(dqam, x_mmse, x_hat);
+		map_hw<MyComplex_x_mmse, MyComplex, x_mmse_real_t, Myreal, CFG::Nt, CFG::Mu>(dqam, x_mmse, x_hat);
 	}else
 	{
 	/*xhat = constellation_norm[np.random.randint(low=0, high=2 ** mu, size=(samplers, nt, 1))].copy()*/
-	generateUniformRandoms_int_hw_pro_0(seed, x_init_1);
-	for (int i = 0; i < Ntr_1; i++)
+	generateUniformRandoms_int_hw_pro_0<CFG::Nt, CFG::Mu>(seed, x_init_1);
+	for (int i = 0; i < CFG::Nt; i++)
 		x_hat[i] = constellation_norm[x_init_1[i]];
 	}
 }
 /*计算剩余向量r=y-Hx*/
+/*增量残差更新 r_prop = r - H[:,c]*(x_prop[c]-x_hat[c])，c只取x_prop与x_hat不同的列；
+  r需满足r = y - H*x_hat，乘加次数由Nt*Nr降为(变化列数)*Nr*/
+template<class CFG>
+void r_update_hw(MyComplex_H* H, MyComplex_x_prop* x_prop, MyComplex* x_hat, MyComplex_r* r, MyComplex_r* r_prop)
+{
+	#pragma HLS INLINE off
+	int col[CFG::Nt];
+	MyComplex delta[CFG::Nt];
+	MyComplex acc[CFG::Nr];
+	int n_changed = 0;
+	/*先压缩出发生变化的列*/
+	for (int j = 0; j < CFG::Nt; j++) {
+		#pragma HLS PIPELINE II=1
+		MyComplex d;
+		d.real = x_prop[j].real - x_hat[j].real;
+		d.imag = x_prop[j].imag - x_hat[j].imag;
+		if (d.real != 0 || d.imag != 0) {
+			col[n_changed] = j;
+			delta[n_changed] = d;
+			n_changed++;
+		}
+	}
+	for (int i = 0; i < CFG::Nr; i++) {
+		#pragma HLS PIPELINE II=1
+		acc[i].real = r[i].real;
+		acc[i].imag = r[i].imag;
+	}
+	/*只遍历变化的列，累加在like_float精度下进行，最后一次性截断到r的位宽*/
+	for (int c = 0; c < n_changed; c++) {
+		#pragma HLS LOOP_TRIPCOUNT min=0 max=CFG::Nt avg=2
+		for (int i = 0; i < CFG::Nr; i++) {
+			#pragma HLS PIPELINE II=1
+			MyComplex temp = complex_multiply_hw(H[i * CFG::Nt + col[c]], delta[c]);
+			acc[i].real = acc[i].real - temp.real;
+			acc[i].imag = acc[i].imag - temp.imag;
+		}
+	}
+	for (int i = 0; i < CFG::Nr; i++) {
+		#pragma HLS PIPELINE II=1
+		r_prop[i].real = acc[i].real;
+		r_prop[i].imag = acc[i].imag;
+	}
+}
+template<class CFG>
 void r_hw(MyComplex_H* H, MyComplex* x_hat, MyComplex_r* r, MyComplex_y* y)
 {
-	MyComplex_r r_local[Ntr_1];
-	for(int i=0; i<Ntr_1; i++){
+	MyComplex_r r_local[CFG::Nr];
+	for(int i=0; i<CFG::Nr; i++){
 		r_local[i].real = r[i].real;
 		r_local[i].imag = r[i].imag;
 	}
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
-    c_matmultiple_hw_pro<MyComplex_H, MyComplex, MyComplex_r>(H, transB, x_hat, transB, Ntr_1, Ntr_1, Ntr_1, transA, r_local);
-	my_complex_sub_hw<MyComplex_y, MyComplex_r, MyComplex_r>(y, r_local, r_local);
-	for(int i=0; i<Ntr_1; i++){
+    c_gemv_hw<CFG::Nr, CFG::Nt, 0>(H, x_hat, r_local);
+	my_complex_sub_hw<MyComplex_y, MyComplex_r, MyComplex_r, CFG::Nr>(y, r_local, r_local);
+	for(int i=0; i<CFG::Nr; i++){
 		r[i].real = r_local[i].real;
 		r[i].imag = r_local[i].imag;
 	}
 }
+template<class CFG>
 void r_cal_hw(MyComplex_r* r, MyComplex* x_hat, MyComplex* x_survivor, r_norm_t &r_norm, r_norm_t &r_norm_survivor)
 {
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
-	MyComplex_temp_1 temp_1[1];
-    c_matmultiple_hw_pro<MyComplex_r, MyComplex_r, MyComplex_temp_1>(r, transA, r, transB, Ntr_1, transA, Ntr_1, transA, temp_1);
-	r_norm = temp_1[0].real;
-	my_complex_copy_hw<MyComplex, MyComplex>(x_hat, 1, x_survivor, 1);
+	r_norm = c_norm2_hw<CFG::Nr>(r);
+	my_complex_copy_hw<MyComplex, MyComplex, CFG::Nt>(x_hat, 1, x_survivor, 1);
 	r_norm_survivor = r_norm;
 }
+template<class CFG>
 void lr_hw(int lr_approx, MyComplex_pmat* pmat, MyComplex_r* r, MyComplex_pr_prev* pr_prev, lr_t &lr, int num)
 {
 	MyComplex__temp_1 _temp_1[1];
 	MyComplex_temp_1 temp_1[1];
 	local_temp_1_t local_temp_1;
 	local_temp_2_t local_temp_2;
-    MyComplex_pr_prev pr_prev_local[Ntr_1];
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
+    MyComplex_pr_prev pr_prev_local[CFG::Nr];
 	if (!lr_approx)
 	{
-		c_matmultiple_hw_pro<MyComplex_pmat, MyComplex_r, MyComplex_pr_prev>(pmat, transB, r, transB, Ntr_1, Ntr_1, Ntr_1, transA, pr_prev_local);
-        for(int i=0; i<Ntr_1; i++){
+		c_gemv_hw<CFG::Nr, CFG::Nr, 0>(pmat, r, pr_prev_local);
+        for(int i=0; i<CFG::Nr; i++){
             pr_prev[i].real = pr_prev_local[i].real;
             pr_prev[i].imag = pr_prev_local[i].imag;
         }        
-		c_matmultiple_hw_pro<MyComplex_r, MyComplex_pr_prev, MyComplex_temp_1>(r, transA, pr_prev, transB, Ntr_1, transA, Ntr_1, transA, temp_1);
-		c_matmultiple_hw_pro<MyComplex_pr_prev, MyComplex_pr_prev, MyComplex__temp_1>(pr_prev, transA, pr_prev, transB, Ntr_1, transA, Ntr_1, transA, _temp_1);
+		temp_1[0].real = c_dot_hw<CFG::Nr>(r, pr_prev).real;
+		_temp_1[0].real = c_norm2_hw<CFG::Nr>(pr_prev);
 		local_temp_1 = temp_1[0].real;
 		local_temp_2 = _temp_1[0].real;
 		lr = hls_internal::generic_divide((local_temp_1_t)local_temp_1, (local_temp_2_t)local_temp_2);
@@ -1887,10 +2180,11 @@ void lr_hw(int lr_approx, MyComplex_pmat* pmat, MyComplex_r* r, MyComplex_pr_pre
 		lr = num * 0.5;
 	}
 }
+template<class CFG>
 void step_size_hw(step_size_t &step_size, like_float alpha, like_float dqam, r_norm_t r_norm){
 	local_temp_1_t local_temp_3;
 	local_temp_2_t local_temp_4;
-	local_temp_3 = hls_internal::generic_divide((r_norm_t)r_norm, (r_norm_t)Ntr_1);
+	local_temp_3 = hls_internal::generic_divide((r_norm_t)r_norm, (r_norm_t)CFG::Nr);
 	local_temp_4 = hls::sqrt((local_temp_1_t)local_temp_3);
     step_size = hls::fmax((ap_fixed<40,8>)dqam, (ap_fixed<40,8>)local_temp_4) * alpha;
 }
@@ -1930,23 +2224,96 @@ void data_copy(
 		constellation_norm_2[l].imag = constellation_norm[l].imag;
 	}
 }
+/*
+ * survivor列表插入：列表按r_norm升序，n为已有条目数，r_norm已经算出，不增加矩阵运算。
+ * 提案已在列表中时只在r_norm更小时更新该条目（增量更新的残差可使同一x的r_norm略有差异）；
+ * 否则列表未满直接插入，已满时只在优于末位时替换末位。Survivors=1时即原来的单survivor更新规则。
+ */
+template<class CFG>
+void survivor_insert_hw(
+	MyComplex_x_prop* x_prop, r_norm_t r_norm_prop,
+	MyComplex x_list[CFG::Survivors][CFG::Nt], r_norm_t r_list[CFG::Survivors], int &n
+){
+	#pragma HLS INLINE
+	const int K = CFG::Survivors;
+	int p = (n < K) ? n : K - 1;/*本次移除的位置：重复条目、末位或第一个空位*/
+	bool hit = false;
+	SURVIVOR_DUP:
+	for (int j = 0; j < K; j++) {
+		#pragma HLS UNROLL
+		bool same = j < n;
+		for (int i = 0; i < CFG::Nt; i++) {
+			#pragma HLS UNROLL
+			same = same && x_list[j][i].real == x_prop[i].real && x_list[j][i].imag == x_prop[i].imag;
+		}
+		if (same) {
+			p = j;
+			hit = true;
+		}
+	}
+	if (!((!hit && n < K) || r_norm_prop < r_list[p]))
+		return;
+	/*移除p后，提案插在所有r_norm不大于它的条目之后（位置q）*/
+	int q = 0;
+	for (int j = 0; j < K; j++) {
+		#pragma HLS UNROLL
+		q += (j < n && j != p && r_list[j] <= r_norm_prop);
+	}
+	MyComplex x_old[K][CFG::Nt];
+	r_norm_t r_old[K];
+	for (int j = 0; j < K; j++) {
+		#pragma HLS UNROLL
+		r_old[j] = r_list[j];
+		for (int i = 0; i < CFG::Nt; i++) {
+			#pragma HLS UNROLL
+			x_old[j][i] = x_list[j][i];
+		}
+	}
+	SURVIVOR_SHIFT:
+	for (int j = 0; j < K; j++) {
+		#pragma HLS UNROLL
+		int src = (j < q) ? ((j < p) ? j : j + 1) : ((j - 1 < p) ? j - 1 : j);
+		for (int i = 0; i < CFG::Nt; i++) {
+			#pragma HLS UNROLL
+			if (j == q) {
+				x_list[j][i].real = x_prop[i].real;
+				x_list[j][i].imag = x_prop[i].imag;
+			} else if (src < K) {
+				x_list[j][i] = x_old[src][i];
+			}
+		}
+		if (j == q)
+			r_list[j] = r_norm_prop;
+		else if (src < K)
+			r_list[j] = r_old[src];
+	}
+	if (!hit && n < K)
+		n++;
+}
+template<class CFG>
 void samplers_process(
 	/*静态量*/
-	MyComplex_H H_local[Ntr_2], MyComplex_y y_local[Ntr_1], MyComplex_v v_tb_local[Ntr_1 * iter_1], MyComplex_grad_preconditioner grad_preconditioner[Ntr_2],
-	MyComplex_pmat pmat[Ntr_2], MyComplex constellation_norm[mu_double], like_float dqam, like_float alpha, float sigma2_local, int lr_approx, int num,
+	MyComplex_H H_local[CFG::Nr * CFG::Nt], MyComplex_y y_local[CFG::Nr],
+#ifdef GAUSS_TABLE_MODE
+	MyComplex_v v_tb_local[CFG::num_ran],
+#endif
+	MyComplex_grad_preconditioner grad_preconditioner[CFG::Nt * CFG::Nt],
+	MyComplex_pmat pmat[CFG::Nr * CFG::Nr], MyComplex constellation_norm[CFG::M], like_float dqam, like_float alpha, float sigma2_local, int lr_approx, int num,
 	/*动态*/
 	MyComplex* x_hat, MyComplex_r* r, r_norm_t &r_norm, MyComplex_pr_prev* pr_prev, lr_t &lr,
-	step_size_t &step_size, int &offset, MyComplex* x_survivor, r_norm_t &r_norm_survivor, unsigned int& seed
+	step_size_t &step_size, int &offset,
+	MyComplex x_survivor[CFG::Survivors][CFG::Nt], r_norm_t r_norm_survivor[CFG::Survivors], int &n_survivor,
+	unsigned int& seed, unsigned int& gauss_seed
 ){
 	#pragma HLS INLINE off
 	/*局部变量*/
-	MyComplex_v v[Ntr_1];
-	MyComplex_z_grad z_grad[Ntr_1];
-	MyComplex_z_prop z_prop[Ntr_1];
-	MyComplex_x_prop x_prop[Ntr_1];
-	MyComplex_r r_prop[Ntr_1];
-	MyComplex_temp_Nt temp_Nt[Ntr_1];
-	MyComplex_temp_Nr temp_Nr[Ntr_1];
+	MyComplex_v v[CFG::Nt];
+	MyComplex_z_grad z_grad[CFG::Nt];
+	MyComplex_z_prop z_prop[CFG::Nt];
+	MyComplex_x_prop x_prop[CFG::Nt];
+	MyComplex_r r_prop[CFG::Nr];
+	MyComplex_temp_Nt temp_Nt[CFG::Nt];
+	MyComplex_temp_Nr temp_Nr[CFG::Nr];
 	MyComplex_temp_1 temp_1[1];
 	MyComplex__temp_1 _temp_1[1];
 	like_float log_pacc;
@@ -1956,42 +2323,54 @@ void samplers_process(
 	r_norm_t r_norm_prop;
 	local_temp_1_t local_temp_1;
 	local_temp_2_t local_temp_2;
-	int transA = 1;  // CblasConjTrans 的等效值，表示共轭转置
-	int transB = 0;  // CblasNoTrans 的等效值，表示不转置
 	
-	for (int k = 0; k < iter_1; k++){
+	for (int k = 0; k < CFG::Iters; k++){
 		/*更新梯度 z_grad = xhat + lr * (grad_preconditioner @ (AH @ r))*/
     	//z_grad_hw(H_local, transA, transB, temp_Nt, grad_preconditioner, z_grad, lr, x_hat_1, r);
-		c_matmultiple_hw_pro<MyComplex_H, MyComplex_r, MyComplex_temp_Nt>(H_local, transA, r , transB, Ntr_1, Ntr_1, Ntr_1, transA, temp_Nt);
+		c_gemv_hw<CFG::Nr, CFG::Nt, 1>(H_local, r, temp_Nt);
 		// c_matmultiple_hw_pro_wrapper(H_local.real, H_local.imag, r.real, r.imag, transA, transB, Ntr_1, Ntr_1, Ntr_1, transA, temp_Nt.real, temp_Nt.imag);
-		c_matmultiple_hw_pro<MyComplex_grad_preconditioner, MyComplex_temp_Nt, MyComplex_z_grad>(grad_preconditioner, transB, temp_Nt, transB, Ntr_1, Ntr_1, Ntr_1, transA, z_grad);
-		my_complex_scal_hw<MyComplex_z_grad>(lr, z_grad, 1); 
-		my_complex_add_hw_1<MyComplex, MyComplex_z_grad, MyComplex_z_grad>(x_hat, z_grad, z_grad);
+		c_gemv_hw<CFG::Nt, CFG::Nt, 0>(grad_preconditioner, temp_Nt, z_grad);
+		my_complex_scal_hw<MyComplex_z_grad, CFG::Nt>(lr, z_grad, 1); 
+		my_complex_add_hw_1<MyComplex, MyComplex_z_grad, MyComplex_z_grad, CFG::Nt>(x_hat, z_grad, z_grad);
     	/*加入高斯随机扰动*/
     	///gauss_add_hw(v, v_tb_local, offset, step_size, z_grad, z_prop);
-		for(int i = 0; i < Ntr_1; i++){
+#ifdef GAUSS_TABLE_MODE
+		for(int i = 0; i < CFG::Nt; i++){
 			v[i].real = v_tb_local[i+offset].real;
 			v[i].imag = v_tb_local[i+offset].imag;
 		}
-		offset = (offset>(num_ran-Ntr_1))?0:(offset + Ntr_1);
+		offset = (offset>(CFG::num_ran-CFG::Nt))?0:(offset + CFG::Nt);
+#else
+		for(int i = 0; i < CFG::Nt; i++){
+			#pragma HLS PIPELINE II=1
+			gauss_rand_hw(gauss_seed, v[i]);
+		}
+#endif
 		// c_matmultiple_hw_pro<MyComplex, MyComplex_v, MyComplex_v>(covar, transB, v , transB, Ntr_1, Ntr_1, Ntr_1, transA, v);
-		my_complex_scal_hw<MyComplex_v>(step_size, v, 1);
-		my_complex_add_hw_1<MyComplex_z_grad, MyComplex_v, MyComplex_z_prop>(z_grad, v, z_prop);
+		my_complex_scal_hw<MyComplex_v, CFG::Nt>(step_size, v, 1);
+		my_complex_add_hw_1<MyComplex_z_grad, MyComplex_v, MyComplex_z_prop, CFG::Nt>(z_grad, v, z_prop);
     	/*将梯度映射到QAM星座点中 x_prop = constellation_norm[np.argmin(abs(z_prop * ones - constellation_norm), axis=2)].reshape(-1, nt, 1) */
-    	map_hw<MyComplex_z_prop, MyComplex_x_prop, z_prop_real_t, x_prop_real_t>(dqam, z_prop, x_prop);
+    	map_hw<MyComplex_z_prop, MyComplex_x_prop, z_prop_real_t, x_prop_real_t, CFG::Nt, CFG::Mu>(dqam, z_prop, x_prop);
     	/*计算新的残差范数 calculate residual norm of the proposal*/
     	//r_newnorm_hw(H_local, transB, x_prop, transA, temp_Nr, y_local, r_prop, temp_1, r_norm_prop);
-		c_matmultiple_hw_pro<MyComplex_H, MyComplex_x_prop, MyComplex_temp_Nr>(H_local, transB, x_prop, transB, Ntr_1, Ntr_1, Ntr_1, transA, temp_Nr);
-		my_complex_sub_hw<MyComplex_y, MyComplex_temp_Nr, MyComplex_r>(y_local, temp_Nr, r_prop);
-		c_matmultiple_hw_pro<MyComplex_r, MyComplex_r, MyComplex_temp_1>(r_prop, transA, r_prop, transB, Ntr_1, transA, Ntr_1, transA, temp_1);
-		r_norm_prop = temp_1[0].real;
-    	/*update the survivor*/
-    	//survivor_hw(r_norm_survivor, r_norm_prop, x_prop, x_survivor);
-		if (r_norm_survivor > r_norm_prop)
+		/*每RESID_REFRESH次迭代整体重算一次r_prop = y - H*x_prop，其余迭代只按变化的符号增量更新；
+		  当前状态的r = y - H*x_hat（及r_norm）同时重算，否则提案被拒绝时r中的增量误差不会被清除*/
+		if ((k + 1) % RESID_REFRESH == 0)
+		{
+			c_gemv_hw<CFG::Nr, CFG::Nt, 0>(H_local, x_hat, temp_Nr);
+			my_complex_sub_hw<MyComplex_y, MyComplex_temp_Nr, MyComplex_r, CFG::Nr>(y_local, temp_Nr, r);
+			r_norm = c_norm2_hw<CFG::Nr>(r);
+			c_gemv_hw<CFG::Nr, CFG::Nt, 0>(H_local, x_prop, temp_Nr);
+			my_complex_sub_hw<MyComplex_y, MyComplex_temp_Nr, MyComplex_r, CFG::Nr>(y_local, temp_Nr, r_prop);
+		}
+		else
 		{
-			my_complex_copy_hw<MyComplex_x_prop, MyComplex>(x_prop, 1, x_survivor, 1);
-			r_norm_survivor = r_norm_prop;
+			r_update_hw<CFG>(H_local, x_prop, x_hat, r, r_prop);
 		}
+		r_norm_prop = c_norm2_hw<CFG::Nr>(r_prop);
+    	/*update the survivor list*/
+    	//survivor_hw(r_norm_survivor, r_norm_prop, x_prop, x_survivor);
+		survivor_insert_hw<CFG>(x_prop, r_norm_prop, x_survivor, r_norm_survivor, n_survivor);
     	/*acceptance test＆update GD learning rate＆update random walk size*/
     	//acceptance_hw(transB, transA, r_norm_prop, r_norm, log_pacc, p_acc, p_uni, x_prop , x_hat_1, r_prop, r, pmat, pr_prev, &temp_1, &_temp_1, lr, step_size, dqam, alpha);
     	local_temp_1 = (r_norm - r_norm_prop);// * (local_temp_1_t)5;
@@ -2009,96 +2388,89 @@ void samplers_process(
 		generateUniformRandoms_float_hw_pro(seed, p_uni);
 		if (p_acc > p_uni[5])/*概率满足条件时候*/
 		{
-			my_complex_copy_hw<MyComplex_x_prop, MyComplex>(x_prop, 1, x_hat, 1);
-			my_complex_copy_hw<MyComplex_r, MyComplex_r>(r_prop, 1, r, 1);
+			my_complex_copy_hw<MyComplex_x_prop, MyComplex, CFG::Nt>(x_prop, 1, x_hat, 1);
+			my_complex_copy_hw<MyComplex_r, MyComplex_r, CFG::Nr>(r_prop, 1, r, 1);
 			r_norm = r_norm_prop;
 			/*update GD learning rate*/
 			if (!lr_approx)
 			{
-				c_matmultiple_hw_pro<MyComplex_pmat, MyComplex_r, MyComplex_pr_prev>(pmat, transB, r, transB, Ntr_1, Ntr_1, Ntr_1, transA, pr_prev);
-				c_matmultiple_hw_pro<MyComplex_r, MyComplex_pr_prev, MyComplex_temp_1>(r, transA, pr_prev, transB, Ntr_1, transA, Ntr_1, transA, temp_1);
-				c_matmultiple_hw_pro<MyComplex_pr_prev, MyComplex_pr_prev, MyComplex__temp_1>(pr_prev, transA, pr_prev, transB, Ntr_1, transA, Ntr_1, transA, _temp_1);
+				c_gemv_hw<CFG::Nr, CFG::Nr, 0>(pmat, r, pr_prev);
+				temp_1[0].real = c_dot_hw<CFG::Nr>(r, pr_prev).real;
+				_temp_1[0].real = c_norm2_hw<CFG::Nr>(pr_prev);
 				lr = temp_1[0].real / _temp_1[0].real;
 			}
 			/*update random walk size*/
-			local_temp_1 = hls_internal::generic_divide((ap_fixed<40,8>)r_norm, (ap_fixed<40,8>)Ntr_1);
+			local_temp_1 = hls_internal::generic_divide((ap_fixed<40,8>)r_norm, (ap_fixed<40,8>)CFG::Nr);
 			local_temp_2 = hls::fmax((ap_fixed<40,8>)dqam, hls::sqrt((ap_fixed<40,8>)local_temp_1));
 			step_size = local_temp_2 * alpha;
 		}
 	}
 }
+/*比较不同采样器结果：在全部候选（采样器k的第j个survivor位于k*Survivors + j）中选r_norm最小者（相等时取编号小的），
+  各采样器列表升序，因此结果与只比较各采样器的最优survivor相同*/
+template<class CFG>
 void comparison_r(
 	/*静态量*/
-	r_norm_t r_norm_survivor_1, r_norm_t r_norm_survivor_2, 
-	r_norm_t r_norm_survivor_3, r_norm_t r_norm_survivor_4,
-	// r_norm_t r_norm_survivor_5, r_norm_t r_norm_survivor_6,
-	// r_norm_t r_norm_survivor_7, r_norm_t r_norm_survivor_8,
-	MyComplex x_survivor[Ntr_1], MyComplex x_survivor_2[Ntr_1], 
-	MyComplex x_survivor_3[Ntr_1], MyComplex x_survivor_4[Ntr_1],
-	// MyComplex x_survivor_5[Ntr_1], MyComplex x_survivor_6[Ntr_1],
-	// MyComplex x_survivor_7[Ntr_1], MyComplex x_survivor_8[Ntr_1],
+	r_norm_t r_norm_survivor_all[CFG::Cands],
+	MyComplex x_survivor_all[CFG::Cands][CFG::Nt],
 	/*结果量*/
 	MyComplex* x_survivor_final
 ){
-	int choice;
-	int i;
-	r_norm_t r_norm_survivor_all[samplers];
-	r_norm_t r_norm_survivor_final;
+	int choice = 0;
+	r_norm_t r_norm_survivor_final = r_norm_survivor_all[0];
 	/*比较不同采样器结果（即比较r_norm_survivor大小）*/
-	r_norm_survivor_final = r_norm_survivor_1;
-	r_norm_survivor_all[0] = r_norm_survivor_1;
-	r_norm_survivor_all[1] = r_norm_survivor_2;
-	r_norm_survivor_all[2] = r_norm_survivor_3;
-	r_norm_survivor_all[3] = r_norm_survivor_4;
-
-	// r_norm_survivor_all[4] = r_norm_survivor_5;
-	// r_norm_survivor_all[5] = r_norm_survivor_6;
-	// r_norm_survivor_all[6] = r_norm_survivor_7;
-	// r_norm_survivor_all[7] = r_norm_survivor_8;
-	for(i=0; i<samplers; ++i){
+	R_NORM_MIN:
+	for(int i=1; i<CFG::Cands; ++i){
+		#pragma HLS UNROLL
 		if(r_norm_survivor_all[i] < r_norm_survivor_final){
-			choice = i+1;
+			r_norm_survivor_final = r_norm_survivor_all[i];
+			choice = i;
 		}
 	}
 	/*选择x_survivor*/
-	switch(choice){
-		case 1:
-			for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor[i];
-			break;
-		case 2:
-			for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_2[i];
-			break;
-		case 3:
-			for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_3[i];
-			break;
-		case 4:
-			for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_4[i];
-			break;
-		// case 5:
-			// for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_5[i];
-			// break;
-		// case 6:
-			// for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_6[i];
-			// break;
-		// case 7:
-			// for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_7[i];
-			// break;
-		// case 8:
-			// for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor_8[i];
-			// break;
-		default:
-			for(i=0; i<Ntr_1; ++i)x_survivor_final[i] = x_survivor[i];
-			break;
+	for(int i=0; i<CFG::Nt; ++i){
+		#pragma HLS UNROLL
+		x_survivor_final[i] = x_survivor_all[choice][i];
 	}
 }
-template<typename TX, typename TY_real, typename TY_imag>
+template<typename TX, typename TY_real, typename TY_imag, int LEN>
 void out_hw(const TX* X, const int incX, TY_real* Y_real, TY_imag* Y_imag, int incY)
 {
-	for (int i = 0, j = 0; i < Ntr_1; i++, j++) {
+	for (int i = 0, j = 0; i < LEN; i++, j++) {
 		Y_real[j * incY] = X[i * incX].real;  // 复制实部
 		Y_imag[j * incY] = X[i * incX].imag;  // 复制虚部
 	}
 }
+#ifdef PACKED_AXI
+/*x_hat打包写回：LEN个元素按mhgd_axi_pack.h的格式组成字，每拍写出一个字*/
+template<int LEN>
+void out_packed_hw(const MyComplex* X, axi_word_t* Y)
+{
+	typedef axi_pack<Myreal, Myimage, LEN> X_pack;
+	OUT_WORD:
+	for (int w = 0; w < X_pack::words; w++) {
+		#pragma HLS PIPELINE II=1
+		axi_word_t word = 0;
+		for (int s = 0; s < X_pack::per_word; s++) {
+			#pragma HLS UNROLL
+			if (w * X_pack::per_word + s < LEN)
+				axi_put(word, s, X[w * X_pack::per_word + s].real, X[w * X_pack::per_word + s].imag);
+		}
+		Y[w] = word;
+	}
+}
+#endif
+#ifdef SOFT_OUTPUT
+/*LLR写回：连续的int8，II=1突发写出*/
+template<int LEN>
+void out_llr_hw(const llr_t* llr_in, llr_t* llr_out)
+{
+	for (int i = 0; i < LEN; i++) {
+		#pragma HLS PIPELINE II=1
+		llr_out[i] = llr_in[i];
+	}
+}
+#endif
 /**********************************************************************************/
 /**********************************************************************************/
 /**********************************************************************************/
@@ -2108,586 +2480,695 @@ void out_hw(const TX* X, const int incX, TY_real* Y_real, TY_imag* Y_imag, int i
 /**********************************************************************************/
 /**********************************************************************************/
 /**********************************************************************************/
-/*数据分发函数*/
+#ifdef PROFILE_STAGES
+/*时间点标记：向本级的事件流写入时间点编号；C仿真中同时记下当前的乘法计数*/
+static void prof_mark(hls::stream<prof_point_t>& prof_ev, int point)
+{
+	#pragma HLS INLINE
+	prof_ev.write(point);
+#ifndef __SYNTHESIS__
+	mhgd_prof_csim[point] = mhgd_prof_muls;
+#endif
+}
+/*
+ * 分段计时：与各流式函数并行运行，每拍计数器加1并非阻塞地查询各级的事件流，
+ * 收齐全部时间点后把相对PROF_START的计数写入prof（格式见mhgd_prof.h）。
+ * C仿真中dataflow按调用顺序串行执行，本函数最后执行，改为阻塞读取并输出各时间点的乘法计数。
+ */
+template<class CFG>
+void prof_timer(
+	hls::stream<prof_point_t>& prof_dist, hls::stream<prof_point_t>& prof_shared,
+	hls::stream<prof_point_t> prof_sampler[CFG::Samplers], hls::stream<prof_point_t>& prof_cmp,
+	unsigned int* prof
+){
+	#pragma HLS INLINE off
+	const int points = PROF_SAMPLER_BASE + 2 * CFG::Samplers;
+	unsigned int stamp[PROF_SAMPLER_BASE + 2 * CFG::Samplers];
+	#pragma HLS ARRAY_PARTITION variable=stamp complete dim=1
+	prof_point_t ev;
+#ifndef __SYNTHESIS__
+	for (int n = 0; n < points; n++) {
+		if (n < 2)
+			ev = prof_dist.read();
+		else if (n < 4)
+			ev = prof_shared.read();
+		else if (n < 4 + 2 * CFG::Samplers)
+			ev = prof_sampler[(n - 4) / 2].read();
+		else
+			ev = prof_cmp.read();
+		stamp[ev] = mhgd_prof_csim[ev] - mhgd_prof_csim[PROF_START];
+	}
+	const unsigned int unit = MHGD_PROF_MULS;
+#else
+	ap_uint<32> cnt = 0;
+	int got = 0;
+	PROF_COUNT:
+	while (got < points) {
+		#pragma HLS PIPELINE II=1
+		#pragma HLS LOOP_TRIPCOUNT max=100000
+		if (prof_dist.read_nb(ev)) { stamp[ev] = cnt; got++; }
+		if (prof_shared.read_nb(ev)) { stamp[ev] = cnt; got++; }
+		for (int k = 0; k < CFG::Samplers; k++) {
+			#pragma HLS UNROLL
+			if (prof_sampler[k].read_nb(ev)) { stamp[ev] = cnt; got++; }
+		}
+		if (prof_cmp.read_nb(ev)) { stamp[ev] = cnt; got++; }
+		cnt++;
+	}
+	for (int p = 1; p < points; p++) {
+		#pragma HLS UNROLL
+		stamp[p] -= stamp[PROF_START];
+	}
+	stamp[PROF_START] = 0;
+	const unsigned int unit = MHGD_PROF_CYCLES;
+#endif
+	prof[0] = MHGD_PROF_MAGIC;
+	prof[1] = (unit << 16) | CFG::Samplers;
+	PROF_OUT:
+	for (int p = 0; p < points; p++) {
+		#pragma HLS PIPELINE II=1
+		prof[2 + p] = stamp[p];
+	}
+}
+#endif
+/*数据分发函数：H额外送一份给共享预计算，v_tb第k个采样器的表位于v_tb_real + k*CFG::num_ran*/
+template<class CFG>
 void data_distribution(
+#ifdef PACKED_AXI
+    axi_word_t* H, axi_word_t* y,
+#else
     H_real_t* H_real, H_imag_t* H_imag,
     y_real_t* y_real, y_imag_t* y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
     v_real_t* v_tb_real, v_imag_t* v_tb_imag,
-	v_real_t* v_tb_real_2, v_imag_t* v_tb_imag_2,
-	v_real_t* v_tb_real_3, v_imag_t* v_tb_imag_3,
-	v_real_t* v_tb_real_4, v_imag_t* v_tb_imag_4,
-	// v_real_t* v_tb_real_5, v_imag_t* v_tb_imag_5,
-	// v_real_t* v_tb_real_6, v_imag_t* v_tb_imag_6,
-	// v_real_t* v_tb_real_7, v_imag_t* v_tb_imag_7,
-	// v_real_t* v_tb_real_8, v_imag_t* v_tb_imag_8,
-
-    hls::stream<H_real_t>& H_real_out1, hls::stream<H_imag_t>& H_imag_out1,
-    hls::stream<y_real_t>& y_real_out1, hls::stream<y_imag_t>& y_imag_out1,
-    hls::stream<v_real_t>& v_tb_real_out1, hls::stream<v_imag_t>& v_tb_imag_out1,
-    hls::stream<H_real_t>& H_real_out2, hls::stream<H_imag_t>& H_imag_out2,
-    hls::stream<y_real_t>& y_real_out2, hls::stream<y_imag_t>& y_imag_out2,
-    hls::stream<v_real_t>& v_tb_real_out2, hls::stream<v_imag_t>& v_tb_imag_out2,
-	
-	hls::stream<H_real_t>& H_real_out3, hls::stream<H_imag_t>& H_imag_out3,
-    hls::stream<y_real_t>& y_real_out3, hls::stream<y_imag_t>& y_imag_out3,
-    hls::stream<v_real_t>& v_tb_real_out3, hls::stream<v_imag_t>& v_tb_imag_out3,
-    hls::stream<H_real_t>& H_real_out4, hls::stream<H_imag_t>& H_imag_out4,
-    hls::stream<y_real_t>& y_real_out4, hls::stream<y_imag_t>& y_imag_out4,
-    hls::stream<v_real_t>& v_tb_real_out4, hls::stream<v_imag_t>& v_tb_imag_out4
-
-	// hls::stream<H_real_t>& H_real_out5, hls::stream<H_imag_t>& H_imag_out5,
-    // hls::stream<y_real_t>& y_real_out5, hls::stream<y_imag_t>& y_imag_out5,
-    // hls::stream<v_real_t>& v_tb_real_out5, hls::stream<v_imag_t>& v_tb_imag_out5,
-    // hls::stream<H_real_t>& H_real_out6, hls::stream<H_imag_t>& H_imag_out6,
-    // hls::stream<y_real_t>& y_real_out6, hls::stream<y_imag_t>& y_imag_out6,
-    // hls::stream<v_real_t>& v_tb_real_out6, hls::stream<v_imag_t>& v_tb_imag_out6,
-
-	// hls::stream<H_real_t>& H_real_out7, hls::stream<H_imag_t>& H_imag_out7,
-    // hls::stream<y_real_t>& y_real_out7, hls::stream<y_imag_t>& y_imag_out7,
-    // hls::stream<v_real_t>& v_tb_real_out7, hls::stream<v_imag_t>& v_tb_imag_out7,
-    // hls::stream<H_real_t>& H_real_out8, hls::stream<H_imag_t>& H_imag_out8,
-    // hls::stream<y_real_t>& y_real_out8, hls::stream<y_imag_t>& y_imag_out8,
-    // hls::stream<v_real_t>& v_tb_real_out8, hls::stream<v_imag_t>& v_tb_imag_out8
+#endif
+	float sigma2, unsigned int* seeds,
+
+	hls::stream<H_real_t>& H_real_out0, hls::stream<H_imag_t>& H_imag_out0,
+	hls::stream<float>& sigma2_out0,
+    hls::stream<H_real_t> H_real_out[CFG::Samplers], hls::stream<H_imag_t> H_imag_out[CFG::Samplers],
+    hls::stream<y_real_t> y_real_out[CFG::Samplers], hls::stream<y_imag_t> y_imag_out[CFG::Samplers],
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t> v_tb_real_out[CFG::Samplers], hls::stream<v_imag_t> v_tb_imag_out[CFG::Samplers],
+#endif
+	hls::stream<float> sigma2_out[CFG::Samplers], hls::stream<unsigned int> seed_out[CFG::Samplers]
+	PROF_PARAM
 ){
     #pragma HLS INLINE off
-    
+	PROF_MARK(PROF_START);
+
+	// 分发标量参数
+	sigma2_out0.write(sigma2);
+	SCALAR_DISTRIBUTE:
+	for(int k = 0; k < CFG::Samplers; ++k) {
+		#pragma HLS PIPELINE II=1
+		sigma2_out[k].write(sigma2);
+		seed_out[k].write(seeds[k]);
+	}
+
+#ifdef PACKED_AXI
+    // 分发H矩阵数据：每读入一个字，逐拍取出最低位的元素并右移
+	typedef axi_pack<H_real_t, H_imag_t, CFG::Nr * CFG::Nt> H_pack;
+	typedef axi_pack<y_real_t, y_imag_t, CFG::Nr> y_pack;
+	axi_word_t h_word = 0;
+	int h_slot = 0, h_addr = 0;
+    H_DISTRIBUTE:
+    for(int i = 0; i < CFG::Nr * CFG::Nt; ++i) {
+        #pragma HLS PIPELINE II=1
+		if (h_slot == 0)
+			h_word = H[h_addr++];
+		h_slot = (h_slot == H_pack::per_word - 1) ? 0 : h_slot + 1;
+        H_real_t h_real;
+        H_imag_t h_imag;
+		axi_pop(h_word, h_real, h_imag);
+#else
     // 分发H矩阵数据
     H_DISTRIBUTE:
-    for(int i = 0; i < Ntr_2; ++i) {
+    for(int i = 0; i < CFG::Nr * CFG::Nt; ++i) {
         #pragma HLS PIPELINE II=1
         H_real_t h_real = H_real[i];
         H_imag_t h_imag = H_imag[i];
-        H_real_out1.write(h_real);
-        H_imag_out1.write(h_imag);
-        H_real_out2.write(h_real);
-        H_imag_out2.write(h_imag);
-		H_real_out3.write(h_real);
-        H_imag_out3.write(h_imag);
-        H_real_out4.write(h_real);
-        H_imag_out4.write(h_imag);
-		// H_real_out5.write(h_real);
-        // H_imag_out5.write(h_imag);
-        // H_real_out6.write(h_real);
-        // H_imag_out6.write(h_imag);
-		// H_real_out7.write(h_real);
-        // H_imag_out7.write(h_imag);
-        // H_real_out8.write(h_real);
-        // H_imag_out8.write(h_imag);
+#endif
+        H_real_out0.write(h_real);
+        H_imag_out0.write(h_imag);
+		for(int k = 0; k < CFG::Samplers; ++k) {
+			#pragma HLS UNROLL
+			H_real_out[k].write(h_real);
+			H_imag_out[k].write(h_imag);
+		}
     }
     
     // 分发y向量数据
     Y_DISTRIBUTE:
-    for(int i = 0; i < Ntr_1; ++i) {
+#ifdef PACKED_AXI
+	axi_word_t y_word = 0;
+	int y_slot = 0, y_addr = 0;
+    for(int i = 0; i < CFG::Nr; ++i) {
+        #pragma HLS PIPELINE II=1
+		if (y_slot == 0)
+			y_word = y[y_addr++];
+		y_slot = (y_slot == y_pack::per_word - 1) ? 0 : y_slot + 1;
+        y_real_t y_r;
+        y_imag_t y_i;
+		axi_pop(y_word, y_r, y_i);
+#else
+    for(int i = 0; i < CFG::Nr; ++i) {
         #pragma HLS PIPELINE II=1
         y_real_t y_r = y_real[i];
         y_imag_t y_i = y_imag[i];
-        y_real_out1.write(y_r);
-        y_imag_out1.write(y_i);
-        y_real_out2.write(y_r);
-        y_imag_out2.write(y_i);
-		y_real_out3.write(y_r);
-        y_imag_out3.write(y_i);
-        y_real_out4.write(y_r);
-        y_imag_out4.write(y_i);
-		// y_real_out5.write(y_r);
-        // y_imag_out5.write(y_i);
-        // y_real_out6.write(y_r);
-        // y_imag_out6.write(y_i);
-		// y_real_out7.write(y_r);
-        // y_imag_out7.write(y_i);
-        // y_real_out8.write(y_r);
-        // y_imag_out8.write(y_i);
+#endif
+		for(int k = 0; k < CFG::Samplers; ++k) {
+			#pragma HLS UNROLL
+			y_real_out[k].write(y_r);
+			y_imag_out[k].write(y_i);
+		}
     }
+#ifdef GAUSS_TABLE_MODE
     
-    // 分发v_tb数据
+    // 分发v_tb数据（各采样器的表在同一块缓冲区中顺序存放，按采样器逐段突发读取）
     V_DISTRIBUTE:
-    for(int i = 0; i < Ntr_1 * iter_1; ++i) {
-        #pragma HLS PIPELINE II=1
-        v_real_t v_r = v_tb_real[i];
-        v_imag_t v_i = v_tb_imag[i];
-		v_real_t v_r_2 = v_tb_real_2[i];
-        v_imag_t v_i_2 = v_tb_imag_2[i];
-		v_real_t v_r_3 = v_tb_real_3[i];
-        v_imag_t v_i_3 = v_tb_imag_3[i];
-		v_real_t v_r_4 = v_tb_real_4[i];
-        v_imag_t v_i_4 = v_tb_imag_4[i];
-		// v_real_t v_r_5 = v_tb_real_5[i];
-        // v_imag_t v_i_5 = v_tb_imag_5[i];
-		// v_real_t v_r_6 = v_tb_real_6[i];
-        // v_imag_t v_i_6 = v_tb_imag_6[i];
-		// v_real_t v_r_7 = v_tb_real_7[i];
-        // v_imag_t v_i_7 = v_tb_imag_7[i];
-		// v_real_t v_r_8 = v_tb_real_8[i];
-        // v_imag_t v_i_8 = v_tb_imag_8[i];
-        v_tb_real_out1.write(v_r);
-        v_tb_imag_out1.write(v_i);
-        v_tb_real_out2.write(v_r_2);
-        v_tb_imag_out2.write(v_i_2);
-		v_tb_real_out3.write(v_r_3);
-        v_tb_imag_out3.write(v_i_3);
-        v_tb_real_out4.write(v_r_4);
-        v_tb_imag_out4.write(v_i_4);
-		// v_tb_real_out5.write(v_r_5);
-        // v_tb_imag_out5.write(v_i_5);
-        // v_tb_real_out6.write(v_r_6);
-        // v_tb_imag_out6.write(v_i_6);
-		// v_tb_real_out7.write(v_r_7);
-        // v_tb_imag_out7.write(v_i_7);
-        // v_tb_real_out8.write(v_r_8);
-        // v_tb_imag_out8.write(v_i_8);
-    }
+	for(int k = 0; k < CFG::Samplers; ++k) {
+		for(int i = 0; i < CFG::num_ran; ++i) {
+			#pragma HLS PIPELINE II=1
+			v_tb_real_out[k].write(v_tb_real[k * CFG::num_ran + i]);
+			v_tb_imag_out[k].write(v_tb_imag[k * CFG::num_ran + i]);
+		}
+	}
+#endif
+	PROF_MARK(PROF_DIST_END);
+}
+/*从各采样器的输出流读入survivor列表及其r_norm，采样器k的第j个条目存于k*Survivors + j*/
+template<class CFG>
+void survivors_read(
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
+	r_norm_t r_all[CFG::Cands],
+	MyComplex x_all[CFG::Cands][CFG::Nt]
+){
+	#pragma HLS INLINE
+    // 直接从流中读取数据
+	for(int j = 0; j < CFG::Survivors; j++) {
+		#pragma HLS unroll
+		for(int k = 0; k < CFG::Samplers; k++) {
+			#pragma HLS unroll
+			r_all[k * CFG::Survivors + j] = r_norm_in[k].read();
+		}
+	}
+	for(int j = 0; j < CFG::Survivors; j++) {
+		#pragma HLS unroll
+		for(int i = 0; i < CFG::Nt; i++) {
+			#pragma HLS unroll
+			for(int k = 0; k < CFG::Samplers; k++) {
+				#pragma HLS unroll
+				x_all[k * CFG::Survivors + j][i].real = x_real_in[k].read();
+				x_all[k * CFG::Survivors + j][i].imag = x_imag_in[k].read();
+			}
+		}
+	}
 }
 /*流式比较函数*/
+template<class CFG>
 void comparison_r_wrapper(
-    hls::stream<r_norm_t>& r_norm_in1,
-    hls::stream<r_norm_t>& r_norm_in2,
-	hls::stream<r_norm_t>& r_norm_in3,
-    hls::stream<r_norm_t>& r_norm_in4,
-	// hls::stream<r_norm_t>& r_norm_in5,
-    // hls::stream<r_norm_t>& r_norm_in6,
-	// hls::stream<r_norm_t>& r_norm_in7,
-    // hls::stream<r_norm_t>& r_norm_in8,
-    hls::stream<Myreal>& x_real_in1,
-    hls::stream<Myimage>& x_imag_in1,
-    hls::stream<Myreal>& x_real_in2,
-    hls::stream<Myimage>& x_imag_in2,
-	hls::stream<Myreal>& x_real_in3,
-    hls::stream<Myimage>& x_imag_in3,
-    hls::stream<Myreal>& x_real_in4,
-    hls::stream<Myimage>& x_imag_in4,
-	// hls::stream<Myreal>& x_real_in5,
-    // hls::stream<Myimage>& x_imag_in5,
-    // hls::stream<Myreal>& x_real_in6,
-    // hls::stream<Myimage>& x_imag_in6,
-	// hls::stream<Myreal>& x_real_in7,
-    // hls::stream<Myimage>& x_imag_in7,
-    // hls::stream<Myreal>& x_real_in8,
-    // hls::stream<Myimage>& x_imag_in8,
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
     MyComplex* x_final
+    PROF_PARAM
 ){
-    // 直接从流中读取数据
-    r_norm_t r1 = r_norm_in1.read();
-    r_norm_t r2 = r_norm_in2.read();
-	r_norm_t r3 = r_norm_in3.read();
-    r_norm_t r4 = r_norm_in4.read();
-	// r_norm_t r5 = r_norm_in5.read();
-    // r_norm_t r6 = r_norm_in6.read();
-	// r_norm_t r7 = r_norm_in7.read();
-    // r_norm_t r8 = r_norm_in8.read();
-    
-    MyComplex x1[Ntr_1], x2[Ntr_1], x3[Ntr_1], x4[Ntr_1];//, x5[Ntr_1], x6[Ntr_1], x7[Ntr_1], x8[Ntr_1];
-    #pragma HLS ARRAY_PARTITION variable=x1 complete dim=1
-    #pragma HLS ARRAY_PARTITION variable=x2 complete dim=1
-	#pragma HLS ARRAY_PARTITION variable=x3 complete dim=1
-    #pragma HLS ARRAY_PARTITION variable=x4 complete dim=1
-	// #pragma HLS ARRAY_PARTITION variable=x5 complete dim=1
-    // #pragma HLS ARRAY_PARTITION variable=x6 complete dim=1
-	// #pragma HLS ARRAY_PARTITION variable=x7 complete dim=1
-    // #pragma HLS ARRAY_PARTITION variable=x8 complete dim=1
-    
-    for(int i = 0; i < Ntr_1; i++) {
-        #pragma HLS unroll
-        x1[i].real = x_real_in1.read();
-        x1[i].imag = x_imag_in1.read();
-        x2[i].real = x_real_in2.read();
-        x2[i].imag = x_imag_in2.read();
-		x3[i].real = x_real_in3.read();
-        x3[i].imag = x_imag_in3.read();
-        x4[i].real = x_real_in4.read();
-        x4[i].imag = x_imag_in4.read();
-		//x5[i].real = x_real_in5.read();
-        //x5[i].imag = x_imag_in5.read();
-        //x6[i].real = x_real_in6.read();
-        //x6[i].imag = x_imag_in6.read();
-		//x7[i].real = x_real_in7.read();
-        //x7[i].imag = x_imag_in7.read();
-        //x8[i].real = x_real_in8.read();
-        //x8[i].imag = x_imag_in8.read();
-    }
-    
-    comparison_r(r1, r2, r3, r4, //r5, r6, r7, r8,
-		x1, x2, x3, x4, //x5, x6, x7, x8, 
-		x_final);
-}
-// /*shared data calculation*/
-// void shared_data_cal(
-// 	// in ＆ out接口
-//     hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
-//     hls::stream<y_real_t>& y_real_stream, hls::stream<y_imag_t>& y_imag_stream,
-//     hls::stream<v_real_t>& v_tb_real_stream, hls::stream<v_imag_t>& v_tb_imag_stream,
-//     float sigma2,
-// 	// 输出接口
-//     hls::stream<like_float>& dqam_fifo_1, 
-// 	hls::stream<Myreal>& constellation_norm_real_1,
-// 	hls::stream<Myimage>& constellation_norm_imag_1,
-// 	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real_1,
-// 	hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag_1,
-// 	hls::stream<pmat_real_t>& pmat_real_1,
-// 	hls::stream<pmat_imag_t>& pmat_imag_1,
-// 	hls::stream<like_float>& alpha_fifo_1,
-// 
-// 	hls::stream<like_float>& dqam_fifo_2, 
-// 	hls::stream<Myreal>& constellation_norm_real_2,
-// 	hls::stream<Myimage>& constellation_norm_imag_2,
-// 	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real_2,
-// 	hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag_2,
-// 	hls::stream<pmat_real_t>& pmat_real_2,
-// 	hls::stream<pmat_imag_t>& pmat_imag_2,
-// 	hls::stream<like_float>& alpha_fifo_2,
-// 
-// 	hls::stream<like_float>& dqam_fifo_3, 
-// 	hls::stream<Myreal>& constellation_norm_real_3,
-// 	hls::stream<Myimage>& constellation_norm_imag_3,
-// 	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real_3,
-// 	hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag_3,
-// 	hls::stream<pmat_real_t>& pmat_real_3,
-// 	hls::stream<pmat_imag_t>& pmat_imag_3,
-// 	hls::stream<like_float>& alpha_fifo_3,
-// 
-// 	hls::stream<like_float>& dqam_fifo_4, 
-// 	hls::stream<Myreal>& constellation_norm_real_4,
-// 	hls::stream<Myimage>& constellation_norm_imag_4,
-// 	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real_4,
-// 	hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag_4,
-// 	hls::stream<pmat_real_t>& pmat_real_4,
-// 	hls::stream<pmat_imag_t>& pmat_imag_4,
-// 	hls::stream<like_float>& alpha_fifo_4,
-// 
-// 	hls::stream<H_real_t>& H_real_out1, hls::stream<H_imag_t>& H_imag_out1,
-//     hls::stream<y_real_t>& y_real_out1, hls::stream<y_imag_t>& y_imag_out1,
-//     hls::stream<v_real_t>& v_tb_real_out1, hls::stream<v_imag_t>& v_tb_imag_out1,
-//     hls::stream<H_real_t>& H_real_out2, hls::stream<H_imag_t>& H_imag_out2,
-//     hls::stream<y_real_t>& y_real_out2, hls::stream<y_imag_t>& y_imag_out2,
-//     hls::stream<v_real_t>& v_tb_real_out2, hls::stream<v_imag_t>& v_tb_imag_out2,
-// 	
-// 	hls::stream<H_real_t>& H_real_out3, hls::stream<H_imag_t>& H_imag_out3,
-//     hls::stream<y_real_t>& y_real_out3, hls::stream<y_imag_t>& y_imag_out3,
-//     hls::stream<v_real_t>& v_tb_real_out3, hls::stream<v_imag_t>& v_tb_imag_out3,
-//     hls::stream<H_real_t>& H_real_out4, hls::stream<H_imag_t>& H_imag_out4,
-//     hls::stream<y_real_t>& y_real_out4, hls::stream<y_imag_t>& y_imag_out4,
-//     hls::stream<v_real_t>& v_tb_real_out4, hls::stream<v_imag_t>& v_tb_imag_out4
-// ){
-// 	// 本地变量
-// 	H_real_t H_real[Ntr_2];
-// 	H_imag_t H_imag[Ntr_2];
-// 	y_real_t y_real[Ntr_1];
-// 	y_imag_t y_imag[Ntr_1];
-// 	v_real_t v_tb_real[Ntr_1 * iter_1];
-// 	v_imag_t v_tb_imag[Ntr_1 * iter_1];
-// 	MyComplex_y y_local[Ntr_1];
-// 	MyComplex_H H_local[Ntr_2];
-// 	MyComplex_v v_tb_local[Ntr_1 * iter_1];
-// 	like_float alpha;
-// 	like_float dqam;
-// 	MyComplex_grad_preconditioner grad_preconditioner[Ntr_2];
-// 	MyComplex constellation_norm[mu_double];/*depend on 2^mu*/
-// 	MyComplex_pmat pmat[Ntr_2];
-// 	MyComplex_HH HH_H[Ntr_2];
-// 	MyComplex_sigma2eye sigma2eye[Ntr_2];
-// 	float sigma2_local = sigma2;
-// 	/*fifo data read*/
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		H_real[i] = H_real_stream.read();
-// 		H_imag[i] = H_imag_stream.read();
-// 	}
-// 	for(int i=0; i<Ntr_1; ++i){
-// 		y_real[i] = y_real_stream.read();
-// 		y_imag[i] = y_imag_stream.read();
-// 	}
-// 	for(int i=0; i<Ntr_1*iter_1; ++i){
-// 		v_tb_real[i] = v_tb_real_stream.read();
-// 		v_tb_imag[i] = v_tb_imag_stream.read();
-// 	}
-// 	/*********************************核心阶段，数据准备************************************/
-// 	data_local<MyComplex_H, MyComplex_y, MyComplex_v, H_real_t, H_imag_t, y_real_t, y_imag_t, v_real_t, v_imag_t>(H_local, y_local, v_tb_local, H_real, H_imag, y_real, y_imag, v_tb_real, v_tb_imag);
-// 	/*定义发送符号之间最小距离的一半，是星座点经过归一化处理后的结果*/
-// 	get_dqam_hw(dqam);
-//     /*初始化constellation_norm*/
-// 	constellation_norm_initial(constellation_norm, dqam);
-// 	/*二阶梯度下降，计算grad_preconditioner(梯度更新的预条件矩阵)*/
-// 	grad_preconditioner_updater_hw(H_local, HH_H, sigma2eye, grad_preconditioner, sigma2_local, dqam);
-// 	/*alpha*/
-// 	get_alpha(alpha);
-//     /*For learning rate line search */
-//     learning_rate_line_search_hw<MyComplex_H, MyComplex_grad_preconditioner, MyComplex_pmat>(lr_approx_1, H_local, grad_preconditioner, Ntr_1, Ntr_1, pmat);
-// 	
-// 	/*Output phase fifo data write*/
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		H_real_stream.write(H_real[i]);
-// 		H_imag_stream.write(H_imag[i]);
-// 	}
-// 	for(int i=0; i<Ntr_1; ++i){
-// 		y_real_stream.write(y_real[i]);
-// 		y_imag_stream.write(y_imag[i]);
-// 	}
-// 	for(int i=0; i<Ntr_1*iter_1; ++i){
-// 		v_tb_real_stream.write(v_tb_real[i]);
-// 		v_tb_imag_stream.write(v_tb_imag[i]);
-// 	}
-// 	data_distribution(
-// 		H_real_stream, H_imag_stream, y_real_stream, y_imag_stream, 
-// 		v_tb_real_stream, v_tb_imag_stream,
-// 		v_tb_real_2, v_tb_imag_2,
-// 		v_tb_real_3, v_tb_imag_3,
-// 		v_tb_real_4, v_tb_imag_4,
-// 		// v_tb_real_5, v_tb_imag_5,
-// 		// v_tb_real_6, v_tb_imag_6,
-// 		// v_tb_real_7, v_tb_imag_7,
-// 		// v_tb_real_8, v_tb_imag_8,
-// 
-// 		H_real_stream_1, H_imag_stream_1,
-// 		y_real_stream_1, y_imag_stream_1,
-// 		v_tb_real_stream_1, v_tb_imag_stream_1,
-// 		H_real_stream_2, H_imag_stream_2,
-// 		y_real_stream_2, y_imag_stream_2,
-// 		v_tb_real_stream_2, v_tb_imag_stream_2,
-// 
-// 		H_real_stream_3, H_imag_stream_3,
-// 		y_real_stream_3, y_imag_stream_3,
-// 		v_tb_real_stream_3, v_tb_imag_stream_3,
-// 		H_real_stream_4, H_imag_stream_4,
-// 		y_real_stream_4, y_imag_stream_4,
-// 		v_tb_real_stream_4, v_tb_imag_stream_4
-// 
-// 		// H_real_stream_5, H_imag_stream_5,
-// 		// y_real_stream_5, y_imag_stream_5,
-// 		// v_tb_real_stream_5, v_tb_imag_stream_5,
-// 		// H_real_stream_6, H_imag_stream_6,
-// 		// y_real_stream_6, y_imag_stream_6,
-// 		// v_tb_real_stream_6, v_tb_imag_stream_6,
-// 
-// 		// H_real_stream_7, H_imag_stream_7,
-// 		// y_real_stream_7, y_imag_stream_7,
-// 		// v_tb_real_stream_7, v_tb_imag_stream_7,
-// 		// H_real_stream_8, H_imag_stream_8,
-// 		// y_real_stream_8, y_imag_stream_8,
-// 		// v_tb_real_stream_8, v_tb_imag_stream_8
-// 	);
-// 	for(int i=0; i<mu_double; ++i){
-// 		constellation_norm_real.write(constellation_norm[i].real);
-// 		constellation_norm_imag.write(constellation_norm[i].imag);
-// 	}
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		grad_preconditioner_real.write(grad_preconditioner[i].real);
-// 		grad_preconditioner_imag.write(grad_preconditioner[i].imag);
-// 	}
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		pmat_real.write(pmat[i].real);
-// 		pmat_imag.write(pmat[i].imag);
-// 	}
-// 	dqam_fifo.write(dqam);
-// 	alpha_fifo.write(alpha);
-// }
-// /*完全独立的单采样器函数*/
-// void sampler_task_1(
-//     // 输入接口
-//     hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
-//     hls::stream<y_real_t>& y_real_stream, hls::stream<y_imag_t>& y_imag_stream,
-//     hls::stream<v_real_t>& v_tb_real_stream, hls::stream<v_imag_t>& v_tb_imag_stream,
-// 	hls::stream<like_float>& dqam_fifo, 
-// 	hls::stream<Myreal>& constellation_norm_real, hls::stream<Myimage>& constellation_norm_imag,
-// 	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real, hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag,
-// 	hls::stream<pmat_real_t>& pmat_real, hls::stream<pmat_imag_t>& pmat_imag,
-// 	hls::stream<like_float>& alpha_fifo,
-//     float sigma2,
-//     int sampler_id,
-// 	unsigned seed_in,
-//     // 输出接口
-//     hls::stream<Myreal>& x_survivor_real, hls::stream<Myimage>& x_survivor_imag,
-// 	hls::stream<r_norm_t>& r_norm_survivor_out
-// ){
-// 	//本地变量
-// 	H_real_t H_real[Ntr_2];
-// 	H_imag_t H_imag[Ntr_2];
-// 	y_real_t y_real[Ntr_1];
-// 	y_imag_t y_imag[Ntr_1];
-// 	v_real_t v_tb_real[Ntr_1 * iter_1];
-// 	v_imag_t v_tb_imag[Ntr_1 * iter_1];
-// 	MyComplex x_hat[Ntr_1];
-// 	MyComplex_y y_local[Ntr_1];
-// 	MyComplex_H H_local[Ntr_2];
-// 	MyComplex_v v_tb_local[Ntr_1 * iter_1];
-// 	like_float alpha;
-// 	like_float dqam;
-// 	step_size_t step_size;
-// 	r_norm_t r_norm;/*the norm of residual vector*/
-// 	r_norm_t r_norm_survivor;
-// 	lr_t lr;/*learning rate*/
-// 	MyComplex_grad_preconditioner grad_preconditioner[Ntr_2];
-// 	MyComplex constellation_norm[mu_double];/*depend on 2^mu*/
-// 	MyComplex_pmat pmat[Ntr_2];
-// 	MyComplex x_survivor[Ntr_1];
-// 	MyComplex_r r[Ntr_1];
-// 	MyComplex_pr_prev pr_prev[Ntr_1];
-// 	MyComplex_HH HH_H[Ntr_2];
-// 	MyComplex_sigma2eye sigma2eye[Ntr_2];
-// 	int offset = 0;
-// 	float sigma2_local = sigma2;
-// 	int lr_approx = lr_approx_1;
-// 	int mmse_init = mmse_init_1;
-// 	unsigned int seed = seed_in;
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		H_real[i] = H_real_stream.read();
-// 		H_imag[i] = H_imag_stream.read();
-// 	}
-// 	for(int i=0; i<Ntr_1; ++i){
-// 		y_real[i] = y_real_stream.read();
-// 		y_imag[i] = y_imag_stream.read();
-// 	}
-// 	for(int i=0; i<Ntr_1*iter_1; ++i){
-// 		v_tb_real[i] = v_tb_real_stream.read();
-// 		v_tb_imag[i] = v_tb_imag_stream.read();
-// 	}
-// 	for(int i=0; i<mu_double; ++i){
-// 		constellation_norm[i].real = constellation_norm_real.read();
-// 		constellation_norm[i].imag = constellation_norm_imag.read();
-// 	}
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		grad_preconditioner[i].real = grad_preconditioner_real.read();
-// 		grad_preconditioner[i].imag = grad_preconditioner_imag.read();
-// 	}
-// 	for(int i=0; i<Ntr_2; ++i){
-// 		pmat[i].real = pmat_real.read();
-// 		pmat[i].imag = pmat_imag.read();
-// 	}
-// 	dqam = dqam_fifo.read();
-// 	alpha = alpha_fifo.read();
-// 
-// 	/*********************************数据准备************************************/
-// 	data_local<MyComplex_H, MyComplex_y, MyComplex_v, H_real_t, H_imag_t, y_real_t, y_imag_t, v_real_t, v_imag_t>(H_local, y_local, v_tb_local, H_real, H_imag, y_real, y_imag, v_tb_real, v_tb_imag);
-// 	/*定义发送符号之间最小距离的一半，是星座点经过归一化处理后的结果*/
-// 	// get_dqam_hw(dqam);
-//     /*初始化constellation_norm*/
-// 	// constellation_norm_initial(constellation_norm, dqam);
-// 	/*二阶梯度下降，计算grad_preconditioner(梯度更新的预条件矩阵)*/
-// 	// grad_preconditioner_updater_hw(H_local, HH_H, sigma2eye, grad_preconditioner, sigma2_local, dqam);
-// 	/*alpha*/
-// 	// get_alpha(alpha);
-//     /*For learning rate line search */
-//     // learning_rate_line_search_hw<MyComplex_H, MyComplex_grad_preconditioner, MyComplex_pmat>(lr_approx, H_local, grad_preconditioner, Ntr_1, Ntr_1, pmat);
-//     /*x的初始化*/
-//     x_initialize_hw(mmse_init, sigma2eye, Ntr_1, Ntr_1, sigma2_local, HH_H, H_local, y_local, sampler_id, dqam, x_hat, constellation_norm, seed);
-// 	/*计算剩余向量r=y-Hx*/
-//     r_hw(H_local, x_hat, r, y_local);
-//     /*计算剩余向量的范数（就是模值）*/
-// 	r_cal_hw(r, x_hat, x_survivor, r_norm, r_norm_survivor);
-//     /*确定最优学习率*/
-// 	lr_hw(lr_approx, pmat, r, pr_prev, lr, sampler_id);
-//     /*步长初始化*/
-// 	step_size_hw(step_size, alpha, dqam, r_norm);
-// 	/*********************************核心计算************************************/
-// 	samplers_process(
-// 		/*静态量*/
-// 		H_local, y_local, v_tb_local, grad_preconditioner,
-// 		pmat, constellation_norm, dqam, alpha, sigma2_local, lr_approx_1, sampler_id,
-// 		/*动态*/
-// 		x_hat, r, r_norm, pr_prev, lr,
-// 		step_size, offset, x_survivor, r_norm_survivor, seed
-// 	);
-// 	/*********************************结果输出************************************/
-// 	r_norm_survivor_out.write(r_norm_survivor);
-// 	for(int i=0; i<Ntr_1; ++i){
-// 		#pragma HLS PIPELINE II=1
-// 		x_survivor_real.write(x_survivor[i].real);
-// 		x_survivor_imag.write(x_survivor[i].imag);
-// 	}
-// }
+	r_norm_t r_all[CFG::Cands];
+	MyComplex x_all[CFG::Cands][CFG::Nt];
+	#pragma HLS ARRAY_PARTITION variable=r_all complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=x_all complete dim=0
+
+	survivors_read<CFG>(r_norm_in, x_real_in, x_imag_in, r_all, x_all);
+    comparison_r<CFG>(r_all, x_all, x_final);
+	PROF_MARK(PROF_CMP_END);
+}
+#ifdef SOFT_OUTPUT
+/*LLR量化：(d1 - d0)*scale按llr_q_t四舍五入并饱和，-128收到-LLR_MAX（对称）；缺少某一取值的比特直接饱和*/
+static llr_t llr_quantize(bool has0, bool has1, r_norm_t d0, r_norm_t d1, llr_scale_t scale)
+{
+	#pragma HLS INLINE
+	if (!has1)
+		return LLR_MAX;
+	if (!has0)
+		return -LLR_MAX;
+	llr_q_t v = (d1 - d0) * scale;
+	llr_t q = v.to_int();
+	return (q < -LLR_MAX) ? (llr_t)-LLR_MAX : q;
+}
+/*
+ * 候选合并：按slicer的Gray映射把每个候选的各符号编码为Mu比特（实部Gray码在高位，自高到低即LLR输出顺序），
+ * 不同采样器中相同的候选只保留r_norm最小的一个（相等时取编号小的），补齐用的重复条目也在此去掉。
+ */
+template<class CFG>
+void survivors_merge(
+	r_norm_t r_all[CFG::Cands],
+	MyComplex x_all[CFG::Cands][CFG::Nt],
+	ap_uint<CFG::Mu> code[CFG::Cands][CFG::Nt],
+	bool keep[CFG::Cands]
+){
+	const int H = CFG::Mu / 2;
+	CAND_CODE:
+	for (int c = 0; c < CFG::Cands; c++) {
+		#pragma HLS UNROLL
+		for (int i = 0; i < CFG::Nt; i++) {
+			#pragma HLS UNROLL
+			int k_re = qam_slicer_level<CFG::Mu>(x_all[c][i].real, qam_slicer_traits<CFG::Mu>::tie_upper_re);
+			int k_im = qam_slicer_level<CFG::Mu>(x_all[c][i].imag, qam_slicer_traits<CFG::Mu>::tie_upper_im);
+			code[c][i] = ((k_re ^ (k_re >> 1)) << H) | (k_im ^ (k_im >> 1));
+		}
+	}
+	CAND_DEDUP:
+	for (int c = 0; c < CFG::Cands; c++) {
+		#pragma HLS UNROLL
+		bool k = true;
+		for (int d = 0; d < CFG::Cands; d++) {
+			#pragma HLS UNROLL
+			bool same = d != c;
+			for (int i = 0; i < CFG::Nt; i++) {
+				#pragma HLS UNROLL
+				same = same && code[d][i] == code[c][i];
+			}
+			if (same && (r_all[d] < r_all[c] || (r_all[d] == r_all[c] && d < c)))
+				k = false;
+		}
+		keep[c] = k;
+	}
+}
+/*max-log LLR：候选为合并去重后的survivor列表*/
+template<class CFG>
+void llr_maxlog_hw(
+	r_norm_t r_all[CFG::Cands],
+	ap_uint<CFG::Mu> code[CFG::Cands][CFG::Nt],
+	bool keep[CFG::Cands],
+	float sigma2, float llr_gain,
+	llr_t* llr
+){
+	const llr_scale_t scale = hls_internal::generic_divide((llr_scale_t)llr_gain, (llr_scale_t)sigma2);
+	LLR_SYMBOL:
+	for (int i = 0; i < CFG::Nt; i++) {
+		#pragma HLS PIPELINE II=1
+		LLR_BIT:
+		for (int b = 0; b < CFG::Mu; b++) {
+			#pragma HLS UNROLL
+			r_norm_t d0 = 0, d1 = 0;
+			bool has0 = false, has1 = false;
+			for (int c = 0; c < CFG::Cands; c++) {
+				#pragma HLS UNROLL
+				if (!keep[c])
+					continue;
+				if ((code[c][i] >> (CFG::Mu - 1 - b)) & 1) {
+					if (!has1 || r_all[c] < d1) { d1 = r_all[c]; has1 = true; }
+				} else {
+					if (!has0 || r_all[c] < d0) { d0 = r_all[c]; has0 = true; }
+				}
+			}
+			llr[i * CFG::Mu + b] = llr_quantize(has0, has1, d0, d1, scale);
+		}
+	}
+}
+template<class CFG>
+void comparison_llr_wrapper(
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
+    float sigma2, float llr_gain,
+    MyComplex* x_final, llr_t* llr
+    PROF_PARAM
+){
+	r_norm_t r_all[CFG::Cands];
+	MyComplex x_all[CFG::Cands][CFG::Nt];
+	#pragma HLS ARRAY_PARTITION variable=r_all complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=x_all complete dim=0
+
+	survivors_read<CFG>(r_norm_in, x_real_in, x_imag_in, r_all, x_all);
+	ap_uint<CFG::Mu> code[CFG::Cands][CFG::Nt];
+	bool keep[CFG::Cands];
+	#pragma HLS ARRAY_PARTITION variable=code complete dim=0
+	#pragma HLS ARRAY_PARTITION variable=keep complete dim=1
+
+	survivors_merge<CFG>(r_all, x_all, code, keep);
+    comparison_r<CFG>(r_all, x_all, x_final);
+	llr_maxlog_hw<CFG>(r_all, code, keep, sigma2, llr_gain, llr);
+	PROF_MARK(PROF_CMP_END);
+}
+#endif
+/*共享数据预计算：dqam、constellation_norm、grad_preconditioner、alpha、pmat只依赖H与sigma2，
+  各采样器输入完全相同，因此每帧只算一次，再经FIFO扇出给各采样器*/
+template<class CFG>
+void shared_data_cal(
+	// 输入接口
+    hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
+    hls::stream<float>& sigma2_stream,
+	// 输出接口
+	hls::stream<like_float> dqam_fifo[CFG::Samplers], hls::stream<like_float> alpha_fifo[CFG::Samplers],
+	hls::stream<Myreal> constellation_norm_real[CFG::Samplers], hls::stream<Myimage> constellation_norm_imag[CFG::Samplers],
+	hls::stream<grad_preconditioner_real_t> grad_preconditioner_real[CFG::Samplers], hls::stream<grad_preconditioner_imag_t> grad_preconditioner_imag[CFG::Samplers],
+	hls::stream<pmat_real_t> pmat_real[CFG::Samplers], hls::stream<pmat_imag_t> pmat_imag[CFG::Samplers]
+	PROF_PARAM
+){
+	#pragma HLS INLINE off
+	// 本地变量
+	MyComplex_H H_local[CFG::Nr * CFG::Nt];
+	like_float alpha;
+	like_float dqam;
+	MyComplex_grad_preconditioner grad_preconditioner[CFG::Nt * CFG::Nt];
+	MyComplex constellation_norm[CFG::M];/*depend on 2^mu*/
+	MyComplex_pmat pmat[CFG::Nr * CFG::Nr];
+	MyComplex_HH HH_H[CFG::Nt * CFG::Nt];
+	MyComplex_sigma2eye sigma2eye[CFG::Nt * CFG::Nt];
+	float sigma2_local = sigma2_stream.read();
+	/*fifo data read*/
+	for(int i=0; i<CFG::Nr * CFG::Nt; ++i){
+		#pragma HLS PIPELINE II=1
+		H_local[i].real = H_real_stream.read();
+		H_local[i].imag = H_imag_stream.read();
+	}
+	/*定义发送符号之间最小距离的一半，是星座点经过归一化处理后的结果*/
+	get_dqam_hw<CFG::Mu>(dqam);
+    /*初始化constellation_norm*/
+	constellation_norm_initial<CFG>(constellation_norm, dqam);
+	/*二阶梯度下降，计算grad_preconditioner(梯度更新的预条件矩阵)*/
+	grad_preconditioner_updater_hw<CFG>(H_local, HH_H, sigma2eye, grad_preconditioner, sigma2_local, dqam);
+	PROF_MARK(PROF_PRECOND_END);
+	/*alpha*/
+	get_alpha<CFG::Nt>(alpha);
+    /*For learning rate line search */
+    learning_rate_line_search_hw<CFG, MyComplex_H, MyComplex_grad_preconditioner, MyComplex_pmat>(lr_approx_1, H_local, grad_preconditioner, pmat);
+
+	/*Output phase fifo data write*/
+	SCALAR_FANOUT:
+	for(int k=0; k<CFG::Samplers; ++k){
+		#pragma HLS UNROLL
+		dqam_fifo[k].write(dqam);
+		alpha_fifo[k].write(alpha);
+	}
+	CONSTELLATION_FANOUT:
+	for(int i=0; i<CFG::M; ++i){
+		#pragma HLS PIPELINE II=1
+		for(int k=0; k<CFG::Samplers; ++k){
+			#pragma HLS UNROLL
+			constellation_norm_real[k].write(constellation_norm[i].real);
+			constellation_norm_imag[k].write(constellation_norm[i].imag);
+		}
+	}
+	/*grad_preconditioner为Nt×Nt、pmat为Nr×Nr，Nt≠Nr时长度不同，分两段发送*/
+	PRECONDITIONER_FANOUT:
+	for(int i=0; i<CFG::Nt * CFG::Nt; ++i){
+		#pragma HLS PIPELINE II=1
+		for(int k=0; k<CFG::Samplers; ++k){
+			#pragma HLS UNROLL
+			grad_preconditioner_real[k].write(grad_preconditioner[i].real);
+			grad_preconditioner_imag[k].write(grad_preconditioner[i].imag);
+		}
+	}
+	PMAT_FANOUT:
+	for(int i=0; i<CFG::Nr * CFG::Nr; ++i){
+		#pragma HLS PIPELINE II=1
+		for(int k=0; k<CFG::Samplers; ++k){
+			#pragma HLS UNROLL
+			pmat_real[k].write(pmat[i].real);
+			pmat_imag[k].write(pmat[i].imag);
+		}
+	}
+	PROF_MARK(PROF_SHARED_END);
+}
 /*完全独立的单采样器函数*/
+template<class CFG>
 void sampler_task(
     // 输入接口
     hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
     hls::stream<y_real_t>& y_real_stream, hls::stream<y_imag_t>& y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
     hls::stream<v_real_t>& v_tb_real_stream, hls::stream<v_imag_t>& v_tb_imag_stream,
-    float sigma2,
+#endif
+	hls::stream<like_float>& dqam_fifo, hls::stream<like_float>& alpha_fifo,
+	hls::stream<Myreal>& constellation_norm_real, hls::stream<Myimage>& constellation_norm_imag,
+	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real, hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag,
+	hls::stream<pmat_real_t>& pmat_real, hls::stream<pmat_imag_t>& pmat_imag,
+	hls::stream<float>& sigma2_stream, hls::stream<unsigned int>& seed_stream,
     int sampler_id,
-	unsigned seed_in,
     // 输出接口
     hls::stream<Myreal>& x_survivor_real, hls::stream<Myimage>& x_survivor_imag,
 	hls::stream<r_norm_t>& r_norm_survivor_out
+	PROF_PARAM
 ){
 	//本地变量
-	H_real_t H_real[Ntr_2];
-	H_imag_t H_imag[Ntr_2];
-	y_real_t y_real[Ntr_1];
-	y_imag_t y_imag[Ntr_1];
-	v_real_t v_tb_real[Ntr_1 * iter_1];
-	v_imag_t v_tb_imag[Ntr_1 * iter_1];
-	MyComplex x_hat[Ntr_1];
-	MyComplex_y y_local[Ntr_1];
-	MyComplex_H H_local[Ntr_2];
-	MyComplex_v v_tb_local[Ntr_1 * iter_1];
+	MyComplex x_hat[CFG::Nt];
+	MyComplex_y y_local[CFG::Nr];
+	MyComplex_H H_local[CFG::Nr * CFG::Nt];
+#ifdef GAUSS_TABLE_MODE
+	MyComplex_v v_tb_local[CFG::num_ran];
+#endif
 	like_float alpha;
 	like_float dqam;
 	step_size_t step_size;
 	r_norm_t r_norm;/*the norm of residual vector*/
-	r_norm_t r_norm_survivor;
+	r_norm_t r_norm_survivor[CFG::Survivors];/*survivor列表，按r_norm升序*/
+	int n_survivor;
 	lr_t lr;/*learning rate*/
-	MyComplex_grad_preconditioner grad_preconditioner[Ntr_2];
-	MyComplex constellation_norm[mu_double];/*depend on 2^mu*/
-	MyComplex_pmat pmat[Ntr_2];
-	MyComplex x_survivor[Ntr_1];
-	MyComplex_r r[Ntr_1];
-	MyComplex_pr_prev pr_prev[Ntr_1];
-	MyComplex_HH HH_H[Ntr_2];
-	MyComplex_sigma2eye sigma2eye[Ntr_2];
+	MyComplex_grad_preconditioner grad_preconditioner[CFG::Nt * CFG::Nt];
+	MyComplex constellation_norm[CFG::M];/*depend on 2^mu*/
+	MyComplex_pmat pmat[CFG::Nr * CFG::Nr];
+	MyComplex x_survivor[CFG::Survivors][CFG::Nt];
+	MyComplex_r r[CFG::Nr];
+	MyComplex_pr_prev pr_prev[CFG::Nr];
+	MyComplex_HH HH_H[CFG::Nt * CFG::Nt];
+	MyComplex_sigma2eye sigma2eye[CFG::Nt * CFG::Nt];
+	/*c_gemv_hw每拍读取一整行（H^H*r时为一整列）*/
+	#pragma HLS ARRAY_PARTITION variable=H_local complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=grad_preconditioner cyclic factor=CFG::Nt dim=1
+	#pragma HLS ARRAY_PARTITION variable=pmat cyclic factor=CFG::Nr dim=1
+	#pragma HLS ARRAY_PARTITION variable=x_hat complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=r complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=pr_prev complete dim=1
+	#pragma HLS ARRAY_PARTITION variable=x_survivor complete dim=0
+	#pragma HLS ARRAY_PARTITION variable=r_norm_survivor complete dim=1
 	int offset = 0;
-	float sigma2_local = sigma2;
+	float sigma2_local = sigma2_stream.read();
 	int lr_approx = lr_approx_1;
 	int mmse_init = mmse_init_1;
-	unsigned int seed = seed_in;
-	for(int i=0; i<Ntr_2; ++i){
-		H_real[i] = H_real_stream.read();
-		H_imag[i] = H_imag_stream.read();
-	}
-	for(int i=0; i<Ntr_1; ++i){
-		y_real[i] = y_real_stream.read();
-		y_imag[i] = y_imag_stream.read();
+	unsigned int seed = seed_stream.read();
+	unsigned int gauss_seed = seed ^ GAUSS_SEED_MIX;/*高斯噪声使用独立的LCG状态，不影响x初始化与接受判定的随机序列*/
+	/*********************************数据准备************************************/
+	for(int i=0; i<CFG::Nr * CFG::Nt; ++i){
+		H_local[i].real = H_real_stream.read();
+		H_local[i].imag = H_imag_stream.read();
+	}
+	for(int i=0; i<CFG::Nr; ++i){
+		y_local[i].real = y_real_stream.read();
+		y_local[i].imag = y_imag_stream.read();
+	}
+#ifdef GAUSS_TABLE_MODE
+	for(int i=0; i<CFG::num_ran; ++i){
+		v_tb_local[i].real = v_tb_real_stream.read();
+		v_tb_local[i].imag = v_tb_imag_stream.read();
+	}
+#endif
+	/*共享预计算结果（由shared_data_cal每帧计算一次）*/
+	dqam = dqam_fifo.read();
+	alpha = alpha_fifo.read();
+	for(int i=0; i<CFG::M; ++i){
+		constellation_norm[i].real = constellation_norm_real.read();
+		constellation_norm[i].imag = constellation_norm_imag.read();
+	}
+	for(int i=0; i<CFG::Nt * CFG::Nt; ++i){
+		#pragma HLS PIPELINE II=1
+		grad_preconditioner[i].real = grad_preconditioner_real.read();
+		grad_preconditioner[i].imag = grad_preconditioner_imag.read();
 	}
-	for(int i=0; i<Ntr_1*iter_1; ++i){
-		v_tb_real[i] = v_tb_real_stream.read();
-		v_tb_imag[i] = v_tb_imag_stream.read();
+	for(int i=0; i<CFG::Nr * CFG::Nr; ++i){
+		#pragma HLS PIPELINE II=1
+		pmat[i].real = pmat_real.read();
+		pmat[i].imag = pmat_imag.read();
 	}
 
-	/*********************************数据准备************************************/
-	data_local<MyComplex_H, MyComplex_y, MyComplex_v, H_real_t, H_imag_t, y_real_t, y_imag_t, v_real_t, v_imag_t>(H_local, y_local, v_tb_local, H_real, H_imag, y_real, y_imag, v_tb_real, v_tb_imag);
-	/*定义发送符号之间最小距离的一半，是星座点经过归一化处理后的结果*/
-	get_dqam_hw(dqam);
-    /*初始化constellation_norm*/
-	constellation_norm_initial(constellation_norm, dqam);
-	/*二阶梯度下降，计算grad_preconditioner(梯度更新的预条件矩阵)*/
-	grad_preconditioner_updater_hw(H_local, HH_H, sigma2eye, grad_preconditioner, sigma2_local, dqam);
-	/*alpha*/
-	get_alpha(alpha);
-    /*For learning rate line search */
-    learning_rate_line_search_hw<MyComplex_H, MyComplex_grad_preconditioner, MyComplex_pmat>(lr_approx, H_local, grad_preconditioner, Ntr_1, Ntr_1, pmat);
+	/*MMSE初始化需要H^H*H，仅在该模式下本地计算*/
+	if (mmse_init)
+	{
+		c_gram_hw<CFG::Nr, CFG::Nt, 0>(H_local, HH_H);/*HH_H只用于求逆，上三角不需要*/
+	}
     /*x的初始化*/
-    x_initialize_hw(mmse_init, sigma2eye, Ntr_1, Ntr_1, sigma2_local, HH_H, H_local, y_local, sampler_id, dqam, x_hat, constellation_norm, seed);
+    x_initialize_hw<CFG>(mmse_init, sigma2eye, CFG::Nt, CFG::Nr, sigma2_local, HH_H, H_local, y_local, sampler_id, dqam, x_hat, constellation_norm, seed);
 	/*计算剩余向量r=y-Hx*/
-    r_hw(H_local, x_hat, r, y_local);
+    r_hw<CFG>(H_local, x_hat, r, y_local);
     /*计算剩余向量的范数（就是模值）*/
-	r_cal_hw(r, x_hat, x_survivor, r_norm, r_norm_survivor);
+	r_cal_hw<CFG>(r, x_hat, x_survivor[0], r_norm, r_norm_survivor[0]);
+	n_survivor = 1;
     /*确定最优学习率*/
-	lr_hw(lr_approx, pmat, r, pr_prev, lr, sampler_id);
+	lr_hw<CFG>(lr_approx, pmat, r, pr_prev, lr, sampler_id);
     /*步长初始化*/
-	step_size_hw(step_size, alpha, dqam, r_norm);
+	step_size_hw<CFG>(step_size, alpha, dqam, r_norm);
+	PROF_MARK(PROF_SAMPLER_BASE + 2 * (sampler_id - 1));
 	/*********************************核心计算************************************/
-	samplers_process(
+	samplers_process<CFG>(
 		/*静态量*/
-		H_local, y_local, v_tb_local, grad_preconditioner,
+		H_local, y_local,
+#ifdef GAUSS_TABLE_MODE
+		v_tb_local,
+#endif
+		grad_preconditioner,
 		pmat, constellation_norm, dqam, alpha, sigma2_local, lr_approx_1, sampler_id,
 		/*动态*/
 		x_hat, r, r_norm, pr_prev, lr,
-		step_size, offset, x_survivor, r_norm_survivor, seed
+		step_size, offset, x_survivor, r_norm_survivor, n_survivor, seed, gauss_seed
 	);
 	/*********************************结果输出************************************/
-	r_norm_survivor_out.write(r_norm_survivor);
-	for(int i=0; i<Ntr_1; ++i){
+	/*固定输出Survivors个条目，列表未满时以第0个补齐（比较级合并时去重）*/
+	for(int j=0; j<CFG::Survivors; ++j){
 		#pragma HLS PIPELINE II=1
-		x_survivor_real.write(x_survivor[i].real);
-		x_survivor_imag.write(x_survivor[i].imag);
+		r_norm_survivor_out.write(r_norm_survivor[j < n_survivor ? j : 0]);
+	}
+	for(int j=0; j<CFG::Survivors; ++j){
+		for(int i=0; i<CFG::Nt; ++i){
+			#pragma HLS PIPELINE II=1
+			x_survivor_real.write(x_survivor[j < n_survivor ? j : 0][i].real);
+			x_survivor_imag.write(x_survivor[j < n_survivor ? j : 0][i].imag);
+		}
 	}
+	PROF_MARK(PROF_SAMPLER_BASE + 2 * (sampler_id - 1) + 1);
 }
 
+#ifndef PROFILE_STAGES
+/*多帧数据分发：逐帧调用data_distribution，第f帧使用sigma2[f]与seeds + f*Samplers*/
+template<class CFG>
+void data_distribution_batch(
+#ifdef PACKED_AXI
+    axi_word_t* H, axi_word_t* y,
+#else
+    H_real_t* H_real, H_imag_t* H_imag,
+    y_real_t* y_real, y_imag_t* y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float* sigma2, unsigned int* seeds, int frames,
+
+	hls::stream<H_real_t>& H_real_out0, hls::stream<H_imag_t>& H_imag_out0,
+	hls::stream<float>& sigma2_out0,
+    hls::stream<H_real_t> H_real_out[CFG::Samplers], hls::stream<H_imag_t> H_imag_out[CFG::Samplers],
+    hls::stream<y_real_t> y_real_out[CFG::Samplers], hls::stream<y_imag_t> y_imag_out[CFG::Samplers],
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t> v_tb_real_out[CFG::Samplers], hls::stream<v_imag_t> v_tb_imag_out[CFG::Samplers],
+#endif
+	hls::stream<float> sigma2_out[CFG::Samplers], hls::stream<unsigned int> seed_out[CFG::Samplers]
+){
+	#pragma HLS INLINE off
+	FRAME_DISTRIBUTE:
+	for(int f = 0; f < frames; ++f){
+		#pragma HLS LOOP_TRIPCOUNT max=max_batch_1
+		data_distribution<CFG>(
+#ifdef PACKED_AXI
+			H + f * axi_pack<H_real_t, H_imag_t, CFG::Nr * CFG::Nt>::words,
+			y + f * axi_pack<y_real_t, y_imag_t, CFG::Nr>::words,
+#else
+			H_real + f * (CFG::Nr * CFG::Nt), H_imag + f * (CFG::Nr * CFG::Nt),
+			y_real + f * CFG::Nr, y_imag + f * CFG::Nr,
+#endif
+#ifdef GAUSS_TABLE_MODE
+			v_tb_real, v_tb_imag,
+#endif
+			sigma2[f], seeds + f * CFG::Samplers,
+
+			H_real_out0, H_imag_out0, sigma2_out0,
+			H_real_out, H_imag_out,
+			y_real_out, y_imag_out,
+#ifdef GAUSS_TABLE_MODE
+			v_tb_real_out, v_tb_imag_out,
+#endif
+			sigma2_out, seed_out
+		);
+	}
+}
+/*多帧共享预计算：每帧执行一次shared_data_cal*/
+template<class CFG>
+void shared_data_cal_batch(
+    hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
+	hls::stream<float>& sigma2_stream, int frames,
+	hls::stream<like_float> dqam_fifo[CFG::Samplers], hls::stream<like_float> alpha_fifo[CFG::Samplers],
+	hls::stream<Myreal> constellation_norm_real[CFG::Samplers], hls::stream<Myimage> constellation_norm_imag[CFG::Samplers],
+	hls::stream<grad_preconditioner_real_t> grad_preconditioner_real[CFG::Samplers], hls::stream<grad_preconditioner_imag_t> grad_preconditioner_imag[CFG::Samplers],
+	hls::stream<pmat_real_t> pmat_real[CFG::Samplers], hls::stream<pmat_imag_t> pmat_imag[CFG::Samplers]
+){
+	#pragma HLS INLINE off
+	FRAME_SHARED:
+	for(int f = 0; f < frames; ++f){
+		#pragma HLS LOOP_TRIPCOUNT max=max_batch_1
+		shared_data_cal<CFG>(
+			H_real_stream, H_imag_stream, sigma2_stream,
+			dqam_fifo, alpha_fifo, constellation_norm_real, constellation_norm_imag,
+			grad_preconditioner_real, grad_preconditioner_imag, pmat_real, pmat_imag
+		);
+	}
+}
+/*多帧采样器：每帧执行一次完整的单帧采样*/
+template<class CFG>
+void sampler_task_batch(
+    hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
+    hls::stream<y_real_t>& y_real_stream, hls::stream<y_imag_t>& y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t>& v_tb_real_stream, hls::stream<v_imag_t>& v_tb_imag_stream,
+#endif
+	hls::stream<like_float>& dqam_fifo, hls::stream<like_float>& alpha_fifo,
+	hls::stream<Myreal>& constellation_norm_real, hls::stream<Myimage>& constellation_norm_imag,
+	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real, hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag,
+	hls::stream<pmat_real_t>& pmat_real, hls::stream<pmat_imag_t>& pmat_imag,
+	hls::stream<float>& sigma2_stream, hls::stream<unsigned int>& seed_stream,
+    int sampler_id, int frames,
+    hls::stream<Myreal>& x_survivor_real, hls::stream<Myimage>& x_survivor_imag,
+	hls::stream<r_norm_t>& r_norm_survivor_out
+){
+	#pragma HLS INLINE off
+	FRAME_SAMPLE:
+	for(int f = 0; f < frames; ++f){
+		#pragma HLS LOOP_TRIPCOUNT max=max_batch_1
+		sampler_task<CFG>(
+			H_real_stream, H_imag_stream,
+			y_real_stream, y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
+			v_tb_real_stream, v_tb_imag_stream,
+#endif
+			dqam_fifo, alpha_fifo,
+			constellation_norm_real, constellation_norm_imag,
+			grad_preconditioner_real, grad_preconditioner_imag,
+			pmat_real, pmat_imag,
+			sigma2_stream, seed_stream, sampler_id,
+			x_survivor_real, x_survivor_imag,
+			r_norm_survivor_out
+		);
+	}
+}
+/*多帧比较：逐帧选出最优survivor并写回x_hat对应帧的位置*/
+template<class CFG>
+void comparison_r_wrapper_batch(
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
+	int frames,
+#ifdef PACKED_AXI
+    axi_word_t* x_hat
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag
+#endif
+){
+	#pragma HLS INLINE off
+	FRAME_COMPARE:
+	for(int f = 0; f < frames; ++f){
+		#pragma HLS LOOP_TRIPCOUNT max=max_batch_1
+		MyComplex x_final[CFG::Nt];
+		#pragma HLS ARRAY_PARTITION variable=x_final complete dim=1
+		comparison_r_wrapper<CFG>(r_norm_in, x_real_in, x_imag_in, x_final);
+#ifdef PACKED_AXI
+		out_packed_hw<CFG::Nt>(x_final, x_hat + f * axi_pack<Myreal, Myimage, CFG::Nt>::words);
+#else
+		out_hw<MyComplex, Myreal, Myimage, CFG::Nt>(x_final, 1, x_hat_real + f * CFG::Nt, x_hat_imag + f * CFG::Nt, 1);
+#endif
+	}
+}
+#endif
 
 /**********************************************************************************/
 /**********************************************************************************/
@@ -2699,372 +3180,499 @@ void sampler_task(
 /**********************************************************************************/
 /**********************************************************************************/
 
-void MHGD_detect_accel_hw(
+/*单帧检测主体：以配置CFG（Nt、Nr、Mu、Iters、Samplers）实例化，
+  顶层MHGD_detect_accel_hw只负责接口配置并以mhgd_cfg_default调用*/
+template<class CFG>
+void MHGD_detect_accel_core(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
     Myreal* x_hat_real, Myimage* x_hat_imag, 
     H_real_t* H_real, H_imag_t* H_imag, 
     y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
     v_real_t* v_tb_real, v_imag_t* v_tb_imag,
-	v_real_t* v_tb_real_2, v_imag_t* v_tb_imag_2,
-	v_real_t* v_tb_real_3, v_imag_t* v_tb_imag_3,
-	v_real_t* v_tb_real_4, v_imag_t* v_tb_imag_4,
-	//v_real_t* v_tb_real_5, v_imag_t* v_tb_imag_5,
-	//v_real_t* v_tb_real_6, v_imag_t* v_tb_imag_6,
-	//v_real_t* v_tb_real_7, v_imag_t* v_tb_imag_7,
-	//v_real_t* v_tb_real_8, v_imag_t* v_tb_imag_8,
-	float sigma2, 
-	unsigned int seed_1, unsigned int seed_2, unsigned int seed_3, unsigned int seed_4 //unsigned int seed_5, unsigned int seed_6, unsigned int seed_7, unsigned int seed_8
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+#ifdef PROFILE_STAGES
+	, unsigned int* prof
+#endif
 ){
-	/****************************AXI-Master 接口配置*******************************/
-    #pragma HLS INTERFACE mode=m_axi port=x_hat_real depth=Ntr_1 offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=x_hat_imag depth=Ntr_1 offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=H_real depth=Ntr_2 offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=H_imag depth=Ntr_2 offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=y_real depth=Ntr_1 offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=y_imag depth=Ntr_1 offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=v_tb_real depth=num_ran offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=v_tb_imag depth=num_ran offset=slave
-	#pragma HLS INTERFACE mode=m_axi port=v_tb_real_2 depth=num_ran offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_2 depth=num_ran offset=slave
-	#pragma HLS INTERFACE mode=m_axi port=v_tb_real_3 depth=num_ran offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_3 depth=num_ran offset=slave
-	#pragma HLS INTERFACE mode=m_axi port=v_tb_real_4 depth=num_ran offset=slave
-    #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_4 depth=num_ran offset=slave
-	// #pragma HLS INTERFACE mode=m_axi port=v_tb_real_5 depth=num_ran offset=slave
-    // #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_5 depth=num_ran offset=slave
-	// #pragma HLS INTERFACE mode=m_axi port=v_tb_real_6 depth=num_ran offset=slave
-    // #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_6 depth=num_ran offset=slave
-	// #pragma HLS INTERFACE mode=m_axi port=v_tb_real_7 depth=num_ran offset=slave
-    // #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_7 depth=num_ran offset=slave
-	// #pragma HLS INTERFACE mode=m_axi port=v_tb_real_8 depth=num_ran offset=slave
-    // #pragma HLS INTERFACE mode=m_axi port=v_tb_imag_8 depth=num_ran offset=slave
-
+	#pragma HLS INLINE
 	//输入数据转换为流数据
-	hls::stream<H_real_t> H_real_stream_1;
-    hls::stream<H_imag_t> H_imag_stream_1;
-    hls::stream<y_real_t> y_real_stream_1;
-    hls::stream<y_imag_t> y_imag_stream_1;
-    hls::stream<v_real_t> v_tb_real_stream_1;
-    hls::stream<v_imag_t> v_tb_imag_stream_1;
-    
-    hls::stream<H_real_t> H_real_stream_2;
-    hls::stream<H_imag_t> H_imag_stream_2;
-    hls::stream<y_real_t> y_real_stream_2;
-    hls::stream<y_imag_t> y_imag_stream_2;
-    hls::stream<v_real_t> v_tb_real_stream_2;
-    hls::stream<v_imag_t> v_tb_imag_stream_2;
-
-	hls::stream<H_real_t> H_real_stream_3;
-    hls::stream<H_imag_t> H_imag_stream_3;
-    hls::stream<y_real_t> y_real_stream_3;
-    hls::stream<y_imag_t> y_imag_stream_3;
-    hls::stream<v_real_t> v_tb_real_stream_3;
-    hls::stream<v_imag_t> v_tb_imag_stream_3;
-
-	hls::stream<H_real_t> H_real_stream_4;
-    hls::stream<H_imag_t> H_imag_stream_4;
-    hls::stream<y_real_t> y_real_stream_4;
-    hls::stream<y_imag_t> y_imag_stream_4;
-    hls::stream<v_real_t> v_tb_real_stream_4;
-    hls::stream<v_imag_t> v_tb_imag_stream_4;
-
-	// hls::stream<H_real_t> H_real_stream_5;
-    // hls::stream<H_imag_t> H_imag_stream_5;
-    // hls::stream<y_real_t> y_real_stream_5;
-    // hls::stream<y_imag_t> y_imag_stream_5;
-    // hls::stream<v_real_t> v_tb_real_stream_5;
-    // hls::stream<v_imag_t> v_tb_imag_stream_5;
-
-	// hls::stream<H_real_t> H_real_stream_6;
-    // hls::stream<H_imag_t> H_imag_stream_6;
-    // hls::stream<y_real_t> y_real_stream_6;
-    // hls::stream<y_imag_t> y_imag_stream_6;
-    // hls::stream<v_real_t> v_tb_real_stream_6;
-    // hls::stream<v_imag_t> v_tb_imag_stream_6;
-
-	// hls::stream<H_real_t> H_real_stream_7;
-    // hls::stream<H_imag_t> H_imag_stream_7;
-    // hls::stream<y_real_t> y_real_stream_7;
-    // hls::stream<y_imag_t> y_imag_stream_7;
-    // hls::stream<v_real_t> v_tb_real_stream_7;
-    // hls::stream<v_imag_t> v_tb_imag_stream_7;
-
-	// hls::stream<H_real_t> H_real_stream_8;
-    // hls::stream<H_imag_t> H_imag_stream_8;
-    // hls::stream<y_real_t> y_real_stream_8;
-    // hls::stream<y_imag_t> y_imag_stream_8;
-    // hls::stream<v_real_t> v_tb_real_stream_8;
-    // hls::stream<v_imag_t> v_tb_imag_stream_8;
-	#pragma HLS STREAM variable=H_real_stream_1 depth=Ntr_2
-    #pragma HLS STREAM variable=H_imag_stream_1 depth=Ntr_2
-	#pragma HLS STREAM variable=y_real_stream_1 depth=Ntr_1
-    #pragma HLS STREAM variable=y_imag_stream_1 depth=Ntr_1
-	#pragma HLS STREAM variable=v_tb_real_stream_1 depth=num_ran
-    #pragma HLS STREAM variable=v_tb_imag_stream_1 depth=num_ran
-
-	#pragma HLS STREAM variable=H_real_stream_2 depth=Ntr_2
-    #pragma HLS STREAM variable=H_imag_stream_2 depth=Ntr_2
-	#pragma HLS STREAM variable=y_real_stream_2 depth=Ntr_1
-    #pragma HLS STREAM variable=y_imag_stream_2 depth=Ntr_1
-	#pragma HLS STREAM variable=v_tb_real_stream_2 depth=num_ran
-    #pragma HLS STREAM variable=v_tb_imag_stream_2 depth=num_ran
-
-	#pragma HLS STREAM variable=H_real_stream_3 depth=Ntr_2
-    #pragma HLS STREAM variable=H_imag_stream_3 depth=Ntr_2
-	#pragma HLS STREAM variable=y_real_stream_3 depth=Ntr_1
-    #pragma HLS STREAM variable=y_imag_stream_3 depth=Ntr_1
-	#pragma HLS STREAM variable=v_tb_real_stream_3 depth=num_ran
-    #pragma HLS STREAM variable=v_tb_imag_stream_3 depth=num_ran
-
-	#pragma HLS STREAM variable=H_real_stream_4 depth=Ntr_2
-    #pragma HLS STREAM variable=H_imag_stream_4 depth=Ntr_2
-	#pragma HLS STREAM variable=y_real_stream_4 depth=Ntr_1
-    #pragma HLS STREAM variable=y_imag_stream_4 depth=Ntr_1
-	#pragma HLS STREAM variable=v_tb_real_stream_4 depth=num_ran
-    #pragma HLS STREAM variable=v_tb_imag_stream_4 depth=num_ran
-
-	// #pragma HLS STREAM variable=H_real_stream_5 depth=Ntr_2
-    // #pragma HLS STREAM variable=H_imag_stream_5 depth=Ntr_2
-	// #pragma HLS STREAM variable=y_real_stream_5 depth=Ntr_1
-    // #pragma HLS STREAM variable=y_imag_stream_5 depth=Ntr_1
-	// #pragma HLS STREAM variable=v_tb_real_stream_5 depth=num_ran
-    // #pragma HLS STREAM variable=v_tb_imag_stream_5 depth=num_ran
-
-	// #pragma HLS STREAM variable=H_real_stream_6 depth=Ntr_2
-    // #pragma HLS STREAM variable=H_imag_stream_6 depth=Ntr_2
-	// #pragma HLS STREAM variable=y_real_stream_6 depth=Ntr_1
-    // #pragma HLS STREAM variable=y_imag_stream_6 depth=Ntr_1
-	// #pragma HLS STREAM variable=v_tb_real_stream_6 depth=num_ran
-    // #pragma HLS STREAM variable=v_tb_imag_stream_6 depth=num_ran
-
-	// #pragma HLS STREAM variable=H_real_stream_7 depth=Ntr_2
-    // #pragma HLS STREAM variable=H_imag_stream_7 depth=Ntr_2
-	// #pragma HLS STREAM variable=y_real_stream_7 depth=Ntr_1
-    // #pragma HLS STREAM variable=y_imag_stream_7 depth=Ntr_1
-	// #pragma HLS STREAM variable=v_tb_real_stream_7 depth=num_ran
-    // #pragma HLS STREAM variable=v_tb_imag_stream_7 depth=num_ran
-
-	// #pragma HLS STREAM variable=H_real_stream_8 depth=Ntr_2
-    // #pragma HLS STREAM variable=H_imag_stream_8 depth=Ntr_2
-	// #pragma HLS STREAM variable=y_real_stream_8 depth=Ntr_1
-    // #pragma HLS STREAM variable=y_imag_stream_8 depth=Ntr_1
-	// #pragma HLS STREAM variable=v_tb_real_stream_8 depth=num_ran
-    // #pragma HLS STREAM variable=v_tb_imag_stream_8 depth=num_ran
+	hls::stream<H_real_t> H_real_stream[CFG::Samplers];
+    hls::stream<H_imag_t> H_imag_stream[CFG::Samplers];
+    hls::stream<y_real_t> y_real_stream[CFG::Samplers];
+    hls::stream<y_imag_t> y_imag_stream[CFG::Samplers];
+	hls::stream<float> sigma2_stream[CFG::Samplers];
+	hls::stream<unsigned int> seed_stream[CFG::Samplers];
+	#pragma HLS STREAM variable=H_real_stream depth=CFG::Nr*CFG::Nt
+    #pragma HLS STREAM variable=H_imag_stream depth=CFG::Nr*CFG::Nt
+	#pragma HLS STREAM variable=y_real_stream depth=CFG::Nr
+    #pragma HLS STREAM variable=y_imag_stream depth=CFG::Nr
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t> v_tb_real_stream[CFG::Samplers];
+    hls::stream<v_imag_t> v_tb_imag_stream[CFG::Samplers];
+	#pragma HLS STREAM variable=v_tb_real_stream depth=CFG::num_ran
+    #pragma HLS STREAM variable=v_tb_imag_stream depth=CFG::num_ran
+#endif
+	#pragma HLS STREAM variable=sigma2_stream depth=2
+	#pragma HLS STREAM variable=seed_stream depth=2
+	//共享预计算结果
+	hls::stream<H_real_t> H_real_stream_0;
+    hls::stream<H_imag_t> H_imag_stream_0;
+	hls::stream<float> sigma2_stream_0;
+	#pragma HLS STREAM variable=H_real_stream_0 depth=CFG::Nr*CFG::Nt
+    #pragma HLS STREAM variable=H_imag_stream_0 depth=CFG::Nr*CFG::Nt
+	#pragma HLS STREAM variable=sigma2_stream_0 depth=2
+	hls::stream<like_float> dqam_fifo[CFG::Samplers];
+	hls::stream<like_float> alpha_fifo[CFG::Samplers];
+	hls::stream<Myreal> constellation_norm_real[CFG::Samplers];
+	hls::stream<Myimage> constellation_norm_imag[CFG::Samplers];
+	hls::stream<grad_preconditioner_real_t> grad_preconditioner_real[CFG::Samplers];
+	hls::stream<grad_preconditioner_imag_t> grad_preconditioner_imag[CFG::Samplers];
+	hls::stream<pmat_real_t> pmat_real[CFG::Samplers];
+	hls::stream<pmat_imag_t> pmat_imag[CFG::Samplers];
+	#pragma HLS STREAM variable=dqam_fifo depth=2
+	#pragma HLS STREAM variable=alpha_fifo depth=2
+	#pragma HLS STREAM variable=constellation_norm_real depth=CFG::M
+	#pragma HLS STREAM variable=constellation_norm_imag depth=CFG::M
+	#pragma HLS STREAM variable=grad_preconditioner_real depth=CFG::Nt*CFG::Nt
+	#pragma HLS STREAM variable=grad_preconditioner_imag depth=CFG::Nt*CFG::Nt
+	#pragma HLS STREAM variable=pmat_real depth=CFG::Nr*CFG::Nr
+	#pragma HLS STREAM variable=pmat_imag depth=CFG::Nr*CFG::Nr
 	//采样器结果
-	hls::stream<Myreal> x_survivor_real_1;
-    hls::stream<Myimage> x_survivor_imag_1;
-    hls::stream<Myreal> x_survivor_real_2;
-    hls::stream<Myimage> x_survivor_imag_2;
-	hls::stream<Myreal> x_survivor_real_3;
-    hls::stream<Myimage> x_survivor_imag_3;
-	hls::stream<Myreal> x_survivor_real_4;
-    hls::stream<Myimage> x_survivor_imag_4;
-	// hls::stream<Myreal> x_survivor_real_5;
-    // hls::stream<Myimage> x_survivor_imag_5;
-	// hls::stream<Myreal> x_survivor_real_6;
-    // hls::stream<Myimage> x_survivor_imag_6;
-	// hls::stream<Myreal> x_survivor_real_7;
-    // hls::stream<Myimage> x_survivor_imag_7;
-	// hls::stream<Myreal> x_survivor_real_8;
-    // hls::stream<Myimage> x_survivor_imag_8;
-    hls::stream<r_norm_t> r_norm_survivor_out_1_stream;
-    hls::stream<r_norm_t> r_norm_survivor_out_2_stream;
-	hls::stream<r_norm_t> r_norm_survivor_out_3_stream;
-    hls::stream<r_norm_t> r_norm_survivor_out_4_stream;
-	// hls::stream<r_norm_t> r_norm_survivor_out_5_stream;
-    // hls::stream<r_norm_t> r_norm_survivor_out_6_stream;
-	// hls::stream<r_norm_t> r_norm_survivor_out_7_stream;
-	// hls::stream<r_norm_t> r_norm_survivor_out_8_stream;
-
-	#pragma HLS STREAM variable=x_survivor_real_1 depth=Ntr_1
-    #pragma HLS STREAM variable=x_survivor_imag_1 depth=Ntr_1
-	#pragma HLS STREAM variable=x_survivor_real_2 depth=Ntr_1
-    #pragma HLS STREAM variable=x_survivor_imag_2 depth=Ntr_1
-	#pragma HLS STREAM variable=x_survivor_real_3 depth=Ntr_1
-    #pragma HLS STREAM variable=x_survivor_imag_3 depth=Ntr_1
-	#pragma HLS STREAM variable=x_survivor_real_4 depth=Ntr_1
-    #pragma HLS STREAM variable=x_survivor_imag_4 depth=Ntr_1
-	// #pragma HLS STREAM variable=x_survivor_real_5 depth=Ntr_1
-    // #pragma HLS STREAM variable=x_survivor_imag_5 depth=Ntr_1
-	// #pragma HLS STREAM variable=x_survivor_real_6 depth=Ntr_1
-    // #pragma HLS STREAM variable=x_survivor_imag_6 depth=Ntr_1
-	// #pragma HLS STREAM variable=x_survivor_real_7 depth=Ntr_1
-    // #pragma HLS STREAM variable=x_survivor_imag_7 depth=Ntr_1
-	// #pragma HLS STREAM variable=x_survivor_real_8 depth=Ntr_1
-    // #pragma HLS STREAM variable=x_survivor_imag_8 depth=Ntr_1
-	#pragma HLS STREAM variable=r_norm_survivor_out_1_stream depth=1
-    #pragma HLS STREAM variable=r_norm_survivor_out_2_stream depth=1
-	#pragma HLS STREAM variable=r_norm_survivor_out_3_stream depth=1
-	#pragma HLS STREAM variable=r_norm_survivor_out_4_stream depth=1
-	// #pragma HLS STREAM variable=r_norm_survivor_out_5_stream depth=1
-	// #pragma HLS STREAM variable=r_norm_survivor_out_6_stream depth=1
-	// #pragma HLS STREAM variable=r_norm_survivor_out_7_stream depth=1
-	// #pragma HLS STREAM variable=r_norm_survivor_out_8_stream depth=1
-
-	MyComplex x_survivor_final[Ntr_1];
+	hls::stream<Myreal> x_survivor_real[CFG::Samplers];
+    hls::stream<Myimage> x_survivor_imag[CFG::Samplers];
+    hls::stream<r_norm_t> r_norm_survivor_out_stream[CFG::Samplers];
+	#pragma HLS STREAM variable=x_survivor_real depth=CFG::Nt*CFG::Survivors
+    #pragma HLS STREAM variable=x_survivor_imag depth=CFG::Nt*CFG::Survivors
+	#pragma HLS STREAM variable=r_norm_survivor_out_stream depth=CFG::Survivors
+
+	MyComplex x_survivor_final[CFG::Nt];
 	#pragma HLS ARRAY_PARTITION variable=x_survivor_final complete dim=1
-	int sampler_id_1 = 1;
-	int sampler_id_2 = 2;
-	int sampler_id_3 = 3;
-	int sampler_id_4 = 4;
-	// int sampler_id_5 = 5;
-	// int sampler_id_6 = 6;
-	// int sampler_id_7 = 7;
-	// int sampler_id_8 = 8;
-	float sigma2_1 = sigma2;
-	float sigma2_2 = sigma2;
-	float sigma2_3 = sigma2;
-	float sigma2_4 = sigma2;
-	// float sigma2_5 = sigma2;
-	// float sigma2_6 = sigma2;
-	// float sigma2_7 = sigma2;
-	// float sigma2_8 = sigma2;
-	unsigned int seed1 = seed_1;
-	unsigned int seed2 = seed_2;
-	unsigned int seed3 = seed_3;
-	unsigned int seed4 = seed_4;
-	// unsigned int seed5 = seed_5;
-	// unsigned int seed6 = seed_6;
-	// unsigned int seed7 = seed_7;
-	// unsigned int seed8 = seed_8;
+#ifdef SOFT_OUTPUT
+	llr_t llr_final[CFG::Nt * CFG::Mu];
+	#pragma HLS ARRAY_PARTITION variable=llr_final cyclic factor=CFG::Mu dim=1
+#endif
+#ifdef PROFILE_STAGES
+	//各级的时间点事件
+	hls::stream<prof_point_t> prof_dist, prof_shared, prof_cmp;
+	hls::stream<prof_point_t> prof_sampler[CFG::Samplers];
+	#pragma HLS STREAM variable=prof_dist depth=4
+	#pragma HLS STREAM variable=prof_shared depth=4
+	#pragma HLS STREAM variable=prof_cmp depth=4
+	#pragma HLS STREAM variable=prof_sampler depth=4
+#endif
 	#pragma HLS dataflow
 	/**************************** 数据分发 *******************************/
-	data_distribution(
+	data_distribution<CFG>(
+#ifdef PACKED_AXI
+		H, y,
+#else
 		H_real, H_imag, y_real, y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
 		v_tb_real, v_tb_imag,
-		v_tb_real_2, v_tb_imag_2,
-		v_tb_real_3, v_tb_imag_3,
-		v_tb_real_4, v_tb_imag_4,
-		// v_tb_real_5, v_tb_imag_5,
-		// v_tb_real_6, v_tb_imag_6,
-		// v_tb_real_7, v_tb_imag_7,
-		// v_tb_real_8, v_tb_imag_8,
-
-		H_real_stream_1, H_imag_stream_1,
-		y_real_stream_1, y_imag_stream_1,
-		v_tb_real_stream_1, v_tb_imag_stream_1,
-		H_real_stream_2, H_imag_stream_2,
-		y_real_stream_2, y_imag_stream_2,
-		v_tb_real_stream_2, v_tb_imag_stream_2,
-
-		H_real_stream_3, H_imag_stream_3,
-		y_real_stream_3, y_imag_stream_3,
-		v_tb_real_stream_3, v_tb_imag_stream_3,
-		H_real_stream_4, H_imag_stream_4,
-		y_real_stream_4, y_imag_stream_4,
-		v_tb_real_stream_4, v_tb_imag_stream_4
-
-		// H_real_stream_5, H_imag_stream_5,
-		// y_real_stream_5, y_imag_stream_5,
-		// v_tb_real_stream_5, v_tb_imag_stream_5,
-		// H_real_stream_6, H_imag_stream_6,
-		// y_real_stream_6, y_imag_stream_6,
-		// v_tb_real_stream_6, v_tb_imag_stream_6,
-
-		// H_real_stream_7, H_imag_stream_7,
-		// y_real_stream_7, y_imag_stream_7,
-		// v_tb_real_stream_7, v_tb_imag_stream_7,
-		// H_real_stream_8, H_imag_stream_8,
-		// y_real_stream_8, y_imag_stream_8,
-		// v_tb_real_stream_8, v_tb_imag_stream_8
+#endif
+		sigma2, seeds,
+
+		H_real_stream_0, H_imag_stream_0, sigma2_stream_0,
+		H_real_stream, H_imag_stream,
+		y_real_stream, y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
+		v_tb_real_stream, v_tb_imag_stream,
+#endif
+		sigma2_stream, seed_stream
+		PROF_ARG(prof_dist)
+	);
+	/**************************** 共享预计算 *******************************/
+	shared_data_cal<CFG>(
+		H_real_stream_0, H_imag_stream_0, sigma2_stream_0,
+		dqam_fifo, alpha_fifo, constellation_norm_real, constellation_norm_imag,
+		grad_preconditioner_real, grad_preconditioner_imag, pmat_real, pmat_imag
+		PROF_ARG(prof_shared)
 	);
 	/****************************采样器并行采样*******************************/
 	// #pragma HLS allocation instances=sampler_task limit=2 function
-	sampler_task(
-		// 输入接口
-		H_real_stream_1, H_imag_stream_1, 
-		y_real_stream_1, y_imag_stream_1, 
-		v_tb_real_stream_1, v_tb_imag_stream_1, 
-		sigma2_1, sampler_id_1, seed1,
-		// 输出接口
-		x_survivor_real_1, x_survivor_imag_1, 
-		r_norm_survivor_out_1_stream
+	SAMPLERS_PARALLEL:
+	for(int k = 0; k < CFG::Samplers; ++k){
+		#pragma HLS UNROLL
+		sampler_task<CFG>(
+			// 输入接口
+			H_real_stream[k], H_imag_stream[k], 
+			y_real_stream[k], y_imag_stream[k], 
+#ifdef GAUSS_TABLE_MODE
+			v_tb_real_stream[k], v_tb_imag_stream[k], 
+#endif
+			dqam_fifo[k], alpha_fifo[k],
+			constellation_norm_real[k], constellation_norm_imag[k],
+			grad_preconditioner_real[k], grad_preconditioner_imag[k],
+			pmat_real[k], pmat_imag[k],
+			sigma2_stream[k], seed_stream[k], k + 1,
+			// 输出接口
+			x_survivor_real[k], x_survivor_imag[k], 
+			r_norm_survivor_out_stream[k]
+			PROF_ARG(prof_sampler[k])
+		);
+	}
+	/****************************采样结果比较*******************************/
+#ifdef SOFT_OUTPUT
+	comparison_llr_wrapper<CFG>(
+		r_norm_survivor_out_stream,
+		x_survivor_real, x_survivor_imag,
+		sigma2, llr_gain,
+		x_survivor_final, llr_final
+		PROF_ARG(prof_cmp)
 	);
-	sampler_task(
-		// 输入接口
-		H_real_stream_2, H_imag_stream_2, 
-		y_real_stream_2, y_imag_stream_2, 
-		v_tb_real_stream_2, v_tb_imag_stream_2, 
-		sigma2_2, sampler_id_2, seed2,
-		// 输出接口
-		x_survivor_real_2, x_survivor_imag_2, 
-		r_norm_survivor_out_2_stream
+#else
+	comparison_r_wrapper<CFG>(
+		r_norm_survivor_out_stream,
+		x_survivor_real, x_survivor_imag,
+		x_survivor_final
+		PROF_ARG(prof_cmp)
 	);
-	sampler_task(
-		// 输入接口
-		H_real_stream_3, H_imag_stream_3, 
-		y_real_stream_3, y_imag_stream_3, 
-		v_tb_real_stream_3, v_tb_imag_stream_3, 
-		sigma2_3, sampler_id_3, seed3,
-		// 输出接口
-		x_survivor_real_3, x_survivor_imag_3, 
-		r_norm_survivor_out_3_stream
+#endif
+    /****************************迭代结束x_survivor写入输出口*********************************/
+#ifdef PACKED_AXI
+	out_packed_hw<CFG::Nt>(x_survivor_final, x_hat);
+#else
+    out_hw<MyComplex, Myreal, Myimage, CFG::Nt>(x_survivor_final, 1, x_hat_real, x_hat_imag, 1);
+#endif
+#ifdef SOFT_OUTPUT
+	out_llr_hw<CFG::Nt * CFG::Mu>(llr_final, llr);
+#endif
+#ifdef PROFILE_STAGES
+	prof_timer<CFG>(prof_dist, prof_shared, prof_sampler, prof_cmp, prof);
+#endif
+}
+
+#ifndef PROFILE_STAGES
+/*多帧检测主体：frames帧在data_distribution→sampler_task→comparison_r_wrapper间背靠背流动*/
+template<class CFG>
+void MHGD_detect_accel_batch_core(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag, 
+    H_real_t* H_real, H_imag_t* H_imag, 
+    y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float* sigma2, unsigned int* seeds, int frames
+){
+	#pragma HLS INLINE
+	//输入数据转换为流数据
+	hls::stream<H_real_t> H_real_stream[CFG::Samplers];
+    hls::stream<H_imag_t> H_imag_stream[CFG::Samplers];
+    hls::stream<y_real_t> y_real_stream[CFG::Samplers];
+    hls::stream<y_imag_t> y_imag_stream[CFG::Samplers];
+	hls::stream<float> sigma2_stream[CFG::Samplers];
+	hls::stream<unsigned int> seed_stream[CFG::Samplers];
+	#pragma HLS STREAM variable=H_real_stream depth=CFG::Nr*CFG::Nt
+    #pragma HLS STREAM variable=H_imag_stream depth=CFG::Nr*CFG::Nt
+	#pragma HLS STREAM variable=y_real_stream depth=CFG::Nr
+    #pragma HLS STREAM variable=y_imag_stream depth=CFG::Nr
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t> v_tb_real_stream[CFG::Samplers];
+    hls::stream<v_imag_t> v_tb_imag_stream[CFG::Samplers];
+	#pragma HLS STREAM variable=v_tb_real_stream depth=CFG::num_ran
+    #pragma HLS STREAM variable=v_tb_imag_stream depth=CFG::num_ran
+#endif
+	#pragma HLS STREAM variable=sigma2_stream depth=2
+	#pragma HLS STREAM variable=seed_stream depth=2
+	//共享预计算结果
+	hls::stream<H_real_t> H_real_stream_0;
+    hls::stream<H_imag_t> H_imag_stream_0;
+	hls::stream<float> sigma2_stream_0;
+	#pragma HLS STREAM variable=H_real_stream_0 depth=CFG::Nr*CFG::Nt
+    #pragma HLS STREAM variable=H_imag_stream_0 depth=CFG::Nr*CFG::Nt
+	#pragma HLS STREAM variable=sigma2_stream_0 depth=2
+	hls::stream<like_float> dqam_fifo[CFG::Samplers];
+	hls::stream<like_float> alpha_fifo[CFG::Samplers];
+	hls::stream<Myreal> constellation_norm_real[CFG::Samplers];
+	hls::stream<Myimage> constellation_norm_imag[CFG::Samplers];
+	hls::stream<grad_preconditioner_real_t> grad_preconditioner_real[CFG::Samplers];
+	hls::stream<grad_preconditioner_imag_t> grad_preconditioner_imag[CFG::Samplers];
+	hls::stream<pmat_real_t> pmat_real[CFG::Samplers];
+	hls::stream<pmat_imag_t> pmat_imag[CFG::Samplers];
+	#pragma HLS STREAM variable=dqam_fifo depth=2
+	#pragma HLS STREAM variable=alpha_fifo depth=2
+	#pragma HLS STREAM variable=constellation_norm_real depth=CFG::M
+	#pragma HLS STREAM variable=constellation_norm_imag depth=CFG::M
+	#pragma HLS STREAM variable=grad_preconditioner_real depth=CFG::Nt*CFG::Nt
+	#pragma HLS STREAM variable=grad_preconditioner_imag depth=CFG::Nt*CFG::Nt
+	#pragma HLS STREAM variable=pmat_real depth=CFG::Nr*CFG::Nr
+	#pragma HLS STREAM variable=pmat_imag depth=CFG::Nr*CFG::Nr
+	//采样器结果
+	hls::stream<Myreal> x_survivor_real[CFG::Samplers];
+    hls::stream<Myimage> x_survivor_imag[CFG::Samplers];
+    hls::stream<r_norm_t> r_norm_survivor_out_stream[CFG::Samplers];
+	#pragma HLS STREAM variable=x_survivor_real depth=CFG::Nt*CFG::Survivors
+    #pragma HLS STREAM variable=x_survivor_imag depth=CFG::Nt*CFG::Survivors
+	#pragma HLS STREAM variable=r_norm_survivor_out_stream depth=2*CFG::Survivors
+
+	int frames_1 = frames;
+	int frames_2 = frames;
+	int frames_3 = frames;
+	int frames_4 = frames;
+	#pragma HLS dataflow
+	/**************************** 数据分发 *******************************/
+	data_distribution_batch<CFG>(
+#ifdef PACKED_AXI
+		H, y,
+#else
+		H_real, H_imag, y_real, y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+		v_tb_real, v_tb_imag,
+#endif
+		sigma2, seeds, frames_1,
+
+		H_real_stream_0, H_imag_stream_0, sigma2_stream_0,
+		H_real_stream, H_imag_stream,
+		y_real_stream, y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
+		v_tb_real_stream, v_tb_imag_stream,
+#endif
+		sigma2_stream, seed_stream
 	);
-	sampler_task(
-		// 输入接口
-		H_real_stream_4, H_imag_stream_4, 
-		y_real_stream_4, y_imag_stream_4, 
-		v_tb_real_stream_4, v_tb_imag_stream_4, 
-		sigma2_4, sampler_id_4, seed4,
-		// 输出接口
-		x_survivor_real_4, x_survivor_imag_4, 
-		r_norm_survivor_out_4_stream
+	/**************************** 共享预计算 *******************************/
+	shared_data_cal_batch<CFG>(
+		H_real_stream_0, H_imag_stream_0, sigma2_stream_0, frames_2,
+		dqam_fifo, alpha_fifo, constellation_norm_real, constellation_norm_imag,
+		grad_preconditioner_real, grad_preconditioner_imag, pmat_real, pmat_imag
 	);
-	// sampler_task(
-	// 	// 输入接口
-	// 	H_real_stream_5, H_imag_stream_5, 
-	// 	y_real_stream_5, y_imag_stream_5, 
-	// 	v_tb_real_stream_5, v_tb_imag_stream_5, 
-	// 	sigma2_5, sampler_id_5, seed5,
-	// 	// 输出接口
-	// 	x_survivor_real_5, x_survivor_imag_5, 
-	// 	r_norm_survivor_out_5_stream
-	// );
-	// sampler_task(
-	// 	// 输入接口
-	// 	H_real_stream_6, H_imag_stream_6, 
-	// 	y_real_stream_6, y_imag_stream_6, 
-	// 	v_tb_real_stream_6, v_tb_imag_stream_6, 
-	// 	sigma2_6, sampler_id_6, seed6,
-	// 	// 输出接口
-	// 	x_survivor_real_6, x_survivor_imag_6, 
-	// 	r_norm_survivor_out_6_stream
-	// );
-	// sampler_task(
-	// 	// 输入接口
-	// 	H_real_stream_7, H_imag_stream_7, 
-	// 	y_real_stream_7, y_imag_stream_7, 
-	// 	v_tb_real_stream_7, v_tb_imag_stream_7, 
-	// 	sigma2_7, sampler_id_7, seed7,
-	// 	// 输出接口
-	// 	x_survivor_real_7, x_survivor_imag_7, 
-	// 	r_norm_survivor_out_7_stream
-	// );
-	// sampler_task(
-	// 	// 输入接口
-	// 	H_real_stream_8, H_imag_stream_8, 
-	// 	y_real_stream_8, y_imag_stream_8, 
-	// 	v_tb_real_stream_8, v_tb_imag_stream_8, 
-	// 	sigma2_8, sampler_id_8, seed8,
-	// 	// 输出接口
-	// 	x_survivor_real_8, x_survivor_imag_8, 
-	// 	r_norm_survivor_out_8_stream
-	// );
-	/****************************采样结果比较*******************************/
-	comparison_r_wrapper(
-		r_norm_survivor_out_1_stream, r_norm_survivor_out_2_stream,
-		r_norm_survivor_out_3_stream, r_norm_survivor_out_4_stream,
-		// r_norm_survivor_out_5_stream, r_norm_survivor_out_6_stream,
-		// r_norm_survivor_out_7_stream, r_norm_survivor_out_8_stream,
-		x_survivor_real_1, x_survivor_imag_1,
-		x_survivor_real_2, x_survivor_imag_2,
-		x_survivor_real_3, x_survivor_imag_3,
-		x_survivor_real_4, x_survivor_imag_4,
-		// x_survivor_real_5, x_survivor_imag_5,
-		// x_survivor_real_6, x_survivor_imag_6,
-		// x_survivor_real_7, x_survivor_imag_7,
-		// x_survivor_real_8, x_survivor_imag_8,
-		x_survivor_final
+	/****************************采样器并行采样*******************************/
+	SAMPLERS_PARALLEL:
+	for(int k = 0; k < CFG::Samplers; ++k){
+		#pragma HLS UNROLL
+		sampler_task_batch<CFG>(
+			H_real_stream[k], H_imag_stream[k],
+			y_real_stream[k], y_imag_stream[k],
+#ifdef GAUSS_TABLE_MODE
+			v_tb_real_stream[k], v_tb_imag_stream[k],
+#endif
+			dqam_fifo[k], alpha_fifo[k],
+			constellation_norm_real[k], constellation_norm_imag[k],
+			grad_preconditioner_real[k], grad_preconditioner_imag[k],
+			pmat_real[k], pmat_imag[k],
+			sigma2_stream[k], seed_stream[k], k + 1, frames_3,
+			x_survivor_real[k], x_survivor_imag[k],
+			r_norm_survivor_out_stream[k]
+		);
+	}
+	/****************************采样结果比较并写回*******************************/
+	comparison_r_wrapper_batch<CFG>(
+		r_norm_survivor_out_stream,
+		x_survivor_real, x_survivor_imag,
+		frames_4,
+#ifdef PACKED_AXI
+		x_hat
+#else
+		x_hat_real, x_hat_imag
+#endif
 	);
-    /****************************迭代结束x_survivor写入输出口*********************************/
-    out_hw<MyComplex, Myreal, Myimage>(x_survivor_final, 1, x_hat_real, x_hat_imag, 1);
-}
\ No newline at end of file
+}
+#endif
+
+void MHGD_detect_accel_hw(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag, 
+    H_real_t* H_real, H_imag_t* H_imag, 
+    y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+#ifdef PROFILE_STAGES
+	, unsigned int* prof
+#endif
+){
+	/****************************AXI-Master 接口配置*******************************/
+#ifdef PACKED_AXI
+    #pragma HLS INTERFACE mode=m_axi port=x_hat depth=x_words_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=H depth=H_words_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=y depth=y_words_1 offset=slave
+#else
+    #pragma HLS INTERFACE mode=m_axi port=x_hat_real depth=Ntr_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=x_hat_imag depth=Ntr_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=H_real depth=Ntr_2 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=H_imag depth=Ntr_2 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=y_real depth=Ntr_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=y_imag depth=Ntr_1 offset=slave
+#endif
+#ifdef GAUSS_TABLE_MODE
+    #pragma HLS INTERFACE mode=m_axi port=v_tb_real depth=num_ran*samplers offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=v_tb_imag depth=num_ran*samplers offset=slave
+#endif
+    #pragma HLS INTERFACE mode=m_axi port=seeds depth=samplers offset=slave
+#ifdef SOFT_OUTPUT
+    #pragma HLS INTERFACE mode=m_axi port=llr depth=Ntr_1*mu_1 offset=slave
+#endif
+#ifdef PROFILE_STAGES
+    #pragma HLS INTERFACE mode=m_axi port=prof depth=2+PROF_SAMPLER_BASE+2*samplers offset=slave
+#endif
+
+	MHGD_detect_accel_core<mhgd_cfg_default>(
+#ifdef PACKED_AXI
+		x_hat, H, y,
+#else
+		x_hat_real, x_hat_imag,
+		H_real, H_imag,
+		y_real, y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+		v_tb_real, v_tb_imag,
+#endif
+		sigma2, seeds
+#ifdef SOFT_OUTPUT
+		, llr, llr_gain
+#endif
+#ifdef PROFILE_STAGES
+		, prof
+#endif
+	);
+}
+
+#ifndef PROFILE_STAGES
+/*批处理顶层*/
+void MHGD_detect_accel_hw_batch(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag, 
+    H_real_t* H_real, H_imag_t* H_imag, 
+    y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float* sigma2, unsigned int* seeds, int frames
+){
+	/****************************AXI-Master 接口配置*******************************/
+#ifdef PACKED_AXI
+    #pragma HLS INTERFACE mode=m_axi port=x_hat depth=x_words_1*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=H depth=H_words_1*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=y depth=y_words_1*max_batch_1 offset=slave
+#else
+    #pragma HLS INTERFACE mode=m_axi port=x_hat_real depth=Ntr_1*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=x_hat_imag depth=Ntr_1*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=H_real depth=Ntr_2*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=H_imag depth=Ntr_2*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=y_real depth=Ntr_1*max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=y_imag depth=Ntr_1*max_batch_1 offset=slave
+#endif
+#ifdef GAUSS_TABLE_MODE
+    #pragma HLS INTERFACE mode=m_axi port=v_tb_real depth=num_ran*samplers offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=v_tb_imag depth=num_ran*samplers offset=slave
+#endif
+    #pragma HLS INTERFACE mode=m_axi port=sigma2 depth=max_batch_1 offset=slave
+    #pragma HLS INTERFACE mode=m_axi port=seeds depth=samplers*max_batch_1 offset=slave
+
+	MHGD_detect_accel_batch_core<mhgd_cfg_default>(
+#ifdef PACKED_AXI
+		x_hat, H, y,
+#else
+		x_hat_real, x_hat_imag,
+		H_real, H_imag,
+		y_real, y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+		v_tb_real, v_tb_imag,
+#endif
+		sigma2, seeds, frames
+	);
+}
+#endif
+#ifdef INV_VERIFY
+/*C仿真比对用的显式实例化（main_hw.cpp中的INV_VERIFY）*/
+template void get_dqam_hw<mu_1>(like_float&);
+#endif
+#if defined(INV_VERIFY) || defined(MHGD_BENCH)
+/*两种倒数实现的定点求逆，INV_VERIFY与微基准都要比较*/
+template void Inverse_LDL_fixed<Ntr_1, ldl_recip_lut>(MyComplex*);
+template void Inverse_LDL_fixed<Ntr_1, ldl_recip_div>(MyComplex*);
+#endif
+#ifdef MHGD_BENCH
+/*微基准（mhgd_bench.cpp）用的显式实例化：浮点、ap_fixed<40,8>与内核中实际使用的窄位宽类型*/
+template void c_matmultiple_hw_pro<MyComplex_f, MyComplex_f, MyComplex_f>(MyComplex_f*, int, MyComplex_f*, int, int, int, int, int, MyComplex_f*);
+template void c_matmultiple_hw_pro<MyComplex, MyComplex, MyComplex>(MyComplex*, int, MyComplex*, int, int, int, int, int, MyComplex*);
+template void c_matmultiple_hw_pro<MyComplex_H, MyComplex_H, MyComplex_HH>(MyComplex_H*, int, MyComplex_H*, int, int, int, int, int, MyComplex_HH*);
+template void Inverse_LU_hw<MyComplex>(MyComplex*);
+template void Inverse_LDL_fixed<4, ldl_recip_lut>(MyComplex*);
+template void Inverse_LDL_fixed<4, ldl_recip_div>(MyComplex*);
+template void Inverse_LDL_fixed<16, ldl_recip_lut>(MyComplex*);
+template void Inverse_LDL_fixed<16, ldl_recip_div>(MyComplex*);
+template void map_hw<MyComplex, MyComplex, like_float, Myreal, Ntr_1, mu_1>(like_float, MyComplex*, MyComplex*);
+template void map_hw<MyComplex_z_prop, MyComplex_x_prop, z_prop_real_t, x_prop_real_t, Ntr_1, mu_1>(like_float, MyComplex_z_prop*, MyComplex_x_prop*);
+template like_float fixed_floor<like_float>(const like_float&);
+template z_prop_real_t fixed_floor<z_prop_real_t>(const z_prop_real_t&);
+template void generateUniformRandoms_int_hw_pro_0<Ntr_1, mu_1>(unsigned int&, int*);
+#endif
+#ifdef MULTI_CFG_VERIFY
+/*C仿真用的非默认配置实例化（main_hw.cpp中的MULTI_CFG_VERIFY）*/
+template void MHGD_detect_accel_core<mhgd_cfg_4x4_qpsk>(
+#ifdef PACKED_AXI
+    axi_word_t*, axi_word_t*, axi_word_t*,
+#else
+    Myreal*, Myimage*, H_real_t*, H_imag_t*, y_real_t*, y_imag_t*,
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t*, v_imag_t*,
+#endif
+    float, unsigned int*
+#ifdef SOFT_OUTPUT
+    , llr_t*, float
+#endif
+#ifdef PROFILE_STAGES
+    , unsigned int*
+#endif
+    );
+template void MHGD_detect_accel_core<mhgd_cfg_16x16_64qam>(
+#ifdef PACKED_AXI
+    axi_word_t*, axi_word_t*, axi_word_t*,
+#else
+    Myreal*, Myimage*, H_real_t*, H_imag_t*, y_real_t*, y_imag_t*,
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t*, v_imag_t*,
+#endif
+    float, unsigned int*
+#ifdef SOFT_OUTPUT
+    , llr_t*, float
+#endif
+#ifdef PROFILE_STAGES
+    , unsigned int*
+#endif
+    );
+template void MHGD_detect_accel_core<mhgd_cfg_4x8_16qam>(
+#ifdef PACKED_AXI
+    axi_word_t*, axi_word_t*, axi_word_t*,
+#else
+    Myreal*, Myimage*, H_real_t*, H_imag_t*, y_real_t*, y_imag_t*,
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t*, v_imag_t*,
+#endif
+    float, unsigned int*
+#ifdef SOFT_OUTPUT
+    , llr_t*, float
+#endif
+#ifdef PROFILE_STAGES
+    , unsigned int*
+#endif
+    );
+#endif
@@ -1,19 +1,22 @@
 #pragma once
 #include "MyComplex_1.h"
 #include "hls_math.h"
+#include "mhgd_iface.h"
 
-// #ifdef SENSITIVITY_ANALYSIS_MODE
-// #include "/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/sensitivity_types.hpp"
-
-// // 为关键变量使用灵敏度分析专用类型
-// #define SENSITIVITY_TYPE(VAR) VAR##_t
-// #else
-// // 非分析模式使用标准类型
-// #define SENSITIVITY_TYPE(VAR) ap_fixed<40,8>
-// #endif
+// 位宽灵敏度分析（SENSITIVITY_ANALYSIS_MODE）的开关与类型替换见MyComplex_1.h，扫描驱动为sensitivity_sweep.py
 
 typedef struct _IO_FILE FILE;
 
+// #define GAUSS_TABLE_MODE	// 打开后：随机游走噪声仍由主机高斯表v_tb经m_axi提供（用于与旧版本C仿真逐位比对）；默认由片上Box-Muller生成
+// #define LDL_RECIP_DIVIDER	// 打开后：Inverse_LDL_fixed中D的N次倒数改回40位除法器；默认用64项查表加两次牛顿迭代（recip_lut_hw），缩短每列的分解延迟
+// #define INV_VERIFY	// 打开后：C仿真开始时逐帧比较定点Inverse_LDL_fixed与浮点Inverse_LDL_pro相对双精度参考的误差
+// #define GEMM_VERIFY	// 打开后：C仿真开始时将脉动阵列c_gemm_systolic_hw与逐项乘加参考实现逐位比对
+// #define MULTI_CFG_VERIFY	// 打开后：C仿真结束前用随机信道跑4×4 QPSK、16×16 64QAM、4发8收16QAM几种非默认配置的MHGD_detect_accel_core并打印BER
+// #define SOFT_OUTPUT	// 打开后：单帧顶层在seeds之后增加llr输出口，由各采样器的survivor列表（SURVIVOR_K）计算max-log比特LLR（int8），供下游LDPC译码
+// #define PROFILE_STAGES	// 打开后：单帧顶层最后增加prof输出口，每帧写出各级时间点的周期计数（记录格式见mhgd_prof.h）；C仿真中改为统计各级的实数乘法次数。批处理顶层不参与编译
+// #define PACKED_AXI	// 打开后：两个顶层的H/y/x_hat改为各一个ap_uint<512>端口，复数元素按mhgd_axi_pack.h的格式打包（主机打包、data_distribution解包），每帧的AXI传输由160拍减为9拍
+#define GAUSS_SEED_MIX 0x2545F491	// 片上高斯发生器的种子 = seed_in ^ GAUSS_SEED_MIX
+
 #define LCG_A 1664525
 #define LCG_C 1013904223
 #define LIMIT_MAX 0x7fffffff
@@ -33,10 +36,10 @@ const uint64_t PCG_MULTIPLIER = 6364136223846793005ULL;
 const uint64_t PCG_INCREMENT = 1442695040888963407ULL;  //奇数确保全周期
 
 /*算法参数*/
-static const int Ntr_1 = 8;/*发射&接收天线数*/
+static const int Ntr_1 = mhgd_ntr;/*发射&接收天线数*/
 static const int Ntr_2 = Ntr_1*Ntr_1;/*NtorNr^2*/
-static const int iter_1 = 10;/*采样器的采样数*/
-static const int num_ran = iter_1*Ntr_1;/*需要的高斯随机噪声数*/
+static const int iter_1 = mhgd_iters;/*采样器的采样数*/
+static const int num_ran = mhgd_num_ran;/*需要的高斯随机噪声数*/
 static const int mu_1 = 4;/*调制阶数*/
 static const int mu_double = 16;/*调制阶数对应的2指数值*/
 static const int mmse_init_1 = 0;/*是否使用MMSE检测的结果作为MCMC采样的初始值*/
@@ -44,7 +47,92 @@ static const int mmse_init_2 = 0;
 static const int lr_approx_1 = 0;
 static const int lr_approx_2 = 0;
 static const int max_iter_1 = 10;/*希望仿真的最大轮数*/
-static const int samplers = 4;
+#ifndef MHGD_SAMPLERS
+#define MHGD_SAMPLERS 4	/*并行采样器数量，可用-DMHGD_SAMPLERS=2/4/8/16编译不同面积/性能的版本*/
+#endif
+static const int samplers = MHGD_SAMPLERS;
+#ifndef RESID_REFRESH
+#define RESID_REFRESH 5	/*samplers_process中残差增量更新的整体重算周期（迭代数），用于限制定点累积误差；设为1即每次迭代整体重算*/
+#endif
+static const int max_batch_1 = mhgd_max_batch;/*批处理接口单次调用的最大帧数（仅用于depth/tripcount）*/
+#ifndef SURVIVOR_K
+#define SURVIVOR_K 1	/*每个采样器保留的survivor列表长度（按r_norm升序的top-K），可用-DSURVIVOR_K=4编译；为1时即单survivor*/
+#endif
+typedef ap_int<8> llr_t;
+typedef ap_fixed<48,20> llr_scale_t;	/*llr_gain / sigma2，每帧算一次（llr_gain与LLR_MAX见mhgd_iface.h）*/
+typedef ap_fixed<8,8,AP_RND,AP_SAT> llr_q_t;	/*量化：四舍五入并饱和到int8，再把-128收到-LLR_MAX*/
+
+/*
+ * PROFILE_STAGES：各流式函数在时间点（mhgd_prof.h中的PROF_*）上经PROF_MARK向各自的事件流写入时间点编号，
+ * 与它们并行的prof_timer在自由运行的计数器上锁存到达时刻。关闭时PROF_PARAM/PROF_ARG/PROF_MARK均为空。
+ */
+#ifdef PROFILE_STAGES
+#include "mhgd_prof.h"
+typedef ap_uint<8> prof_point_t;
+#define PROF_PARAM , hls::stream<prof_point_t>& prof_ev
+#define PROF_ARG(ev) , ev
+#define PROF_MARK(p) prof_mark(prof_ev, p)
+#if !defined(__SYNTHESIS__)
+/*C仿真：complex_multiply_hw/c_norm2_hw中累加实数乘法次数，prof_mark记下各时间点的计数（按线程，供多线程BER驱动使用）*/
+extern thread_local unsigned int mhgd_prof_muls;
+extern thread_local unsigned int mhgd_prof_csim[256];
+#define PROF_MULS(n) (mhgd_prof_muls += (n))
+#else
+#define PROF_MULS(n)
+#endif
+#else
+#define PROF_PARAM
+#define PROF_ARG(ev)
+#define PROF_MARK(p)
+#define PROF_MULS(n)
+#endif
+
+#ifdef PACKED_AXI
+#include "mhgd_axi_pack.h"
+/*每帧H/y/x_hat占的512位字数（默认配置），即打包端口的depth与批处理中相邻帧的字偏移*/
+static const int H_words_1 = axi_pack<H_real_t, H_imag_t, Ntr_2>::words;
+static const int y_words_1 = axi_pack<y_real_t, y_imag_t, Ntr_1>::words;
+static const int x_words_1 = axi_pack<Myreal, Myimage, Ntr_1>::words;
+#endif
+
+/*星座表（MHGD_accel_hw.cpp），按调制阶数MU由qam_traits在编译期选择*/
+extern MyComplex QPSK_Constellation_hw[4];
+extern MyComplex _16QAM_Constellation_hw[16];
+extern MyComplex _64QAM_Constellation_hw[64];
+template<int MU> struct qam_traits;/*只支持MU=2/4/6*/
+template<> struct qam_traits<2> {
+	static const int amp_max = 1;/*未归一化星座单轴最大幅度*/
+	static const MyComplex* table() { return QPSK_Constellation_hw; }
+};
+template<> struct qam_traits<4> {
+	static const int amp_max = 3;
+	static const MyComplex* table() { return _16QAM_Constellation_hw; }
+};
+template<> struct qam_traits<6> {
+	static const int amp_max = 7;
+	static const MyComplex* table() { return _64QAM_Constellation_hw; }
+};
+/*检测器编译期配置：NT发射天线数、NR接收天线数、MU调制阶数、ITERS每个采样器的迭代数、S并行采样器数。
+  H按NR×NT行主序存放；定点位宽（MyComplex_1.h）各配置共用，按8×8 16QAM整定*/
+template<int NT, int NR, int MU, int ITERS, int S>
+struct mhgd_cfg {
+	static const int Nt = NT;
+	static const int Nr = NR;
+	static const int Mu = MU;
+	static const int M = 1 << MU;/*星座点数*/
+	static const int Iters = ITERS;
+	static const int Samplers = S;
+	static const int num_ran = ITERS * NT;/*GAUSS_TABLE_MODE下每个采样器的高斯表长度*/
+	static const int Survivors = SURVIVOR_K;/*每个采样器的survivor列表长度*/
+	static const int Cands = S * SURVIVOR_K;/*比较级的候选总数*/
+};
+typedef mhgd_cfg<Ntr_1, Ntr_1, mu_1, iter_1, samplers> mhgd_cfg_default;/*顶层MHGD_detect_accel_hw使用的配置*/
+#ifdef MULTI_CFG_VERIFY
+/*C仿真中与默认配置一起实例化的配置（MHGD_accel_hw.cpp末尾显式实例化）*/
+typedef mhgd_cfg<4, 4, 2, iter_1, samplers> mhgd_cfg_4x4_qpsk;
+typedef mhgd_cfg<16, 16, 6, iter_1, samplers> mhgd_cfg_16x16_64qam;
+typedef mhgd_cfg<4, 8, 4, iter_1, samplers> mhgd_cfg_4x8_16qam;
+#endif
 
 void read_gaussian_data_hw(const char* filename, MyComplex_v* array, int n, int offset);
 void QAM_Demodulation_hw(MyComplex* x_hat, int Nt, int mu, int* bits_demod);
@@ -56,15 +144,16 @@ int unequal_times_hw(int* array1, int* array2, int n);
 unsigned int lcg_rand_hw();
 like_float lcg_rand_1_hw();
 Myreal complex_norm_sqr(MyComplex a);
+template<int MU = mu_1>
 void get_dqam_hw(like_float &dqam);
-template <typename T>void c_eye_generate_hw(T* Mat, float val);
+template <typename T, int N = Ntr_1>void c_eye_generate_hw(T* Mat, float val);
 template <typename TH, typename TY, typename TV, typename TH_real, typename TH_imag, typename TY_real, typename TY_imag, typename TV_real, typename TV_imag>
 void data_local(TH* H, TY* y, TV* v_tb, TH_real* H_real, TH_imag* H_imag, TY_real* y_real, TY_imag* y_imag, TV_real* v_tb_real, TV_imag* v_tb_imag);
 template<typename TA, typename TB, typename TR>
 void c_matmultiple_hw(TA* matA, int transA, TB* matB, int transB, int ma, int na, int mb, int nb, TR* res);
-template<typename TA, typename TB, typename TR>
+template<typename TA, typename TB, typename TR, int LEN = Ntr_2>
 void my_complex_add_hw(const TA a[], const TB b[], TR r[]);
-template<typename TA, typename TB, typename TR>
+template<typename TA, typename TB, typename TR, int LEN = Ntr_1>
 void my_complex_add_hw_1(const TA a[], const TB b[], TR r[]);
 template<typename TA>
 void initMatrix_hw(TA* A);
@@ -76,26 +165,26 @@ template<typename TA, typename TB>
 MyComplex complex_add_hw(TA a, TB b);
 template<typename TA, typename TB>
 MyComplex complex_subtract_hw(TA a, TB b);
-template<typename TA, typename TB, typename TR>
+template<typename TA, typename TB, typename TR, int LEN = Ntr_1>
 void my_complex_sub_hw(const TA a[], const TB b[], TR r[]);
 template<typename TA, typename TB, typename TC>
 void MulMatrix_hw(const TA* A, const TB* B, TC* C);
 template<typename TA>
 void Inverse_LU_hw(TA* A);
-template<typename TX>
+template<typename TX, int LEN = Ntr_1>
 void my_complex_scal_hw(const like_float alpha, TX* X, const int incX);
-template<typename TX>
+template<typename TX, int LEN = mu_double>
 void my_complex_scal_hw_1(const like_float alpha, TX* X, const int incX);
-template<typename TX, typename TX_hat, typename x_real, typename hat_real>
+template<typename TX, typename TX_hat, typename x_real, typename hat_real, int N = Ntr_1, int MU = mu_1>
 void map_hw(like_float dqam, TX* x, TX_hat* x_hat);
 void generateUniformRandoms_int_hw(int* x_init);
-template<typename TX, typename TY>
+template<typename TX, typename TY, int LEN = Ntr_1>
 void my_complex_copy_hw(const TX* X, const int incX, TY* Y, const int incY);
-template<typename TX, typename TY>
+template<typename TX, typename TY, int LEN = mu_double>
 void my_complex_copy_hw_1(const TX* X, const int incX, TY* Y, const int incY);
 void generateUniformRandoms_float_hw(like_float* p_uni);
-template<typename TH, typename T_grad, typename T_pat>
-void learning_rate_line_search_hw(int lr_approx, TH* H, T_grad* grad_preconditioner, int Nr, int Nt, T_pat* pmat);
+template<class CFG, typename TH, typename T_grad, typename T_pat>
+void learning_rate_line_search_hw(int lr_approx, TH* H, T_grad* grad_preconditioner, T_pat* pmat);
 void r_hw(MyComplex* H, int transB, int transA, MyComplex* x_hat, int Nr, int Nt, MyComplex* r, MyComplex* y);
 void r_cal_hw(MyComplex* r, int transA, int transB, int Nr, int Nt, MyComplex* temp_1, MyComplex* x_hat, MyComplex* x_survivor, like_float r_norm, like_float r_norm_survivor);
 void z_grad_hw(MyComplex* H, int transA, int transB, MyComplex* temp_Nt, MyComplex* grad_preconditioner, MyComplex* z_grad, like_float lr, MyComplex* x_hat);
@@ -103,12 +192,26 @@ void gauss_add_hw(MyComplex* v, MyComplex* v_tb, int offset, like_float step_siz
 void r_newnorm_hw(MyComplex* H, int transB, MyComplex* x_prop, int transA, MyComplex* temp_Nr, MyComplex* y, MyComplex* r_prop, MyComplex* temp_1, like_float r_norm_prop);
 void survivor_hw(like_float r_norm_survivor, like_float r_norm_prop, MyComplex* x_prop, MyComplex* x_survivor);
 void acceptance_hw(int transB, int transA, like_float r_norm_prop, like_float r_norm, like_float log_pacc, like_float p_acc, like_float* p_uni, MyComplex* x_prop , MyComplex* x_hat, MyComplex* r_prop, MyComplex* r, MyComplex* pmat, MyComplex* pr_prev, MyComplex* temp_1, MyComplex* _temp_1, like_float lr, like_float step_size, like_float dqam, like_float alpha);
-template<typename TX, typename TY_real, typename TY_imag>
+template<typename TX, typename TY_real, typename TY_imag, int LEN = Ntr_1>
 void out_hw(const TX* X, const int incX, TY_real* Y_real, TY_imag* Y_imag, int incY);
 template <typename T>
 T fixed_floor(const T& val);
 
 void Inverse_LU(MyComplex_f* A);
+void Inverse_LDL(MyComplex_f* A);
+void Inverse_LDL_pro(MyComplex_f* A);
+void Inverse_QR(MyComplex_f* A);
+void Inverse_Cholesky(MyComplex_f* A);
+/*Inverse_LDL_fixed中D的倒数：查表加牛顿迭代（recip_lut_hw）或40位除法器（generic_divide），默认见LDL_RECIP_DIVIDER*/
+enum { ldl_recip_lut = 0, ldl_recip_div = 1 };
+#ifdef LDL_RECIP_DIVIDER
+static const int ldl_recip_default = ldl_recip_div;
+#else
+static const int ldl_recip_default = ldl_recip_lut;
+#endif
+template<int N = Ntr_1, int RECIP = ldl_recip_default>
+void Inverse_LDL_fixed(MyComplex* A);
+like_float recip_lut_hw(like_float d);
 void initMatrix(MyComplex_f* A);
 void MulMatrix(const MyComplex_f* A, const MyComplex_f* B, MyComplex_f* C);
 MyComplex_f complex_divide(MyComplex_f a, MyComplex_f b);
@@ -119,11 +222,12 @@ MyComplex_f complex_subtract(MyComplex_f a, MyComplex_f b);
 
 //hardware function ggoodd
 unsigned int fast_mod_barrett(uint64_t a);
-template <unsigned int INIT_SEED = 1>
 unsigned int lcg_rand_hw_opt(unsigned int &seed);
 like_float lcg_rand_1_hw_fixed(unsigned int &seed);
+template<int N = Ntr_1, int MU = mu_1>
 void generateUniformRandoms_int_hw_pro_0(unsigned int &seed, int* x_init);
 void generateUniformRandoms_float_hw_pro(unsigned int &seed, like_float* p_uni);
+void gauss_rand_hw(unsigned int &seed, MyComplex_v &v);
 template<typename TA, typename TB, typename TR>
 void c_matmultiple_hw_pro(
     TA* matA, int transA,
@@ -131,6 +235,21 @@ void c_matmultiple_hw_pro(
     int ma, int na, int mb, int nb,
     TR* res);
 
+template<int N>
+MyComplex complex_adder_tree_hw(MyComplex p[N]);
+template<int M, int N, int CONJ_T, typename TA, typename TX, typename TR>
+void c_gemv_hw(const TA* A, const TX* x, TR* y);
+template<int N, typename TA, typename TB>
+MyComplex c_dot_hw(const TA* a, const TB* b);
+template<int N, typename TA>
+like_float c_norm2_hw(const TA* a);
+template<int N, int CONJ_A, int CONJ_B, typename TA, typename TB, typename TC>
+void c_gemm_hw(const TA* A, const TB* B, TC* C);
+template<int M, int N, int MIRROR, typename TA, typename TC>
+void c_gram_hw(const TA* A, TC* C);
+template<int M, int K, int N, int CONJ_A, int CONJ_B, typename TA, typename TB, typename TC>
+void c_gemm_systolic_hw(const TA* A, const TB* B, TC* C);
+
 // 黑盒版本复数乘法函数
 void c_matmultiple_hw_pro_wrapper(
     ap_fixed<40,8>* matA_real, ap_fixed<40,8>* matA_imag,
@@ -142,22 +261,32 @@ void c_matmultiple_hw_pro_wrapper(
 
 
 
+template<class CFG>
 void constellation_norm_initial(
 	MyComplex* constellation_norm, like_float dqam
 );
+template<class CFG>
 void grad_preconditioner_updater_hw(
 	MyComplex_H* H, MyComplex_HH* HH_H, MyComplex_sigma2eye* sigma2eye, 
 	MyComplex_grad_preconditioner* grad_preconditioner, float sigma2_local, like_float dqam
 );
+template<int NT = Ntr_1>
 void get_alpha(like_float &alpha);
+template<class CFG>
 void x_initialize_hw(
 	int mmse_init, MyComplex_sigma2eye* sigma2eye, int Nt, int Nr, float sigma2, MyComplex_HH* HH_H, 
 	MyComplex_H* H, MyComplex_y* y, int num,
 	like_float dqam, MyComplex* x_hat, MyComplex* constellation_norm, unsigned int& seed
 );
+template<class CFG>
 void r_hw(MyComplex_H* H, MyComplex* x_hat, MyComplex_r* r, MyComplex_y* y);
+template<class CFG>
+void r_update_hw(MyComplex_H* H, MyComplex_x_prop* x_prop, MyComplex* x_hat, MyComplex_r* r, MyComplex_r* r_prop);
+template<class CFG>
 void r_cal_hw(MyComplex_r* r, MyComplex* x_hat, MyComplex* x_survivor, r_norm_t &r_norm, r_norm_t &r_norm_survivor);
+template<class CFG>
 void lr_hw(int lr_approx, MyComplex_pmat* pmat, MyComplex_r* r, MyComplex_pr_prev* pr_prev, lr_t &lr, int num);
+template<class CFG>
 void step_size_hw(step_size_t &step_size, like_float alpha, like_float dqam, r_norm_t r_norm);
 void data_copy(
 	/*静态量*/
@@ -167,125 +296,266 @@ void data_copy(
 	MyComplex_H* H_local_2, MyComplex_y* y_local_2, MyComplex_v* v_tb_local_2, MyComplex_grad_preconditioner* grad_preconditioner_2,
 	MyComplex_pmat* pmat_2, MyComplex* constellation_norm_2, like_float &dqam_2, like_float &alpha_2, MyComplex_sigma2eye* sigma2eye_2, MyComplex_HH* HH_H_2
 );
+template<class CFG>
 void samplers_process(
 	/*静态量*/
-	MyComplex_H H_local[Ntr_2], MyComplex_y y_local[Ntr_1], MyComplex_v v_tb_local[Ntr_1 * iter_1], MyComplex_grad_preconditioner grad_preconditioner[Ntr_2],
-	MyComplex_pmat pmat[Ntr_2], MyComplex constellation_norm[16], like_float dqam, like_float alpha, float sigma2_local, int lr_approx, int num,
+	MyComplex_H H_local[CFG::Nr * CFG::Nt], MyComplex_y y_local[CFG::Nr],
+#ifdef GAUSS_TABLE_MODE
+	MyComplex_v v_tb_local[CFG::num_ran],
+#endif
+	MyComplex_grad_preconditioner grad_preconditioner[CFG::Nt * CFG::Nt],
+	MyComplex_pmat pmat[CFG::Nr * CFG::Nr], MyComplex constellation_norm[CFG::M], like_float dqam, like_float alpha, float sigma2_local, int lr_approx, int num,
 	/*动态*/
 	MyComplex* x_hat, MyComplex_r* r, r_norm_t &r_norm, MyComplex_pr_prev* pr_prev, lr_t &lr,
-	step_size_t &step_size, int &offset, MyComplex* x_survivor, r_norm_t &r_norm_survivor, unsigned int& seed
+	step_size_t &step_size, int &offset,
+	MyComplex x_survivor[CFG::Survivors][CFG::Nt], r_norm_t r_norm_survivor[CFG::Survivors], int &n_survivor,
+	unsigned int& seed, unsigned int& gauss_seed
 );
+template<class CFG>
 void comparison_r(
 	/*静态量*/
-	r_norm_t r_norm_survivor_1, r_norm_t r_norm_survivor_2, 
-	r_norm_t r_norm_survivor_3, r_norm_t r_norm_survivor_4,
-	// r_norm_t r_norm_survivor_5, r_norm_t r_norm_survivor_6,
-	// r_norm_t r_norm_survivor_7, r_norm_t r_norm_survivor_8,
-	MyComplex x_survivor[Ntr_1], MyComplex x_survivor_2[Ntr_1], 
-	MyComplex x_survivor_3[Ntr_1], MyComplex x_survivor_4[Ntr_1],
-	// MyComplex x_survivor_5[Ntr_1], MyComplex x_survivor_6[Ntr_1],
-	// MyComplex x_survivor_7[Ntr_1], MyComplex x_survivor_8[Ntr_1],
+	r_norm_t r_norm_survivor_all[CFG::Cands],
+	MyComplex x_survivor_all[CFG::Cands][CFG::Nt],
 	/*结果量*/
 	MyComplex* x_survivor_final
 );
 
 
+/*
+ * 流式函数均以配置CFG为模板参数，各采样器的流以数组形式传入（第k个元素对应第k+1个采样器，共CFG::Samplers个），
+ * 顶层用mhgd_cfg_default实例化。sampler_task每帧先输出Survivors个升序的r_norm，再按同样顺序输出各条目的Nt个符号。
+ */
+template<class CFG>
 void data_distribution(
+#ifdef PACKED_AXI
+    axi_word_t* H, axi_word_t* y,
+#else
     H_real_t* H_real, H_imag_t* H_imag,
     y_real_t* y_real, y_imag_t* y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
     v_real_t* v_tb_real, v_imag_t* v_tb_imag,
-	v_real_t* v_tb_real_2, v_imag_t* v_tb_imag_2,
-	v_real_t* v_tb_real_3, v_imag_t* v_tb_imag_3,
-	v_real_t* v_tb_real_4, v_imag_t* v_tb_imag_4,
-	// v_real_t* v_tb_real_5, v_imag_t* v_tb_imag_5,
-	// v_real_t* v_tb_real_6, v_imag_t* v_tb_imag_6,
-	// v_real_t* v_tb_real_7, v_imag_t* v_tb_imag_7,
-	// v_real_t* v_tb_real_8, v_imag_t* v_tb_imag_8,
-
-    hls::stream<H_real_t>& H_real_out1, hls::stream<H_imag_t>& H_imag_out1,
-    hls::stream<y_real_t>& y_real_out1, hls::stream<y_imag_t>& y_imag_out1,
-    hls::stream<v_real_t>& v_tb_real_out1, hls::stream<v_imag_t>& v_tb_imag_out1,
-    hls::stream<H_real_t>& H_real_out2, hls::stream<H_imag_t>& H_imag_out2,
-    hls::stream<y_real_t>& y_real_out2, hls::stream<y_imag_t>& y_imag_out2,
-    hls::stream<v_real_t>& v_tb_real_out2, hls::stream<v_imag_t>& v_tb_imag_out2,
-	
-	hls::stream<H_real_t>& H_real_out3, hls::stream<H_imag_t>& H_imag_out3,
-    hls::stream<y_real_t>& y_real_out3, hls::stream<y_imag_t>& y_imag_out3,
-    hls::stream<v_real_t>& v_tb_real_out3, hls::stream<v_imag_t>& v_tb_imag_out3,
-    hls::stream<H_real_t>& H_real_out4, hls::stream<H_imag_t>& H_imag_out4,
-    hls::stream<y_real_t>& y_real_out4, hls::stream<y_imag_t>& y_imag_out4,
-    hls::stream<v_real_t>& v_tb_real_out4, hls::stream<v_imag_t>& v_tb_imag_out4
-
-	// hls::stream<H_real_t>& H_real_out5, hls::stream<H_imag_t>& H_imag_out5,
-    // hls::stream<y_real_t>& y_real_out5, hls::stream<y_imag_t>& y_imag_out5,
-    // hls::stream<v_real_t>& v_tb_real_out5, hls::stream<v_imag_t>& v_tb_imag_out5,
-    // hls::stream<H_real_t>& H_real_out6, hls::stream<H_imag_t>& H_imag_out6,
-    // hls::stream<y_real_t>& y_real_out6, hls::stream<y_imag_t>& y_imag_out6,
-    // hls::stream<v_real_t>& v_tb_real_out6, hls::stream<v_imag_t>& v_tb_imag_out6,
-
-	// hls::stream<H_real_t>& H_real_out7, hls::stream<H_imag_t>& H_imag_out7,
-    // hls::stream<y_real_t>& y_real_out7, hls::stream<y_imag_t>& y_imag_out7,
-    // hls::stream<v_real_t>& v_tb_real_out7, hls::stream<v_imag_t>& v_tb_imag_out7,
-    // hls::stream<H_real_t>& H_real_out8, hls::stream<H_imag_t>& H_imag_out8,
-    // hls::stream<y_real_t>& y_real_out8, hls::stream<y_imag_t>& y_imag_out8,
-    // hls::stream<v_real_t>& v_tb_real_out8, hls::stream<v_imag_t>& v_tb_imag_out8
+#endif
+	float sigma2, unsigned int* seeds,
+
+	hls::stream<H_real_t>& H_real_out0, hls::stream<H_imag_t>& H_imag_out0,
+	hls::stream<float>& sigma2_out0,
+    hls::stream<H_real_t> H_real_out[CFG::Samplers], hls::stream<H_imag_t> H_imag_out[CFG::Samplers],
+    hls::stream<y_real_t> y_real_out[CFG::Samplers], hls::stream<y_imag_t> y_imag_out[CFG::Samplers],
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t> v_tb_real_out[CFG::Samplers], hls::stream<v_imag_t> v_tb_imag_out[CFG::Samplers],
+#endif
+	hls::stream<float> sigma2_out[CFG::Samplers], hls::stream<unsigned int> seed_out[CFG::Samplers]
+	PROF_PARAM
 );
+template<class CFG>
 void comparison_r_wrapper(
-    hls::stream<r_norm_t>& r_norm_in1,
-    hls::stream<r_norm_t>& r_norm_in2,
-	hls::stream<r_norm_t>& r_norm_in3,
-    hls::stream<r_norm_t>& r_norm_in4,
-	// hls::stream<r_norm_t>& r_norm_in5,
-    // hls::stream<r_norm_t>& r_norm_in6,
-	// hls::stream<r_norm_t>& r_norm_in7,
-    // hls::stream<r_norm_t>& r_norm_in8,
-    hls::stream<Myreal>& x_real_in1,
-    hls::stream<Myimage>& x_imag_in1,
-    hls::stream<Myreal>& x_real_in2,
-    hls::stream<Myimage>& x_imag_in2,
-	hls::stream<Myreal>& x_real_in3,
-    hls::stream<Myimage>& x_imag_in3,
-    hls::stream<Myreal>& x_real_in4,
-    hls::stream<Myimage>& x_imag_in4,
-	// hls::stream<Myreal>& x_real_in5,
-    // hls::stream<Myimage>& x_imag_in5,
-    // hls::stream<Myreal>& x_real_in6,
-    // hls::stream<Myimage>& x_imag_in6,
-	// hls::stream<Myreal>& x_real_in7,
-    // hls::stream<Myimage>& x_imag_in7,
-    // hls::stream<Myreal>& x_real_in8,
-    // hls::stream<Myimage>& x_imag_in8,
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
     MyComplex* x_final
+    PROF_PARAM
+);
+#ifdef SOFT_OUTPUT
+/*
+ * 软输出比较：在comparison_r_wrapper的基础上，以各采样器survivor列表合并去重后的候选计算max-log LLR。
+ * llr[i*Mu + b]为第i个发射符号第b比特（比特顺序同QAM_Slicer_hw），LLR = ln(P(b=0)/P(b=1))
+ * ≈ (min_{b=1} r_norm - min_{b=0} r_norm) / sigma2，正值倾向0。
+ */
+template<class CFG>
+void comparison_llr_wrapper(
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
+    float sigma2, float llr_gain,
+    MyComplex* x_final, llr_t* llr
+    PROF_PARAM
 );
+#endif
+template<class CFG>
+void shared_data_cal(
+    hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
+    hls::stream<float>& sigma2_stream,
+	hls::stream<like_float> dqam_fifo[CFG::Samplers], hls::stream<like_float> alpha_fifo[CFG::Samplers],
+	hls::stream<Myreal> constellation_norm_real[CFG::Samplers], hls::stream<Myimage> constellation_norm_imag[CFG::Samplers],
+	hls::stream<grad_preconditioner_real_t> grad_preconditioner_real[CFG::Samplers], hls::stream<grad_preconditioner_imag_t> grad_preconditioner_imag[CFG::Samplers],
+	hls::stream<pmat_real_t> pmat_real[CFG::Samplers], hls::stream<pmat_imag_t> pmat_imag[CFG::Samplers]
+	PROF_PARAM
+);
+template<class CFG>
 void sampler_task(
     // 输入接口
     hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
     hls::stream<y_real_t>& y_real_stream, hls::stream<y_imag_t>& y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
     hls::stream<v_real_t>& v_tb_real_stream, hls::stream<v_imag_t>& v_tb_imag_stream,
-    float sigma2,
+#endif
+	hls::stream<like_float>& dqam_fifo, hls::stream<like_float>& alpha_fifo,
+	hls::stream<Myreal>& constellation_norm_real, hls::stream<Myimage>& constellation_norm_imag,
+	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real, hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag,
+	hls::stream<pmat_real_t>& pmat_real, hls::stream<pmat_imag_t>& pmat_imag,
+	hls::stream<float>& sigma2_stream, hls::stream<unsigned int>& seed_stream,
     int sampler_id,
-	unsigned seed_in,
     // 输出接口
     hls::stream<Myreal>& x_survivor_real, hls::stream<Myimage>& x_survivor_imag,
 	hls::stream<r_norm_t>& r_norm_survivor_out
+	PROF_PARAM
+);
+
+#ifndef PROFILE_STAGES
+template<class CFG>
+void data_distribution_batch(
+#ifdef PACKED_AXI
+    axi_word_t* H, axi_word_t* y,
+#else
+    H_real_t* H_real, H_imag_t* H_imag,
+    y_real_t* y_real, y_imag_t* y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float* sigma2, unsigned int* seeds, int frames,
+
+	hls::stream<H_real_t>& H_real_out0, hls::stream<H_imag_t>& H_imag_out0,
+	hls::stream<float>& sigma2_out0,
+    hls::stream<H_real_t> H_real_out[CFG::Samplers], hls::stream<H_imag_t> H_imag_out[CFG::Samplers],
+    hls::stream<y_real_t> y_real_out[CFG::Samplers], hls::stream<y_imag_t> y_imag_out[CFG::Samplers],
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t> v_tb_real_out[CFG::Samplers], hls::stream<v_imag_t> v_tb_imag_out[CFG::Samplers],
+#endif
+	hls::stream<float> sigma2_out[CFG::Samplers], hls::stream<unsigned int> seed_out[CFG::Samplers]
+);
+template<class CFG>
+void shared_data_cal_batch(
+    hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
+	hls::stream<float>& sigma2_stream, int frames,
+	hls::stream<like_float> dqam_fifo[CFG::Samplers], hls::stream<like_float> alpha_fifo[CFG::Samplers],
+	hls::stream<Myreal> constellation_norm_real[CFG::Samplers], hls::stream<Myimage> constellation_norm_imag[CFG::Samplers],
+	hls::stream<grad_preconditioner_real_t> grad_preconditioner_real[CFG::Samplers], hls::stream<grad_preconditioner_imag_t> grad_preconditioner_imag[CFG::Samplers],
+	hls::stream<pmat_real_t> pmat_real[CFG::Samplers], hls::stream<pmat_imag_t> pmat_imag[CFG::Samplers]
+);
+template<class CFG>
+void sampler_task_batch(
+    hls::stream<H_real_t>& H_real_stream, hls::stream<H_imag_t>& H_imag_stream,
+    hls::stream<y_real_t>& y_real_stream, hls::stream<y_imag_t>& y_imag_stream,
+#ifdef GAUSS_TABLE_MODE
+    hls::stream<v_real_t>& v_tb_real_stream, hls::stream<v_imag_t>& v_tb_imag_stream,
+#endif
+	hls::stream<like_float>& dqam_fifo, hls::stream<like_float>& alpha_fifo,
+	hls::stream<Myreal>& constellation_norm_real, hls::stream<Myimage>& constellation_norm_imag,
+	hls::stream<grad_preconditioner_real_t>& grad_preconditioner_real, hls::stream<grad_preconditioner_imag_t>& grad_preconditioner_imag,
+	hls::stream<pmat_real_t>& pmat_real, hls::stream<pmat_imag_t>& pmat_imag,
+	hls::stream<float>& sigma2_stream, hls::stream<unsigned int>& seed_stream,
+    int sampler_id, int frames,
+    hls::stream<Myreal>& x_survivor_real, hls::stream<Myimage>& x_survivor_imag,
+	hls::stream<r_norm_t>& r_norm_survivor_out
+);
+template<class CFG>
+void comparison_r_wrapper_batch(
+    hls::stream<r_norm_t> r_norm_in[CFG::Samplers],
+    hls::stream<Myreal> x_real_in[CFG::Samplers],
+    hls::stream<Myimage> x_imag_in[CFG::Samplers],
+	int frames,
+#ifdef PACKED_AXI
+    axi_word_t* x_hat
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag
+#endif
 );
+#endif
 
 
+/*
+ * 单帧顶层。seeds[k]为第k个采样器的种子（同时决定其片上高斯噪声序列）。
+ * GAUSS_TABLE_MODE下v_tb按采样器连续存放（第k个采样器的表位于v_tb_real + k*num_ran）。
+ * SOFT_OUTPUT下llr输出Ntr_1*mu_1个连续int8，布局与QAM_Slicer_hw的比特相同，量化增益为标量llr_gain（LSB/nat，
+ * 推荐值见mhgd_iface.h的mhgd_llr_gain）；批处理顶层仍只输出硬判决。
+ * PROFILE_STAGES下prof输出mhgd_prof_words(samplers)个32位字的分段计时记录。
+ * PACKED_AXI下x_hat/H/y各为一个ap_uint<512>端口，分别为x_words_1/H_words_1/y_words_1个字（格式见mhgd_axi_pack.h）。
+ */
 void MHGD_detect_accel_hw(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag, 
+    H_real_t* H_real, H_imag_t* H_imag, 
+    y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+#ifdef PROFILE_STAGES
+	, unsigned int* prof
+#endif
+);
+
+#ifndef PROFILE_STAGES
+/*
+ * 批处理顶层：一次调用检测frames帧。
+ * H/y/x_hat按帧连续存放（第f帧H位于H_real + f*Ntr_2），sigma2[f]为第f帧噪声方差，
+ * seeds[f*samplers + s]为第f帧第s个采样器的种子；GAUSS_TABLE_MODE下v_tb表（布局同单帧顶层）各帧共用。
+ * PACKED_AXI下每帧从新的字开始，第f帧H位于H + f*H_words_1（y、x_hat同理）。
+ * 结果与逐帧调用MHGD_detect_accel_hw（相同种子）逐位一致。
+ */
+void MHGD_detect_accel_hw_batch(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag, 
+    H_real_t* H_real, H_imag_t* H_imag, 
+    y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float* sigma2, unsigned int* seeds, int frames
+);
+#endif
+
+/*
+ * 以配置CFG实例化的检测主体，两个顶层即以mhgd_cfg_default调用它们并加上接口配置。
+ * H为Nr×Nt行主序、y为Nr、x_hat为Nt，种子与v_tb约定同上（每个采样器CFG::num_ran个高斯数）。
+ */
+template<class CFG>
+void MHGD_detect_accel_core(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
+    Myreal* x_hat_real, Myimage* x_hat_imag, 
+    H_real_t* H_real, H_imag_t* H_imag, 
+    y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+#ifdef PROFILE_STAGES
+	, unsigned int* prof
+#endif
+);
+#ifndef PROFILE_STAGES
+template<class CFG>
+void MHGD_detect_accel_batch_core(
+#ifdef PACKED_AXI
+    axi_word_t* x_hat, axi_word_t* H, axi_word_t* y,
+#else
     Myreal* x_hat_real, Myimage* x_hat_imag, 
     H_real_t* H_real, H_imag_t* H_imag, 
     y_real_t* y_real, y_imag_t* y_imag, 
+#endif
+#ifdef GAUSS_TABLE_MODE
     v_real_t* v_tb_real, v_imag_t* v_tb_imag,
-	v_real_t* v_tb_real_2, v_imag_t* v_tb_imag_2,
-	v_real_t* v_tb_real_3, v_imag_t* v_tb_imag_3,
-	v_real_t* v_tb_real_4, v_imag_t* v_tb_imag_4,
-	//v_real_t* v_tb_real_5, v_imag_t* v_tb_imag_5,
-	//v_real_t* v_tb_real_6, v_imag_t* v_tb_imag_6,
-	//v_real_t* v_tb_real_7, v_imag_t* v_tb_imag_7,
-	//v_real_t* v_tb_real_8, v_imag_t* v_tb_imag_8,
-	float sigma2, 
-	unsigned int seed_1, unsigned int seed_2, unsigned int seed_3, unsigned int seed_4 //unsigned int seed_5, unsigned int seed_6, unsigned int seed_7, unsigned int seed_8
+#endif
+	float* sigma2, unsigned int* seeds, int frames
 );
+#endif
 
 
 /////////////////////////////////////////////////////////////////////////////
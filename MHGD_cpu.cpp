@@ -0,0 +1,650 @@
+#include "MHGD_cpu.h"
+#include "qam_slicer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MHGD_CPU_X86 1
+#include <immintrin.h>
+#endif
+
+/**********************************************************************************/
+/***********************************标量实现***************************************/
+/**********************************************************************************/
+/*y[i0..n)部分，供向量实现处理尾部*/
+static void cgemv_rows(int i0, int n, int m, const float* A_re, const float* A_im, int lda, int conj,
+                       const float* x_re, const float* x_im, float* y_re, float* y_im)
+{
+	const float s = conj ? -1.0f : 1.0f;
+	for (int i = i0; i < n; i++) {
+		float acc_re = 0, acc_im = 0;
+		for (int k = 0; k < m; k++) {
+			float a_re = A_re[k * lda + i];
+			float a_im = s * A_im[k * lda + i];
+			acc_re += a_re * x_re[k] - a_im * x_im[k];
+			acc_im += a_re * x_im[k] + a_im * x_re[k];
+		}
+		y_re[i] = acc_re;
+		y_im[i] = acc_im;
+	}
+}
+static void cgemv_scalar(int n, int m, const float* A_re, const float* A_im, int lda, int conj,
+                         const float* x_re, const float* x_im, float* y_re, float* y_im)
+{
+	cgemv_rows(0, n, m, A_re, A_im, lda, conj, x_re, x_im, y_re, y_im);
+}
+static float cnorm2_scalar(int n, const float* a_re, const float* a_im)
+{
+	float s = 0;
+	for (int i = 0; i < n; i++)
+		s += a_re[i] * a_re[i] + a_im[i] * a_im[i];
+	return s;
+}
+static float cdot_re_scalar(int n, const float* a_re, const float* a_im, const float* b_re, const float* b_im)
+{
+	float s = 0;
+	for (int i = 0; i < n; i++)
+		s += a_re[i] * b_re[i] + a_im[i] * b_im[i];
+	return s;
+}
+static int argmin_scalar(int n, const float* a)
+{
+	int best = 0;
+	for (int i = 1; i < n; i++)
+		if (a[i] < a[best])
+			best = i;
+	return best;
+}
+
+#ifdef MHGD_CPU_X86
+/**********************************************************************************/
+/************************************AVX2+FMA**************************************/
+/**********************************************************************************/
+/*
+ * 以下函数通过target属性单独开启AVX2/AVX-512，调用方仍是SSE代码；编译器不会自动在返回前插入vzeroupper，
+ * 返回前须手动清零ymm/zmm高位，否则回到SSE代码后每条指令都付出状态切换代价（实测慢一个数量级）。
+ */
+/*按8行一组累加各列，x[k]广播；列主序存放使每列连续*/
+__attribute__((target("avx2,fma")))
+static void cgemv_avx2(int n, int m, const float* A_re, const float* A_im, int lda, int conj,
+                       const float* x_re, const float* x_im, float* y_re, float* y_im)
+{
+	const __m256 sgn = _mm256_set1_ps(conj ? -1.0f : 1.0f);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256 acc_re = _mm256_setzero_ps(), acc_im = _mm256_setzero_ps();
+		for (int k = 0; k < m; k++) {
+			__m256 a_re = _mm256_loadu_ps(A_re + k * lda + i);
+			__m256 a_im = _mm256_mul_ps(sgn, _mm256_loadu_ps(A_im + k * lda + i));
+			__m256 b_re = _mm256_set1_ps(x_re[k]);
+			__m256 b_im = _mm256_set1_ps(x_im[k]);
+			acc_re = _mm256_fmadd_ps(a_re, b_re, acc_re);
+			acc_re = _mm256_fnmadd_ps(a_im, b_im, acc_re);
+			acc_im = _mm256_fmadd_ps(a_re, b_im, acc_im);
+			acc_im = _mm256_fmadd_ps(a_im, b_re, acc_im);
+		}
+		_mm256_storeu_ps(y_re + i, acc_re);
+		_mm256_storeu_ps(y_im + i, acc_im);
+	}
+	_mm256_zeroupper();
+	cgemv_rows(i, n, m, A_re, A_im, lda, conj, x_re, x_im, y_re, y_im);
+}
+__attribute__((target("avx2,fma")))
+static float hsum_avx2(__m256 v)
+{
+	__m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+	return _mm_cvtss_f32(s);
+}
+__attribute__((target("avx2,fma")))
+static float cnorm2_avx2(int n, const float* a_re, const float* a_im)
+{
+	__m256 acc = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256 r = _mm256_loadu_ps(a_re + i), m = _mm256_loadu_ps(a_im + i);
+		acc = _mm256_fmadd_ps(r, r, acc);
+		acc = _mm256_fmadd_ps(m, m, acc);
+	}
+	float s = hsum_avx2(acc);
+	_mm256_zeroupper();
+	return s + cnorm2_scalar(n - i, a_re + i, a_im + i);
+}
+__attribute__((target("avx2,fma")))
+static float cdot_re_avx2(int n, const float* a_re, const float* a_im, const float* b_re, const float* b_im)
+{
+	__m256 acc = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		acc = _mm256_fmadd_ps(_mm256_loadu_ps(a_re + i), _mm256_loadu_ps(b_re + i), acc);
+		acc = _mm256_fmadd_ps(_mm256_loadu_ps(a_im + i), _mm256_loadu_ps(b_im + i), acc);
+	}
+	float s = hsum_avx2(acc);
+	_mm256_zeroupper();
+	return s + cdot_re_scalar(n - i, a_re + i, a_im + i, b_re + i, b_im + i);
+}
+__attribute__((target("avx2,fma")))
+static float hmin_avx2(__m256 v)
+{
+	__m128 m4 = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+	m4 = _mm_min_ps(m4, _mm_movehl_ps(m4, m4));
+	m4 = _mm_min_ss(m4, _mm_shuffle_ps(m4, m4, 1));
+	return _mm_cvtss_f32(m4);
+}
+/*先求最小值，再取第一个等于最小值的下标*/
+__attribute__((target("avx2,fma")))
+static int argmin_avx2(int n, const float* a)
+{
+	if (n < 8)
+		return argmin_scalar(n, a);
+	__m256 mn = _mm256_loadu_ps(a);
+	int i = 8;
+	for (; i + 8 <= n; i += 8)
+		mn = _mm256_min_ps(mn, _mm256_loadu_ps(a + i));
+	float v = hmin_avx2(mn);
+	for (; i < n; i++)
+		v = a[i] < v ? a[i] : v;
+	const __m256 vb = _mm256_set1_ps(v);
+	for (i = 0; i + 8 <= n; i += 8) {
+		int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(a + i), vb, _CMP_EQ_OQ));
+		if (mask) {
+			_mm256_zeroupper();
+			return i + __builtin_ctz(mask);
+		}
+	}
+	_mm256_zeroupper();
+	for (; i < n; i++)
+		if (a[i] == v)
+			return i;
+	return 0;
+}
+
+/**********************************************************************************/
+/*************************************AVX-512**************************************/
+/**********************************************************************************/
+/*
+ * 512位寄存器的低/高256位。不用_mm512_reduce_add_ps/_mm512_reduce_min_ps、_mm512_castps512_ps256及不带掩码的
+ * _mm512_extractf64x4_pd：GCC 12中它们都以_mm256_undefined_pd()作直通源，-Wall下报-Wuninitialized/-Wmaybe-uninitialized；
+ * 全1掩码的maskz形式生成同一条vextractf64x4，且只需AVX-512F（_mm512_extractf32x8_ps需AVX-512DQ）
+ */
+template<int HI>
+__attribute__((target("avx512f")))
+static __m256 half256_avx512(__m512 v)
+{
+	return _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd((__mmask8)0xFF, _mm512_castps_pd(v), HI));
+}
+/*两个256位半部相加/取最小后，复用AVX2的水平归约*/
+__attribute__((target("avx512f")))
+static float hsum_avx512(__m512 v)
+{
+	return hsum_avx2(_mm256_add_ps(half256_avx512<0>(v), half256_avx512<1>(v)));
+}
+__attribute__((target("avx512f")))
+static float hmin_avx512(__m512 v)
+{
+	return hmin_avx2(_mm256_min_ps(half256_avx512<0>(v), half256_avx512<1>(v)));
+}
+/*16行一组，尾部用掩码读写，n<=16时（如8×8）单次完成*/
+__attribute__((target("avx512f")))
+static void cgemv_avx512(int n, int m, const float* A_re, const float* A_im, int lda, int conj,
+                         const float* x_re, const float* x_im, float* y_re, float* y_im)
+{
+	const __m512 sgn = _mm512_set1_ps(conj ? -1.0f : 1.0f);
+	for (int i = 0; i < n; i += 16) {
+		const __mmask16 msk = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+		__m512 acc_re = _mm512_setzero_ps(), acc_im = _mm512_setzero_ps();
+		for (int k = 0; k < m; k++) {
+			__m512 a_re = _mm512_maskz_loadu_ps(msk, A_re + k * lda + i);
+			__m512 a_im = _mm512_mul_ps(sgn, _mm512_maskz_loadu_ps(msk, A_im + k * lda + i));
+			__m512 b_re = _mm512_set1_ps(x_re[k]);
+			__m512 b_im = _mm512_set1_ps(x_im[k]);
+			acc_re = _mm512_fmadd_ps(a_re, b_re, acc_re);
+			acc_re = _mm512_fnmadd_ps(a_im, b_im, acc_re);
+			acc_im = _mm512_fmadd_ps(a_re, b_im, acc_im);
+			acc_im = _mm512_fmadd_ps(a_im, b_re, acc_im);
+		}
+		_mm512_mask_storeu_ps(y_re + i, msk, acc_re);
+		_mm512_mask_storeu_ps(y_im + i, msk, acc_im);
+	}
+	_mm256_zeroupper();
+}
+__attribute__((target("avx512f")))
+static float cnorm2_avx512(int n, const float* a_re, const float* a_im)
+{
+	__m512 acc = _mm512_setzero_ps();
+	for (int i = 0; i < n; i += 16) {
+		const __mmask16 msk = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+		__m512 r = _mm512_maskz_loadu_ps(msk, a_re + i), m = _mm512_maskz_loadu_ps(msk, a_im + i);
+		acc = _mm512_fmadd_ps(r, r, acc);
+		acc = _mm512_fmadd_ps(m, m, acc);
+	}
+	float s = hsum_avx512(acc);
+	_mm256_zeroupper();
+	return s;
+}
+__attribute__((target("avx512f")))
+static float cdot_re_avx512(int n, const float* a_re, const float* a_im, const float* b_re, const float* b_im)
+{
+	__m512 acc = _mm512_setzero_ps();
+	for (int i = 0; i < n; i += 16) {
+		const __mmask16 msk = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+		acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(msk, a_re + i), _mm512_maskz_loadu_ps(msk, b_re + i), acc);
+		acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(msk, a_im + i), _mm512_maskz_loadu_ps(msk, b_im + i), acc);
+	}
+	float s = hsum_avx512(acc);
+	_mm256_zeroupper();
+	return s;
+}
+__attribute__((target("avx512f")))
+static int argmin_avx512(int n, const float* a)
+{
+	__m512 mn = _mm512_set1_ps(INFINITY);
+	for (int i = 0; i < n; i += 16) {
+		const __mmask16 msk = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+		mn = _mm512_mask_min_ps(mn, msk, mn, _mm512_maskz_loadu_ps(msk, a + i));
+	}
+	const __m512 vb = _mm512_set1_ps(hmin_avx512(mn));
+	for (int i = 0; i < n; i += 16) {
+		const __mmask16 msk = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+		__mmask16 eq = _mm512_mask_cmp_ps_mask(msk, _mm512_maskz_loadu_ps(msk, a + i), vb, _CMP_EQ_OQ);
+		if (eq) {
+			_mm256_zeroupper();
+			return i + __builtin_ctz((unsigned)eq);
+		}
+	}
+	_mm256_zeroupper();
+	return 0;
+}
+#endif
+
+static const mhgd_cpu_kernels kernels_scalar = { "scalar", cgemv_scalar, cnorm2_scalar, cdot_re_scalar, argmin_scalar };
+#ifdef MHGD_CPU_X86
+static const mhgd_cpu_kernels kernels_avx2 = { "avx2", cgemv_avx2, cnorm2_avx2, cdot_re_avx2, argmin_avx2 };
+static const mhgd_cpu_kernels kernels_avx512 = { "avx512", cgemv_avx512, cnorm2_avx512, cdot_re_avx512, argmin_avx512 };
+#endif
+
+static const mhgd_cpu_kernels* kernels_select()
+{
+	const char* want = getenv("MHGD_CPU_ISA");
+#ifdef MHGD_CPU_X86
+	__builtin_cpu_init();
+	const bool has_avx512 = __builtin_cpu_supports("avx512f");
+	const bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	if (want && strcmp(want, "scalar") == 0)
+		return &kernels_scalar;
+	if (want && strcmp(want, "avx2") == 0 && has_avx2)
+		return &kernels_avx2;
+	if (has_avx512)
+		return &kernels_avx512;
+	if (has_avx2)
+		return &kernels_avx2;
+#endif
+	(void)want;
+	return &kernels_scalar;
+}
+const mhgd_cpu_kernels& mhgd_cpu_kernels_get()
+{
+	static const mhgd_cpu_kernels* k = kernels_select();
+	return *k;
+}
+
+/**********************************************************************************/
+/***********************************检测主体***************************************/
+/**********************************************************************************/
+/*与lcg_rand_1_hw_fixed相同的均匀数：31位LCG输出左移1位作为32位小数*/
+static inline float lcg_uniform(unsigned int& seed)
+{
+	unsigned int r = lcg_rand_hw_opt(seed) << 1;
+	return (float)r * (1.0f / 4294967296.0f);
+}
+/*与gauss_rand_hw相同的Box-Muller，实虚部方差各1/2*/
+static inline void gauss_rand_cpu(unsigned int& seed, float& v_re, float& v_im)
+{
+	float u1 = 1.0f - lcg_uniform(seed);
+	float u2 = lcg_uniform(seed);
+	float mag = sqrtf(-logf(u1));
+	float theta = u2 * (float)(2 * M_PI);
+	v_re = mag * cosf(theta);
+	v_im = mag * sinf(theta);
+}
+/*与map_hw相同：按2*dqam间隔取整到奇数格点，限幅到±amp_max后乘dqam*/
+static inline float map_axis(float z, float dqam, float amp_max)
+{
+	float v = 2.0f * floorf(z / (2.0f * dqam)) + 1.0f;
+	v = v > amp_max ? amp_max : v;
+	v = v < -amp_max ? -amp_max : v;
+	return v * dqam;
+}
+/*Hermitian正定矩阵求逆（Cholesky，双精度），A、Ainv均为n×n行主序*/
+static void chol_inverse(int n, const float* A_re, const float* A_im, float* inv_re, float* inv_im)
+{
+	double L_re[16 * 16], L_im[16 * 16];/*n <= 16*/
+	memset(L_re, 0, sizeof(L_re));
+	memset(L_im, 0, sizeof(L_im));
+	for (int j = 0; j < n; j++) {
+		double d = A_re[j * n + j];
+		for (int k = 0; k < j; k++)
+			d -= L_re[j * n + k] * L_re[j * n + k] + L_im[j * n + k] * L_im[j * n + k];
+		d = sqrt(d);
+		L_re[j * n + j] = d;
+		for (int i = j + 1; i < n; i++) {
+			/*L[i][j] = (A[i][j] - sum_k L[i][k]*conj(L[j][k])) / d*/
+			double s_re = A_re[i * n + j], s_im = A_im[i * n + j];
+			for (int k = 0; k < j; k++) {
+				s_re -= L_re[i * n + k] * L_re[j * n + k] + L_im[i * n + k] * L_im[j * n + k];
+				s_im -= L_im[i * n + k] * L_re[j * n + k] - L_re[i * n + k] * L_im[j * n + k];
+			}
+			L_re[i * n + j] = s_re / d;
+			L_im[i * n + j] = s_im / d;
+		}
+	}
+	/*逐列解 L L^H x = e_c*/
+	for (int c = 0; c < n; c++) {
+		double z_re[16], z_im[16];
+		for (int i = 0; i < n; i++) {
+			double s_re = (i == c) ? 1.0 : 0.0, s_im = 0;
+			for (int k = 0; k < i; k++) {
+				s_re -= L_re[i * n + k] * z_re[k] - L_im[i * n + k] * z_im[k];
+				s_im -= L_re[i * n + k] * z_im[k] + L_im[i * n + k] * z_re[k];
+			}
+			z_re[i] = s_re / L_re[i * n + i];
+			z_im[i] = s_im / L_re[i * n + i];
+		}
+		for (int i = n - 1; i >= 0; i--) {
+			/*L^H[i][k] = conj(L[k][i])*/
+			double s_re = z_re[i], s_im = z_im[i];
+			for (int k = i + 1; k < n; k++) {
+				s_re -= L_re[k * n + i] * z_re[k] + L_im[k * n + i] * z_im[k];
+				s_im -= L_re[k * n + i] * z_im[k] - L_im[k * n + i] * z_re[k];
+			}
+			z_re[i] = s_re / L_re[i * n + i];
+			z_im[i] = s_im / L_re[i * n + i];
+		}
+		for (int i = 0; i < n; i++) {
+			inv_re[i * n + c] = (float)z_re[i];
+			inv_im[i * n + c] = (float)z_im[i];
+		}
+	}
+}
+
+template<class CFG>
+void MHGD_detect_cpu_core(
+    Myreal* x_hat_real, Myimage* x_hat_imag,
+    H_real_t* H_real, H_imag_t* H_imag,
+    y_real_t* y_real, y_imag_t* y_imag,
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+){
+	static_assert(CFG::Nt <= 16, "chol_inverse supports Nt <= 16");
+	const int Nt = CFG::Nt, Nr = CFG::Nr, M = CFG::M;
+	const mhgd_cpu_kernels& K = mhgd_cpu_kernels_get();
+	/*H按行主序（列k = H第k行，用于H^H*r）与列主序（列k = H第k列，用于H*x）各存一份*/
+	float Hr_re[Nr * Nt], Hr_im[Nr * Nt], Hc_re[Nt * Nr], Hc_im[Nt * Nr];
+	float y_re[Nr], y_im[Nr];
+	for (int i = 0; i < Nr; i++) {
+		for (int j = 0; j < Nt; j++) {
+			Hr_re[i * Nt + j] = Hc_re[j * Nr + i] = (float)H_real[i * Nt + j];
+			Hr_im[i * Nt + j] = Hc_im[j * Nr + i] = (float)H_imag[i * Nt + j];
+		}
+		y_re[i] = (float)y_real[i];
+		y_im[i] = (float)y_imag[i];
+	}
+
+	/*********************************共享量（shared_data_cal）************************************/
+	const float dqam = sqrtf(1.5f / (float)(M - 1));
+	const float alpha = 1.0f / cbrtf((float)Nt / 8.0f);
+	const float amp_max = (float)qam_traits<CFG::Mu>::amp_max;
+	float cn_re[M], cn_im[M];
+	for (int i = 0; i < M; i++) {
+		cn_re[i] = (float)qam_traits<CFG::Mu>::table()[i].real * dqam;
+		cn_im[i] = (float)qam_traits<CFG::Mu>::table()[i].imag * dqam;
+	}
+	/*G = H^H*H，按列计算：G[:,j] = H^H * H[:,j]*/
+	float G_re[Nt * Nt], G_im[Nt * Nt], col_re[Nt], col_im[Nt];
+	for (int j = 0; j < Nt; j++) {
+		K.cgemv(Nt, Nr, Hr_re, Hr_im, Nt, 1, Hc_re + j * Nr, Hc_im + j * Nr, col_re, col_im);
+		for (int i = 0; i < Nt; i++) {
+			G_re[i * Nt + j] = col_re[i];
+			G_im[i * Nt + j] = col_im[i];
+		}
+	}
+	/*grad_preconditioner P = (H^H*H + sigma2/dqam^2 * I)^-1；P为Hermitian，行主序即共轭列主序，这里显式转为列主序*/
+	float A_re[Nt * Nt], A_im[Nt * Nt], P_re[Nt * Nt], P_im[Nt * Nt], Pc_re[Nt * Nt], Pc_im[Nt * Nt];
+	memcpy(A_re, G_re, sizeof(A_re));
+	memcpy(A_im, G_im, sizeof(A_im));
+	for (int i = 0; i < Nt; i++)
+		A_re[i * Nt + i] += sigma2 / (dqam * dqam);
+	chol_inverse(Nt, A_re, A_im, P_re, P_im);
+	for (int i = 0; i < Nt; i++)
+		for (int j = 0; j < Nt; j++) {
+			Pc_re[j * Nt + i] = P_re[i * Nt + j];
+			Pc_im[j * Nt + i] = P_im[i * Nt + j];
+		}
+	/*pmat = H*P*H^H（Nr×Nr，列主序）：T = H*P，pmat[:,l] = T * conj(H[l,:])*/
+	float Tc_re[Nt * Nr], Tc_im[Nt * Nr], pc_re[Nr * Nr], pc_im[Nr * Nr];
+	if (!lr_approx_1) {
+		for (int j = 0; j < Nt; j++)
+			K.cgemv(Nr, Nt, Hc_re, Hc_im, Nr, 0, Pc_re + j * Nt, Pc_im + j * Nt, Tc_re + j * Nr, Tc_im + j * Nr);
+		for (int l = 0; l < Nr; l++) {
+			float hc_re[Nt], hc_im[Nt];
+			for (int j = 0; j < Nt; j++) {
+				hc_re[j] = Hr_re[l * Nt + j];
+				hc_im[j] = -Hr_im[l * Nt + j];
+			}
+			K.cgemv(Nr, Nt, Tc_re, Tc_im, Nr, 0, hc_re, hc_im, pc_re + l * Nr, pc_im + l * Nr);
+		}
+	}
+	/*MMSE初始值（mmse_init_1时）：x_mmse = (H^H*H + sigma2*I)^-1 * H^H*y，各采样器相同*/
+	float xm_re[Nt], xm_im[Nt];
+	if (mmse_init_1) {
+		float W_re[Nt * Nt], W_im[Nt * Nt], hy_re[Nt], hy_im[Nt];
+		memcpy(A_re, G_re, sizeof(A_re));
+		memcpy(A_im, G_im, sizeof(A_im));
+		for (int i = 0; i < Nt; i++)
+			A_re[i * Nt + i] += sigma2;
+		chol_inverse(Nt, A_re, A_im, W_re, W_im);
+		K.cgemv(Nt, Nr, Hr_re, Hr_im, Nt, 1, y_re, y_im, hy_re, hy_im);
+		for (int i = 0; i < Nt; i++) {
+			float s_re = 0, s_im = 0;
+			for (int j = 0; j < Nt; j++) {
+				s_re += W_re[i * Nt + j] * hy_re[j] - W_im[i * Nt + j] * hy_im[j];
+				s_im += W_re[i * Nt + j] * hy_im[j] + W_im[i * Nt + j] * hy_re[j];
+			}
+			xm_re[i] = map_axis(s_re, dqam, amp_max);
+			xm_im[i] = map_axis(s_im, dqam, amp_max);
+		}
+	}
+
+	/*********************************各采样器（sampler_task）************************************/
+	/*采样器s的survivor列表（survivor_insert_hw）位于s*Survivors起，按r_norm升序*/
+	const int SK = CFG::Survivors;
+	float surv_norm[CFG::Cands];
+	float surv_re[CFG::Cands][Nt], surv_im[CFG::Cands][Nt];
+	for (int s = 0; s < CFG::Samplers; s++) {
+		unsigned int seed = seeds[s];
+#ifdef GAUSS_TABLE_MODE
+		int offset = 0;
+#else
+		unsigned int gauss_seed = seed ^ GAUSS_SEED_MIX;
+#endif
+		float x_re[Nt], x_im[Nt], r_re[Nr], r_im[Nr], t_re[Nr], t_im[Nr], pr_re[Nr], pr_im[Nr];
+		float g_re[Nt], g_im[Nt], xp_re[Nt], xp_im[Nt], rp_re[Nr], rp_im[Nr];
+		/*x的初始化*/
+		for (int i = 0; i < Nt; i++) {
+			if (mmse_init_1) {
+				x_re[i] = xm_re[i];
+				x_im[i] = xm_im[i];
+			} else {
+				int idx = (lcg_rand_hw_opt(seed) >> (31 - CFG::Mu)) & (M - 1);
+				x_re[i] = cn_re[idx];
+				x_im[i] = cn_im[idx];
+			}
+		}
+		/*r = y - H*x*/
+		K.cgemv(Nr, Nt, Hc_re, Hc_im, Nr, 0, x_re, x_im, t_re, t_im);
+		for (int i = 0; i < Nr; i++) {
+			r_re[i] = y_re[i] - t_re[i];
+			r_im[i] = y_im[i] - t_im[i];
+		}
+		float r_norm = K.cnorm2(Nr, r_re, r_im);
+		float* l_norm = surv_norm + s * SK;
+		float (*l_re)[Nt] = surv_re + s * SK, (*l_im)[Nt] = surv_im + s * SK;
+		int n_surv = 1;
+		l_norm[0] = r_norm;
+		memcpy(l_re[0], x_re, sizeof(x_re));
+		memcpy(l_im[0], x_im, sizeof(x_im));
+		/*学习率与步长*/
+		float lr;
+		if (!lr_approx_1) {
+			K.cgemv(Nr, Nr, pc_re, pc_im, Nr, 0, r_re, r_im, pr_re, pr_im);
+			lr = K.cdot_re(Nr, r_re, r_im, pr_re, pr_im) / K.cnorm2(Nr, pr_re, pr_im);
+		} else {
+			lr = (s + 1) * 0.5f;
+		}
+		float step_size = fmaxf(dqam, sqrtf(r_norm / Nr)) * alpha;
+
+		for (int k = 0; k < CFG::Iters; k++) {
+			/*z_grad = x + lr * P*(H^H*r)*/
+			K.cgemv(Nt, Nr, Hr_re, Hr_im, Nt, 1, r_re, r_im, t_re, t_im);
+			K.cgemv(Nt, Nt, Pc_re, Pc_im, Nt, 0, t_re, t_im, g_re, g_im);
+			/*加随机游走噪声并映射到星座点*/
+			for (int i = 0; i < Nt; i++) {
+				float v_re, v_im;
+#ifdef GAUSS_TABLE_MODE
+				v_re = (float)v_tb_real[s * CFG::num_ran + offset + i];
+				v_im = (float)v_tb_imag[s * CFG::num_ran + offset + i];
+#else
+				gauss_rand_cpu(gauss_seed, v_re, v_im);
+#endif
+				xp_re[i] = map_axis(x_re[i] + lr * g_re[i] + step_size * v_re, dqam, amp_max);
+				xp_im[i] = map_axis(x_im[i] + lr * g_im[i] + step_size * v_im, dqam, amp_max);
+			}
+#ifdef GAUSS_TABLE_MODE
+			offset = (offset > (CFG::num_ran - Nt)) ? 0 : (offset + Nt);
+#endif
+			/*浮点下每次整体重算残差*/
+			K.cgemv(Nr, Nt, Hc_re, Hc_im, Nr, 0, xp_re, xp_im, rp_re, rp_im);
+			for (int i = 0; i < Nr; i++) {
+				rp_re[i] = y_re[i] - rp_re[i];
+				rp_im[i] = y_im[i] - rp_im[i];
+			}
+			float r_norm_prop = K.cnorm2(Nr, rp_re, rp_im);
+			/*survivor列表插入：重复条目只在更优时更新，否则未满插入、已满时替换更差的末位*/
+			int p = (n_surv < SK) ? n_surv : SK - 1;
+			bool hit = false;
+			for (int j = 0; j < n_surv && !hit; j++) {
+				if (!memcmp(l_re[j], xp_re, sizeof(xp_re)) && !memcmp(l_im[j], xp_im, sizeof(xp_im))) {
+					p = j;
+					hit = true;
+				}
+			}
+			if ((!hit && n_surv < SK) || r_norm_prop < l_norm[p]) {
+				if (!hit && n_surv < SK)
+					n_surv++;
+				/*移除p，再把提案插在所有r_norm不大于它的条目之后*/
+				for (int j = p; j + 1 < n_surv; j++) {
+					l_norm[j] = l_norm[j + 1];
+					memcpy(l_re[j], l_re[j + 1], sizeof(xp_re));
+					memcpy(l_im[j], l_im[j + 1], sizeof(xp_im));
+				}
+				int q = n_surv - 1;
+				for (; q > 0 && l_norm[q - 1] > r_norm_prop; q--) {
+					l_norm[q] = l_norm[q - 1];
+					memcpy(l_re[q], l_re[q - 1], sizeof(xp_re));
+					memcpy(l_im[q], l_im[q - 1], sizeof(xp_im));
+				}
+				l_norm[q] = r_norm_prop;
+				memcpy(l_re[q], xp_re, sizeof(xp_re));
+				memcpy(l_im[q], xp_im, sizeof(xp_im));
+			}
+			/*接受判定：与generateUniformRandoms_float_hw_pro一致，每次迭代取10个均匀数、使用第6个*/
+			float p_acc = expf(fminf(0.0f, r_norm - r_norm_prop));
+			float p_uni = 0;
+			for (int u = 0; u < 10; u++) {
+				float t = lcg_uniform(seed);
+				if (u == 5)
+					p_uni = t;
+			}
+			if (p_acc > p_uni) {
+				memcpy(x_re, xp_re, sizeof(x_re));
+				memcpy(x_im, xp_im, sizeof(x_im));
+				memcpy(r_re, rp_re, sizeof(r_re));
+				memcpy(r_im, rp_im, sizeof(r_im));
+				r_norm = r_norm_prop;
+				if (!lr_approx_1) {
+					K.cgemv(Nr, Nr, pc_re, pc_im, Nr, 0, r_re, r_im, pr_re, pr_im);
+					lr = K.cdot_re(Nr, r_re, r_im, pr_re, pr_im) / K.cnorm2(Nr, pr_re, pr_im);
+				}
+				step_size = fmaxf(dqam, sqrtf(r_norm / Nr)) * alpha;
+			}
+		}
+		/*列表未满时以第0个补齐，与sampler_task的输出一致*/
+		for (int j = n_surv; j < SK; j++) {
+			l_norm[j] = l_norm[0];
+			memcpy(l_re[j], l_re[0], sizeof(x_re));
+			memcpy(l_im[j], l_im[0], sizeof(x_im));
+		}
+	}
+
+	/*********************************采样器结果比较（comparison_r）************************************/
+	const int choice = K.argmin(CFG::Cands, surv_norm);
+	for (int i = 0; i < Nt; i++) {
+		x_hat_real[i] = surv_re[choice][i];
+		x_hat_imag[i] = surv_im[choice][i];
+	}
+#ifdef SOFT_OUTPUT
+	/*max-log LLR（llr_maxlog_hw）：候选为全部survivor列表，量化规则相同；重复候选不影响max-log结果，这里不去重*/
+	const int H = CFG::Mu / 2;
+	const float scale = llr_gain / sigma2;
+	for (int i = 0; i < Nt; i++) {
+		int gray[CFG::Cands];
+		for (int s = 0; s < CFG::Cands; s++) {
+			int k_re = qam_slicer_level<CFG::Mu>(surv_re[s][i], qam_slicer_traits<CFG::Mu>::tie_upper_re);
+			int k_im = qam_slicer_level<CFG::Mu>(surv_im[s][i], qam_slicer_traits<CFG::Mu>::tie_upper_im);
+			gray[s] = ((k_re ^ (k_re >> 1)) << H) | (k_im ^ (k_im >> 1));
+		}
+		for (int b = 0; b < CFG::Mu; b++) {
+			float d[2] = {INFINITY, INFINITY};
+			for (int s = 0; s < CFG::Cands; s++) {
+				int bit = (gray[s] >> (CFG::Mu - 1 - b)) & 1;
+				d[bit] = fminf(d[bit], surv_norm[s]);
+			}
+			float v = (d[1] - d[0]) * scale;/*缺少某一取值时为±inf，随后饱和*/
+			v = (v >= 0) ? v + 0.5f : v - 0.5f;
+			llr[i * CFG::Mu + b] = (int)fminf(fmaxf(v, -(float)LLR_MAX), (float)LLR_MAX);
+		}
+	}
+#endif
+}
+
+void MHGD_detect_cpu(
+    Myreal* x_hat_real, Myimage* x_hat_imag,
+    H_real_t* H_real, H_imag_t* H_imag,
+    y_real_t* y_real, y_imag_t* y_imag,
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+){
+	MHGD_detect_cpu_core<mhgd_cfg_default>(
+		x_hat_real, x_hat_imag,
+		H_real, H_imag,
+		y_real, y_imag,
+#ifdef GAUSS_TABLE_MODE
+		v_tb_real, v_tb_imag,
+#endif
+		sigma2, seeds
+#ifdef SOFT_OUTPUT
+		, llr, llr_gain
+#endif
+	);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "MHGD_accel_hw.h"
+
+/*
+ * MHGD的CPU原生实现（单精度浮点），接口与MHGD_detect_accel_hw相同，可作为无卡时的回退检测器，
+ * 也可作为快速参考模型与定点C仿真比对BER与吞吐。
+ * 算法流程与随机数序列与内核一致：x初始化、接受判定使用同一LCG序列，片上Box-Muller噪声以浮点重算；
+ * 差别只在运算精度（float对ap_fixed），以及残差每次迭代整体重算（不需要RESID_REFRESH限制误差累积）。
+ * 复数GEMV、范数、内积、argmin在启动时按CPU支持的指令集选择AVX-512 / AVX2+FMA / 标量实现。
+ */
+
+/*向量核函数表，所有复向量均为实部、虚部分开存放*/
+struct mhgd_cpu_kernels {
+	const char* isa;
+	/*y[0..n) = sum_k op(A[:,k]) * x[k]，k < m；第k列起始于A + k*lda，conj=1时取共轭*/
+	void (*cgemv)(int n, int m, const float* A_re, const float* A_im, int lda, int conj,
+	              const float* x_re, const float* x_im, float* y_re, float* y_im);
+	/*sum |a|^2*/
+	float (*cnorm2)(int n, const float* a_re, const float* a_im);
+	/*Re(a^H b)*/
+	float (*cdot_re)(int n, const float* a_re, const float* a_im, const float* b_re, const float* b_im);
+	/*最小值下标，相等时取下标小者*/
+	int (*argmin)(int n, const float* a);
+};
+/*首次调用时检测CPU并选择实现；设置环境变量MHGD_CPU_ISA=scalar/avx2/avx512可强制指定（不支持时回退）*/
+const mhgd_cpu_kernels& mhgd_cpu_kernels_get();
+
+template<class CFG>
+void MHGD_detect_cpu_core(
+    Myreal* x_hat_real, Myimage* x_hat_imag,
+    H_real_t* H_real, H_imag_t* H_imag,
+    y_real_t* y_real, y_imag_t* y_imag,
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+);
+void MHGD_detect_cpu(
+    Myreal* x_hat_real, Myimage* x_hat_imag,
+    H_real_t* H_real, H_imag_t* H_imag,
+    y_real_t* y_real, y_imag_t* y_imag,
+#ifdef GAUSS_TABLE_MODE
+    v_real_t* v_tb_real, v_imag_t* v_tb_imag,
+#endif
+	float sigma2, unsigned int* seeds
+#ifdef SOFT_OUTPUT
+	, llr_t* llr, float llr_gain
+#endif
+);
@@ -6,7 +6,12 @@
 
 //不同位宽精度的定点数类型
 
+// #define SENSITIVITY_ANALYSIS_MODE	// 打开后：下列各变量的位宽改由sensitivity_types.hpp提供（由sensitivity_types.hpp.jinja2渲染，sensitivity_sweep.py为每组候选位宽各生成一份，放在-I路径中），用于位宽灵敏度扫描
+
 /*优化后的数据类型*/
+#ifdef SENSITIVITY_ANALYSIS_MODE
+#include "sensitivity_types.hpp"
+#else
 // 变量: step_size
 typedef ap_fixed<18, 4> step_size_t;
 
@@ -57,30 +62,6 @@ typedef ap_fixed<20, 4> v_real_t;
 
 // 变量: v_imag
 typedef ap_fixed<20, 4> v_imag_t;
-typedef struct {
-    y_real_t real;  // 实部
-    y_imag_t imag;  // 虚部
-} MyComplex_y;
-typedef struct {
-    H_real_t real;  // 实部
-    H_imag_t imag;  // 虚部
-} MyComplex_H;
-typedef struct {
-    z_grad_real_t real;  // 实部
-    z_grad_imag_t imag;  // 虚部
-} MyComplex_z_grad;
-typedef struct {
-    z_prop_real_t real;  // 实部
-    z_prop_imag_t imag;  // 虚部
-} MyComplex_z_prop;
-typedef struct {
-    x_prop_real_t real;  // 实部
-    x_prop_imag_t imag;  // 虚部
-} MyComplex_x_prop;
-typedef struct {
-    v_real_t real;  // 实部
-    v_imag_t imag;  // 虚部
-} MyComplex_v;
 
 // 变量: HH_H_real
 typedef ap_fixed<24, 4> HH_H_real_t;
@@ -165,6 +146,38 @@ typedef ap_fixed<40, 8> local_temp_1_t;
 
 // 变量: local_temp_2
 typedef ap_fixed<40, 8> local_temp_2_t;
+#endif
+
+typedef struct {
+    y_real_t real;  // 实部
+    y_imag_t imag;  // 虚部
+} MyComplex_y;
+
+typedef struct {
+    H_real_t real;  // 实部
+    H_imag_t imag;  // 虚部
+} MyComplex_H;
+
+typedef struct {
+    z_grad_real_t real;  // 实部
+    z_grad_imag_t imag;  // 虚部
+} MyComplex_z_grad;
+
+typedef struct {
+    z_prop_real_t real;  // 实部
+    z_prop_imag_t imag;  // 虚部
+} MyComplex_z_prop;
+
+typedef struct {
+    x_prop_real_t real;  // 实部
+    x_prop_imag_t imag;  // 虚部
+} MyComplex_x_prop;
+
+typedef struct {
+    v_real_t real;  // 实部
+    v_imag_t imag;  // 虚部
+} MyComplex_v;
+
 typedef struct {
     HH_H_real_t real;  // 实部
     HH_H_imag_t imag;  // 虚部
@@ -231,9 +244,6 @@ typedef struct {
 } MyComplex_sigma2eye;
 
 
-// #define SENSITIVITY_ANALYSIS_MODE
-
-
 typedef ap_fixed<40,8>like_float;
 typedef ap_fixed<40,8>Myreal;
 typedef ap_fixed<40,8>Myimage;
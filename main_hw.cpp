@@ -1,5 +1,9 @@
 #include "MHGD_accel_hw.h"
 #include "MyComplex_1.h"
+#include "mhgd_dataset.h"
+#include "mhgd_seed.h"
+#include "mhgd_testref.h"
+#include "qam_slicer.h"
 #include "hls_math.h"
 #include <string.h>
 #include <stdio.h>
@@ -9,26 +13,327 @@
 #include <immintrin.h>  // AVX指令集
 #include <thread>
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 
-unsigned int generate_seed(int sampler_id) {
-    // 获取当前时间（秒级精度）
-    time_t now = time(0);
-    
-    // 获取高精度时间（纳秒级）
-    auto now_high_res = std::chrono::high_resolution_clock::now();
-    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        now_high_res.time_since_epoch()
-    ).count();
-    
-    // 混合多种时间源
-    unsigned int seed = static_cast<unsigned int>(now) ^ 
-                       static_cast<unsigned int>(nanos) ^ 
-                       (static_cast<unsigned int>(nanos >> 32)) ^
-                       (sampler_id * 0x9E3779B9);  // 黄金比例常数
-    return seed;
+// #define BATCH_VERIFY	// 打开后：逐帧检测结束时，用相同种子调用一次批处理接口并逐帧比对x_hat
+// #define CPU_VERIFY	// 打开后：每帧用相同输入与种子再调用一次CPU浮点检测器MHGD_detect_cpu（需同时编译MHGD_cpu.cpp），结束时对比两者的BER、符号一致率与帧率
+// #define DEMOD_VERIFY	// 打开后：C仿真开始时将slicer解调（QAM_Slicer_hw与主机批量qam_slicer_batch）与逐点距离搜索QAM_Demodulation_hw逐位比对，并比较速度
+#ifdef CPU_VERIFY
+#include "MHGD_cpu.h"
+#endif
+#if defined(PROFILE_STAGES) && defined(BATCH_VERIFY)
+#error "PROFILE_STAGES下不编译批处理顶层，不能同时打开BATCH_VERIFY"
+#endif
+
+#ifdef GEMM_VERIFY
+/*参考实现：逐项乘加，乘积在like_float下截断，与complex_multiply_hw一致*/
+template<int M, int K, int N, int CONJ_A, int CONJ_B, typename TA, typename TB, typename TC>
+void gemm_ref(const TA* A, const TB* B, TC* C)
+{
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < N; j++) {
+            like_float sum_real = 0, sum_imag = 0;
+            for (int l = 0; l < K; l++) {
+                TA a; TB b;
+                if (CONJ_A) { a.real = A[l * M + i].real; a.imag = -A[l * M + i].imag; }
+                else a = A[i * K + l];
+                if (CONJ_B) { b.real = B[j * K + l].real; b.imag = -B[j * K + l].imag; }
+                else b = B[l * N + j];
+                like_float t1 = a.real * b.real, t2 = a.imag * b.imag;
+                like_float t3 = a.real * b.imag, t4 = a.imag * b.real;
+                sum_real += t1 - t2;
+                sum_imag += t3 + t4;
+            }
+            C[i * N + j].real = sum_real;
+            C[i * N + j].imag = sum_imag;
+        }
+    }
 }
+template<int M, int K, int N, int CONJ_A, int CONJ_B, typename TA, typename TB, typename TC>
+int gemm_check(const char* name, const TA* A, const TB* B)
+{
+    TC c_sys[M * N], c_ref[M * N];
+    int mismatch = 0;
+    c_gemm_systolic_hw<M, K, N, CONJ_A, CONJ_B>(A, B, c_sys);
+    gemm_ref<M, K, N, CONJ_A, CONJ_B>(A, B, c_ref);
+    for (int i = 0; i < M * N; i++)
+        if (c_sys[i].real != c_ref[i].real || c_sys[i].imag != c_ref[i].imag)
+            mismatch++;
+    printf("GEMM_VERIFY %-12s %dx%dx%d: %d mismatched elements\n", name, M, K, N, mismatch);
+    return mismatch;
+}
+/*覆盖内核中的三处每帧矩阵乘（H^H*H、H*P、(H*P)*H^H）、一个非方阵双共轭的16阵元用例，以及只算下三角的Gram矩阵*/
+int gemm_verify(const MyComplex_H* H)
+{
+    std::mt19937 gen(2024);
+    std::uniform_real_distribution<float> uni(-1.0f, 1.0f);
+    MyComplex_grad_preconditioner P[Ntr_2];
+    MyComplex_temp_NtNr HP[Ntr_2];
+    static MyComplex A16[12 * 16], B16[16 * 12];
+    int mismatch = 0;
+    for (int i = 0; i < Ntr_2; i++) {
+        P[i].real = uni(gen);
+        P[i].imag = uni(gen);
+    }
+    for (int i = 0; i < 12 * 16; i++) {
+        A16[i].real = uni(gen); A16[i].imag = uni(gen);
+        B16[i].real = uni(gen); B16[i].imag = uni(gen);
+    }
+    mismatch += gemm_check<Ntr_1, Ntr_1, Ntr_1, 1, 0, MyComplex_H, MyComplex_H, MyComplex_HH>("H^H*H", H, H);
+    mismatch += gemm_check<Ntr_1, Ntr_1, Ntr_1, 0, 0, MyComplex_H, MyComplex_grad_preconditioner, MyComplex_temp_NtNr>("H*P", H, P);
+    gemm_ref<Ntr_1, Ntr_1, Ntr_1, 0, 0>(H, P, HP);
+    mismatch += gemm_check<Ntr_1, Ntr_1, Ntr_1, 0, 1, MyComplex_temp_NtNr, MyComplex_H, MyComplex_pmat>("(H*P)*H^H", HP, H);
+    mismatch += gemm_check<16, 12, 16, 1, 1, MyComplex, MyComplex, MyComplex>("A^H*B^H", A16, B16);
+    {
+        /*Gram矩阵只算下三角，MIRROR=1补齐后应与完整的H^H*H一致*/
+        MyComplex_HH G_gram[Ntr_2], G_ref[Ntr_2];
+        int gram_mismatch = 0;
+        c_gram_hw<Ntr_1, Ntr_1, 1>(H, G_gram);
+        gemm_ref<Ntr_1, Ntr_1, Ntr_1, 1, 0>(H, H, G_ref);
+        for (int i = 0; i < Ntr_2; i++)
+            if (G_gram[i].real != G_ref[i].real || G_gram[i].imag != G_ref[i].imag)
+                gram_mismatch++;
+        printf("GEMM_VERIFY %-12s %dx%d: %d mismatched elements\n", "gram H^H*H", Ntr_1, Ntr_1, gram_mismatch);
+        mismatch += gram_mismatch;
+    }
+    return mismatch;
+}
+#endif
 
-int main()
+#ifdef INV_VERIFY
+/*预条件矩阵求逆精度报告：G = H^H*H + sigma2/dqam^2*I，以双精度Gauss-Jordan结果为参考，
+  统计浮点与定点（D的倒数用查表或除法器）三种实现的最大绝对误差和相对Frobenius误差*/
+int inv_verify(const MyComplex_H* input_H, int frames, float sigma2)
+{
+    typedef ref_cd cd;
+    like_float dqam;
+    double err_max[3] = {0, 0, 0}, err_rel_max[3] = {0, 0, 0}, err_rel_sum[3] = {0, 0, 0};
+    get_dqam_hw(dqam);
+    double reg = sigma2 / ((double)dqam * (double)dqam);
+    for (int f = 0; f < frames; f++) {
+        const MyComplex_H* H = input_H + f * Ntr_2;
+        cd Hc[Ntr_2], G[Ntr_2], Ginv[Ntr_2];
+        MyComplex_f G_f[Ntr_2];
+        MyComplex G_x[Ntr_2], G_d[Ntr_2];
+        for (int i = 0; i < Ntr_2; i++)
+            Hc[i] = cd((double)H[i].real, (double)H[i].imag);
+        ref_gram_reg(Hc, Ntr_1, reg, G);
+        for (int i = 0; i < Ntr_2; i++) {
+            G_f[i].real = G[i].real(); G_f[i].imag = G[i].imag();
+            G_x[i].real = G[i].real(); G_x[i].imag = G[i].imag();
+            G_d[i] = G_x[i];
+        }
+        /*双精度参考：Gauss-Jordan（带部分主元）*/
+        ref_inverse(G, Ntr_1, Ginv);
+        Inverse_LDL_pro(G_f);
+        Inverse_LDL_fixed<Ntr_1, ldl_recip_lut>(G_x);
+        Inverse_LDL_fixed<Ntr_1, ldl_recip_div>(G_d);
+        for (int m = 0; m < 3; m++) {
+            double e_max = 0, e_fro = 0, ref_fro = 0;
+            for (int i = 0; i < Ntr_2; i++) {
+                cd v = (m == 0) ? cd(G_f[i].real, G_f[i].imag)
+                     : (m == 1) ? cd((double)G_x[i].real, (double)G_x[i].imag) : cd((double)G_d[i].real, (double)G_d[i].imag);
+                double e = std::abs(v - Ginv[i]);
+                e_max = (e > e_max) ? e : e_max;
+                e_fro += e * e;
+                ref_fro += std::norm(Ginv[i]);
+            }
+            double e_rel = sqrt(e_fro / ref_fro);
+            err_max[m] = (e_max > err_max[m]) ? e_max : err_max[m];
+            err_rel_max[m] = (e_rel > err_rel_max[m]) ? e_rel : err_rel_max[m];
+            err_rel_sum[m] += e_rel;
+        }
+    }
+    printf("INV_VERIFY %d frames, reg=%g\n", frames, reg);
+    printf("INV_VERIFY float Inverse_LDL_pro : max|err|=%.3e  rel_fro max=%.3e mean=%.3e\n", err_max[0], err_rel_max[0], err_rel_sum[0] / frames);
+    printf("INV_VERIFY fixed Inverse_LDL_fixed (recip_lut_hw) : max|err|=%.3e  rel_fro max=%.3e mean=%.3e\n", err_max[1], err_rel_max[1], err_rel_sum[1] / frames);
+    printf("INV_VERIFY fixed Inverse_LDL_fixed (divider)      : max|err|=%.3e  rel_fro max=%.3e mean=%.3e\n", err_max[2], err_rel_max[2], err_rel_sum[2] / frames);
+    /*定点结果最终截断到grad_preconditioner位宽（ap_fixed<24,8>，LSB=2^-16），误差应在该量级以内*/
+    return err_max[1] > 1e-3 || err_max[2] > 1e-3;
+}
+#endif
+#ifdef DEMOD_VERIFY
+/*
+ * 输入：每根轴、每个门限两侧±64个LSB（2^-32）内逐点枚举（含恰好落在门限上的值，另一轴随机），
+ * 以及n个在星座范围外扩10%内均匀分布的随机符号；速度在随机符号上测量。
+ */
+template<int MU>
+int demod_verify_mu(std::mt19937_64& gen, int n)
+{
+    const int Ma = 1 << (MU / 2);
+    const double unit = 1.0 / sqrt((double)qam_slicer_traits<MU>::energy);
+    std::uniform_real_distribution<double> uni(-1.1 * (Ma - 1) * unit, 1.1 * (Ma - 1) * unit);
+    std::vector<MyComplex> x;
+    for (int axis = 0; axis < 2; axis++)
+        for (int j = 1; j < Ma; j++)
+            for (int off = -64; off <= 64; off++) {
+                MyComplex c;
+                Myreal v = (2 * j - Ma) * unit + ldexp((double)off, -32);
+                c.real = axis == 0 ? v : (Myreal)uni(gen);
+                c.imag = axis == 1 ? v : (Myreal)uni(gen);
+                x.push_back(c);
+            }
+    const int n_edge = (int)x.size();
+    for (int i = 0; i < n; i++) {
+        MyComplex c;
+        c.real = uni(gen);
+        c.imag = uni(gen);
+        x.push_back(c);
+    }
+    const int total = (int)x.size();
+    std::vector<double> x_re(total), x_im(total);
+    for (int i = 0; i < total; i++) {
+        x_re[i] = (double)x[i].real;
+        x_im[i] = (double)x[i].imag;
+    }
+    std::vector<int> b_ref(total * MU), b_slice(total * MU), b_batch(total * MU);
+    qam_slicer_batch batch(MU);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (MU <= 6)
+        QAM_Demodulation_hw(x.data(), total, MU, b_ref.data());
+    auto t1 = std::chrono::high_resolution_clock::now();
+    QAM_Slicer_hw(x.data(), total, MU, b_slice.data());
+    auto t2 = std::chrono::high_resolution_clock::now();
+    batch(x_re.data(), x_im.data(), total, b_batch.data());
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    /*256QAM没有逐点搜索的原函数，只比对slicer与批量实现*/
+    int mis_slice = MU <= 6 ? unequal_times_hw(b_ref.data(), b_slice.data(), total * MU) : 0;
+    int mis_batch = unequal_times_hw(b_slice.data(), b_batch.data(), total * MU);
+    double ns = 1e3 / total;
+    printf("DEMOD_VERIFY mu=%d: %d symbols (%d near thresholds), mismatched bits slicer=%d batch=%d, "
+           "ns/symbol ref=%.1f slicer=%.1f batch=%.1f\n", MU, total, n_edge, mis_slice, mis_batch,
+        std::chrono::duration<double, std::micro>(t1 - t0).count() * ns,
+        std::chrono::duration<double, std::micro>(t2 - t1).count() * ns,
+        std::chrono::duration<double, std::micro>(t3 - t2).count() * ns);
+    return mis_slice + mis_batch;
+}
+int demod_verify()
+{
+    std::mt19937_64 gen(2024);
+    return demod_verify_mu<2>(gen, 100000) + demod_verify_mu<4>(gen, 100000)
+         + demod_verify_mu<6>(gen, 100000) + demod_verify_mu<8>(gen, 100000);
+}
+#endif
+#ifdef MULTI_CFG_VERIFY
+/*非默认配置的C仿真：帧由ref_gen_frame生成（H ~ CN(0, 1/Nr)，发送符号在星座上均匀随机），按与主流程相同的方式取sigma2；
+  比特由QAM_Slicer_hw分别解调发送符号与检测结果得到，因此与星座的比特映射无关*/
+template<class CFG>
+float multi_cfg_run(const char* name, float SNR, int frames, splitmix64_rng& rng)
+{
+    const int Nt = CFG::Nt, Nr = CFG::Nr, mu = CFG::Mu;
+    float sigma2 = (float)Nt / (float)Nr * pow(10.0f, -SNR / 10.0f);
+    MyComplex x[Nt], x_hat[Nt];
+    H_real_t H_real[Nr * Nt];
+    H_imag_t H_imag[Nr * Nt];
+    y_real_t y_real[Nr];
+    y_imag_t y_imag[Nr];
+    Myreal x_hat_real[Nt];
+    Myimage x_hat_imag[Nt];
+    unsigned int seed[CFG::Samplers];
+    int bits[Nt * mu], bits_demod[Nt * mu];
+#ifdef SOFT_OUTPUT
+    llr_t llr[Nt * mu];
+#endif
+#ifdef PROFILE_STAGES
+    unsigned int prof[2 + PROF_SAMPLER_BASE + 2 * CFG::Samplers];
+    mhgd_prof_acc prof_acc;
+#endif
+#ifdef GAUSS_TABLE_MODE
+    static v_real_t v_tb_real[CFG::Samplers * CFG::num_ran];
+    static v_imag_t v_tb_imag[CFG::Samplers * CFG::num_ran];
+#endif
+    int total_error_bits = 0;
+    for (int f = 0; f < frames; f++) {
+        float Hr[Nr * Nt], Hi[Nr * Nt], yr[Nr], yi[Nr];
+        ref_gen_frame<CFG::Mu>(rng, Nt, Nr, sigma2, Hr, Hi, x, yr, yi);
+        for (int l = 0; l < Nr * Nt; l++) {
+            H_real[l] = Hr[l];
+            H_imag[l] = Hi[l];
+        }
+        for (int r = 0; r < Nr; r++) {
+            y_real[r] = yr[r];
+            y_imag[r] = yi[r];
+        }
+        for (int k = 0; k < CFG::Samplers; k++)
+            seed[k] = (unsigned int)(rng.next() >> 32);
+#ifdef GAUSS_TABLE_MODE
+        for (int l = 0; l < CFG::Samplers * CFG::num_ran; l++) {
+            float a, b;
+            rng.gauss2(a, b);
+            v_tb_real[l] = a * sqrtf(0.5f);
+            v_tb_imag[l] = b * sqrtf(0.5f);
+        }
+#endif
+#ifdef PACKED_AXI
+        axi_word_t H_pack[axi_pack<H_real_t, H_imag_t, Nr * Nt>::words];
+        axi_word_t y_pack[axi_pack<y_real_t, y_imag_t, Nr>::words];
+        axi_word_t x_hat_pack[axi_pack<Myreal, Myimage, Nt>::words];
+        axi_pack_array(H_real, H_imag, Nr * Nt, H_pack);
+        axi_pack_array(y_real, y_imag, Nr, y_pack);
+        MHGD_detect_accel_core<CFG>(x_hat_pack, H_pack, y_pack,
+#else
+        MHGD_detect_accel_core<CFG>(x_hat_real, x_hat_imag, H_real, H_imag, y_real, y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+            v_tb_real, v_tb_imag,
+#endif
+            sigma2, seed
+#ifdef SOFT_OUTPUT
+            , llr, mhgd_llr_gain(sigma2, CFG::Mu)
+#endif
+#ifdef PROFILE_STAGES
+            , prof
+#endif
+        );
+#ifdef PACKED_AXI
+        axi_unpack_array(x_hat_pack, Nt, x_hat_real, x_hat_imag);
+#endif
+#ifdef PROFILE_STAGES
+        prof_acc.add(prof);
+#endif
+        for (int l = 0; l < Nt; l++) {
+            x_hat[l].real = x_hat_real[l];
+            x_hat[l].imag = x_hat_imag[l];
+        }
+        QAM_Slicer_hw(x, Nt, mu, bits);
+        QAM_Slicer_hw(x_hat, Nt, mu, bits_demod);
+        total_error_bits += unequal_times_hw(bits_demod, bits, Nt * mu);
+    }
+    float BER = (float)total_error_bits / (float)(frames * Nt * mu);
+    printf("MULTI_CFG %-14s Nt=%2d Nr=%2d mu=%d SNR=%.0f frames=%d BER=%.6f\n", name, Nt, Nr, mu, SNR, frames, BER);
+#ifdef PROFILE_STAGES
+    prof_acc.print(stdout, 0);
+#endif
+    return BER;
+}
+/*BER上限：固定种子下的实测值约为0 / 0.075 / 0.013，上限留出数倍余量，只用于发现配置错误（此时BER接近0.5）；返回超限的配置数*/
+template<class CFG>
+int multi_cfg_check(const char* name, float SNR, int frames, float max_ber, splitmix64_rng& rng)
+{
+    float BER = multi_cfg_run<CFG>(name, SNR, frames, rng);
+    if (BER > max_ber) {
+        printf("MULTI_CFG %-14s FAIL: BER %.6f > %.6f\n", name, BER, max_ber);
+        return 1;
+    }
+    return 0;
+}
+int multi_cfg_verify()
+{
+    splitmix64_rng rng;
+    rng.reset(2024, 0);
+    int fail = multi_cfg_check<mhgd_cfg_4x4_qpsk>("4x4 QPSK", 15, 50, 0.02f, rng)
+             + multi_cfg_check<mhgd_cfg_16x16_64qam>("16x16 64QAM", 30, 20, 0.15f, rng)
+             + multi_cfg_check<mhgd_cfg_4x8_16qam>("4x8 16QAM", 15, 50, 0.05f, rng);
+    printf("MULTI_CFG: %d of 3 configurations over the BER bound\n", fail);
+    return fail;
+}
+#endif
+
+int main(int argc, char** argv)
 {
     /*变量定义*/
     FILE* ff;
@@ -55,30 +360,12 @@ int main()
     H_imag_t H_imag[Ntr_1 * Ntr_1];
     y_real_t y_real[Ntr_1];
     y_imag_t y_imag[Ntr_1];
+#ifdef GAUSS_TABLE_MODE
     MyComplex_v v_tb[Ntr_1 * iter_1];
-    MyComplex_v v_tb_2[Ntr_1 * iter_1];
-    MyComplex_v v_tb_3[Ntr_1 * iter_1];
-    MyComplex_v v_tb_4[Ntr_1 * iter_1];
-    MyComplex_v v_tb_5[Ntr_1 * iter_1];
-    MyComplex_v v_tb_6[Ntr_1 * iter_1];
-    MyComplex_v v_tb_7[Ntr_1 * iter_1];
-    MyComplex_v v_tb_8[Ntr_1 * iter_1];
-    v_real_t v_tb_real[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag[Ntr_1 * iter_1];
-    v_real_t v_tb_real_2[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_2[Ntr_1 * iter_1];
-    v_real_t v_tb_real_3[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_3[Ntr_1 * iter_1];
-    v_real_t v_tb_real_4[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_4[Ntr_1 * iter_1];
-    v_real_t v_tb_real_5[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_5[Ntr_1 * iter_1];
-    v_real_t v_tb_real_6[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_6[Ntr_1 * iter_1];
-    v_real_t v_tb_real_7[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_7[Ntr_1 * iter_1];
-    v_real_t v_tb_real_8[Ntr_1 * iter_1];
-    v_imag_t v_tb_imag_8[Ntr_1 * iter_1];
+    v_real_t v_tb_real[samplers * num_ran];/*第k个采样器的高斯表位于v_tb_real + k*num_ran*/
+    v_imag_t v_tb_imag[samplers * num_ran];
+    char gauss_file[1024];
+#endif
     MyComplex noise_real[Ntr_1];
     MyComplex noise_image[Ntr_1];
     MyComplex_H input_H[max_iter_1 * Ntr_1 * Ntr_1];
@@ -92,6 +379,30 @@ int main()
     int x_init_6[Ntr_1];
     int x_init_7[Ntr_1];
     int x_init_8[Ntr_1];
+#ifdef BATCH_VERIFY
+    unsigned int seed_all[max_iter_1 * samplers];
+    Myreal x_hat_real_single[max_iter_1 * Ntr_1];
+    Myimage x_hat_imag_single[max_iter_1 * Ntr_1];
+#endif
+    /*主种子：./csim <seed> 可复现整次仿真*/
+    const uint64_t master_seed = parse_master_seed(argc, argv);
+    printf("master seed = %llu\n", (unsigned long long)master_seed);
+    /*./csim <seed> <dataset.bin>：从二进制数据集逐帧读取，帧数与SNR取自文件头，不受max_iter_1限制*/
+    mhgd_dataset ds;
+    const bool use_ds = argc > 2;
+    if (use_ds) {
+        if (!ds.open(argv[2]))
+            return 1;
+        const mhgd_dataset_header& hdr = ds.header();
+        if (hdr.Nt != Ntr_1 || hdr.Nr != Ntr_1 || hdr.mu != mu_1) {
+            printf("%s: Nt=%u Nr=%u mu=%u, testbench built for Nt=Nr=%d mu=%d\n", argv[2], hdr.Nt, hdr.Nr, hdr.mu, Ntr_1, mu_1);
+            return 1;
+        }
+        SNR = hdr.snr_db;
+        max_iter = (int)hdr.frames;
+    }
+    /*GEMM/INV/BATCH校验只作用于前verify_frames帧（数组按max_iter_1分配）*/
+    const int verify_frames = max_iter < max_iter_1 ? max_iter : max_iter_1;
 
     /*字符串拼接，根据信噪比不同写入不同的文本文件*/
 	char bits_file[1024] = "/home/ggg_wufuqi/hls/MHGD/MHGD/8_8_16QAM/reference_file/bits_SNR=";
@@ -109,52 +420,96 @@ int main()
 	strcat(bits_output_file, txt);
     /*读取输入测试文件数据（信道数据、接受信号数据、比特数据）*/
 	printf("SNR=%f loading file...", SNR);
-	ff = fopen(H_file, "r");
-	while (!feof(ff))
-	{
-		if (i >= Nt * Nr * max_iter) { // 防止数组越界
-			break;
+    if (use_ds) {
+        /*数据集模式：仅为校验代码填充前verify_frames帧，检测循环直接读映射*/
+        for (i = 0; i < verify_frames; i++) {
+            for (j = 0; j < Nr * Nt; j++) {
+                input_H[i * Nr * Nt + j].real = ds.H(i)[2 * j];
+                input_H[i * Nr * Nt + j].imag = ds.H(i)[2 * j + 1];
+            }
+            for (j = 0; j < Nr; j++) {
+                input_y[i * Nr + j].real = ds.y(i)[2 * j];
+                input_y[i * Nr + j].imag = ds.y(i)[2 * j + 1];
+            }
+        }
+        i = 0;
+    } else {
+		ff = fopen(H_file, "r");
+		while (!feof(ff))
+		{
+			if (i >= Nt * Nr * max_iter) { // 防止数组越界
+				break;
+			}
+			fscanf(ff, "%f %f\n", &real_temp, &imag_temp);
+			input_H[i].real = real_temp; input_H[i].imag = imag_temp;
+			i++;
 		}
-		fscanf(ff, "%f %f\n", &real_temp, &imag_temp);
-		input_H[i].real = real_temp; input_H[i].imag = imag_temp;
-		i++;
-	}
-	fclose(ff); i = 0;
+		fclose(ff); i = 0;
 
-	ff = fopen(y_file, "r");
-	while (!feof(ff))
-	{
-		if (i >= Nr * max_iter) { // 防止数组越界
-			break;
+		ff = fopen(y_file, "r");
+		while (!feof(ff))
+		{
+			if (i >= Nr * max_iter) { // 防止数组越界
+				break;
+			}
+			fscanf(ff, "%f %f\n", &real_temp, &imag_temp);
+			input_y[i].real = real_temp; input_y[i].imag = imag_temp;
+			i++;
 		}
-		fscanf(ff, "%f %f\n", &real_temp, &imag_temp);
-		input_y[i].real = real_temp; input_y[i].imag = imag_temp;
-		i++;
-	}
-	fclose(ff); i = 0;
+		fclose(ff); i = 0;
 
-	ff = fopen(bits_file, "r");
-	while (!feof(ff))
-	{
-		if (i >= Nt * mu * max_iter) { // 防止数组越界
-			break;
+		ff = fopen(bits_file, "r");
+		while (!feof(ff))
+		{
+			if (i >= Nt * mu * max_iter) { // 防止数组越界
+				break;
+			}
+			fscanf(ff, "%d\n", &b);
+			origin_bits[i] = b;
+			i++;
 		}
-		fscanf(ff, "%d\n", &b);
-		origin_bits[i] = b;
-		i++;
-	}
-	fclose(ff); i = 0;
+		fclose(ff); i = 0;
+    }
 
 	ff = fopen(bits_output_file, "w");
 	fclose(ff);
 	printf("\rSNR=%f loading completed...\n", SNR);
 
+#ifdef GEMM_VERIFY
+    if (gemm_verify(input_H))
+        return 1;
+#endif
+#ifdef DEMOD_VERIFY
+    if (demod_verify())
+        return 1;
+#endif
     /*部分算法内的量提出预计算*/
         float signal_power = 0;
 	    float sigma2 = 0;
         signal_power = (float)Nt / (float)Nr;
         sigma2 = signal_power * pow(10.0f, -SNR / 10.0f);
     /*计算结束*/
+#ifdef INV_VERIFY
+    if (inv_verify(input_H, verify_frames, sigma2))
+        return 1;
+#endif
+#ifdef CPU_VERIFY
+    double csim_us = 0, cpu_us = 0;
+    int cpu_error_bits = 0, cpu_same_symbols = 0;
+    printf("CPU_VERIFY: MHGD_detect_cpu kernels = %s\n", mhgd_cpu_kernels_get().isa);
+#endif
+#ifdef SOFT_OUTPUT
+    /*LLR符号须与硬判决一致（硬判决所在候选的r_norm最小），另统计饱和比例与正确/错误比特的平均|LLR|*/
+    llr_t llr[Ntr_1 * mu_1];
+    const float llr_gain = mhgd_llr_gain(sigma2, mu);
+    int llr_sign_mismatch = 0, llr_saturated = 0, llr_right = 0, llr_wrong = 0;
+    double llr_abs_right = 0, llr_abs_wrong = 0;
+#endif
+#ifdef PROFILE_STAGES
+    /*各级分段计时：C仿真中为实数乘法次数*/
+    unsigned int prof[2 + PROF_SAMPLER_BASE + 2 * samplers];
+    mhgd_prof_acc prof_acc;
+#endif
     /*开始检测*/
     for (i = 0; i < max_iter; i++)
     {
@@ -162,53 +517,43 @@ int main()
         float MSE = 0;/*?*/
         float symbol_mse = 0; // 当前迭代的 MSE
         /*将读取的数据存入变量并处理*/
-		for (j = 0; j < Nr * Nt; j++)
-            H[j] = input_H[Nr * Nt * i + j];
-        for (j = 0; j < Nr; j++)
-            y[j] = input_y[Nr * i + j];
-        for (j = 0; j < Nt * mu; j++)
-            bits[j] = origin_bits[Nt * mu * i + j];
-        /*MIMO检测，检测类型可在main.c的MIMO_sys中更改，可选MHGD与MMSE*/
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus.txt", v_tb, Nt*iter_1, 0);///home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_2.txt", v_tb_2, Nt*iter_1, 0);
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_3.txt", v_tb_3, Nt*iter_1, 0);
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_4.txt", v_tb_4, Nt*iter_1, 0);
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_5.txt", v_tb_5, Nt*iter_1, 0);
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_6.txt", v_tb_6, Nt*iter_1, 0);
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_7.txt", v_tb_7, Nt*iter_1, 0);
-        read_gaussian_data_hw("/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_8.txt", v_tb_8, Nt*iter_1, 0);
-        for (l = 0; l < Nt*iter_1; l++){
-            v_tb_real[l] = v_tb[l].real;
-            v_tb_imag[l] = v_tb[l].imag;
-        }
-        for (l = 0; l < Nt*iter_1; l++){
-            v_tb_real_2[l] = v_tb_2[l].real;
-            v_tb_imag_2[l] = v_tb_2[l].imag;
-        }
-        for (l = 0; l < Nt*iter_1; l++){
-            v_tb_real_3[l] = v_tb_3[l].real;
-            v_tb_imag_3[l] = v_tb_3[l].imag;
-        }
-        for (l = 0; l < Nt*iter_1; l++){
-            v_tb_real_4[l] = v_tb_4[l].real;
-            v_tb_imag_4[l] = v_tb_4[l].imag;
-        }
-        for (l = 0; l < Nt*iter_1; l++){
-           v_tb_real_5[l] = v_tb_5[l].real;
-           v_tb_imag_5[l] = v_tb_5[l].imag;
+        if (use_ds) {
+            const float* Hf = ds.H(i);
+            const float* yf = ds.y(i);
+            const uint8_t* bf = ds.bits(i);
+            for (j = 0; j < Nr * Nt; j++) {
+                H[j].real = Hf[2 * j];
+                H[j].imag = Hf[2 * j + 1];
+            }
+            for (j = 0; j < Nr; j++) {
+                y[j].real = yf[2 * j];
+                y[j].imag = yf[2 * j + 1];
+            }
+            for (j = 0; j < Nt * mu; j++)
+                bits[j] = bf[j];
+        } else {
+            for (j = 0; j < Nr * Nt; j++)
+                H[j] = input_H[Nr * Nt * i + j];
+            for (j = 0; j < Nr; j++)
+                y[j] = input_y[Nr * i + j];
+            for (j = 0; j < Nt * mu; j++)
+                bits[j] = origin_bits[Nt * mu * i + j];
         }
-        for (l = 0; l < Nt*iter_1; l++){
-           v_tb_real_6[l] = v_tb_6[l].real;
-           v_tb_imag_6[l] = v_tb_6[l].imag;
-        }
-        for (l = 0; l < Nt*iter_1; l++){
-           v_tb_real_7[l] = v_tb_7[l].real;
-           v_tb_imag_7[l] = v_tb_7[l].imag;
-        }
-        for (l = 0; l < Nt*iter_1; l++){
-           v_tb_real_8[l] = v_tb_8[l].real;
-           v_tb_imag_8[l] = v_tb_8[l].imag;
+        /*MIMO检测，检测类型可在main.c的MIMO_sys中更改，可选MHGD与MMSE*/
+#ifdef GAUSS_TABLE_MODE
+        /*每个采样器一张高斯表，依次为gaussian_random_values_plus.txt, _2.txt ... _8.txt，超过8个采样器时循环复用*/
+        for (int k = 0; k < samplers; k++) {
+            if (k % 8 == 0)
+                sprintf(gauss_file, "/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus.txt");///home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt
+            else
+                sprintf(gauss_file, "/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_%d.txt", k % 8 + 1);
+            read_gaussian_data_hw(gauss_file, v_tb, Nt*iter_1, 0);
+            for (l = 0; l < Nt*iter_1; l++){
+                v_tb_real[k * num_ran + l] = v_tb[l].real;
+                v_tb_imag[k * num_ran + l] = v_tb[l].imag;
+            }
         }
+#endif
         for (l = 0; l < Nr * Nt; l++){
             H_real[l] = H[l].real;
             H_imag[l] = H[l].imag;
@@ -219,27 +564,100 @@ int main()
         }
         /*随机种子产生*/
         unsigned int seed[samplers];
-        for (int i = 0; i < samplers; i++) {
-           seed[i] = generate_seed(i);
-           std::this_thread::sleep_for(std::chrono::microseconds(100 * (i + 1)));
-        }
+        for (int k = 0; k < samplers; k++)
+           seed[k] = generate_seed(master_seed, i, k);
+#ifdef CPU_VERIFY
+        auto t_csim = std::chrono::high_resolution_clock::now();
+#endif
+#ifdef PACKED_AXI
+        /*打包端口：调用前打包H/y、调用后解包x_hat，数值与分离端口逐位相同*/
+        axi_word_t H_pack[H_words_1], y_pack[y_words_1], x_hat_pack[x_words_1];
+        axi_pack_array(H_real, H_imag, Nr * Nt, H_pack);
+        axi_pack_array(y_real, y_imag, Nr, y_pack);
+        MHGD_detect_accel_hw(x_hat_pack, H_pack, y_pack,
+#else
         MHGD_detect_accel_hw(x_hat_real, x_hat_imag, H_real, H_imag, y_real, y_imag, 
-            v_tb_real, v_tb_imag, 
-            v_tb_real_2, v_tb_imag_2,
-            v_tb_real_3, v_tb_imag_3,
-            v_tb_real_4, v_tb_imag_4,
-            // v_tb_real_5, v_tb_imag_5,
-            // v_tb_real_6, v_tb_imag_6,
-            // v_tb_real_7, v_tb_imag_7,
-            // v_tb_real_8, v_tb_imag_8,
-            sigma2, seed[0], seed[1], seed[2], seed[3]//, seed[4], seed[5], seed[6], seed[7]
+#endif
+#ifdef GAUSS_TABLE_MODE
+            v_tb_real, v_tb_imag,
+#endif
+            sigma2, seed
+#ifdef SOFT_OUTPUT
+            , llr, llr_gain
+#endif
+#ifdef PROFILE_STAGES
+            , prof
+#endif
         );
+#ifdef PACKED_AXI
+        axi_unpack_array(x_hat_pack, Nt, x_hat_real, x_hat_imag);
+#endif
+#ifdef PROFILE_STAGES
+        prof_acc.add(prof);
+#endif
+#ifdef CPU_VERIFY
+        auto t_cpu = std::chrono::high_resolution_clock::now();
+        Myreal x_cpu_real[Ntr_1];
+        Myimage x_cpu_imag[Ntr_1];
+#ifdef SOFT_OUTPUT
+        llr_t llr_cpu[Ntr_1 * mu_1];
+#endif
+        MHGD_detect_cpu(x_cpu_real, x_cpu_imag, H_real, H_imag, y_real, y_imag,
+#ifdef GAUSS_TABLE_MODE
+            v_tb_real, v_tb_imag,
+#endif
+            sigma2, seed
+#ifdef SOFT_OUTPUT
+            , llr_cpu, llr_gain
+#endif
+        );
+        auto t_done = std::chrono::high_resolution_clock::now();
+        csim_us += std::chrono::duration<double, std::micro>(t_cpu - t_csim).count();
+        cpu_us += std::chrono::duration<double, std::micro>(t_done - t_cpu).count();
+        MyComplex x_cpu[Ntr_1];
+        int bits_cpu[Ntr_1 * mu_1];
+        for (l = 0; l < Nt; l++) {
+            x_cpu[l].real = x_cpu_real[l];
+            x_cpu[l].imag = x_cpu_imag[l];
+        }
+        QAM_Slicer_hw(x_cpu, Nt, mu, bits_cpu);
+        cpu_error_bits += unequal_times_hw(bits_cpu, bits, Nt * mu);
+#endif
         for(l = 0; l < Nt; l++){
 			x_hat[l].real = x_hat_real[l];
 			x_hat[l].imag = x_hat_imag[l];
 		}
+#ifdef BATCH_VERIFY
+        if (i < verify_frames) {
+            for (l = 0; l < samplers; l++)
+                seed_all[i * samplers + l] = seed[l];
+            for (l = 0; l < Nt; l++){
+                x_hat_real_single[i * Ntr_1 + l] = x_hat_real[l];
+                x_hat_imag_single[i * Ntr_1 + l] = x_hat_imag[l];
+            }
+        }
+#endif
         /*解调，检测的结果比特存储在bits_demod中*/
-        QAM_Demodulation_hw(x_hat, Nt, mu, bits_demod);
+        QAM_Slicer_hw(x_hat, Nt, mu, bits_demod);
+#ifdef CPU_VERIFY
+        /*按判决符号比较：两者的x_hat数值因精度不同低位有差异，比较解调后的比特*/
+        for (l = 0; l < Nt; l++)
+            cpu_same_symbols += (unequal_times_hw(bits_cpu + l * mu, bits_demod + l * mu, mu) == 0);
+#endif
+#ifdef SOFT_OUTPUT
+        for (l = 0; l < Nt * mu; l++) {
+            const int q = llr[l];
+            llr_sign_mismatch += bits_demod[l] ? (q > 0) : (q < 0);
+            llr_saturated += (q == LLR_MAX || q == -LLR_MAX);
+            if (bits_demod[l] == bits[l]) {
+                llr_abs_right += abs(q);
+                llr_right++;
+            } else {
+                llr_abs_wrong += abs(q);
+                llr_wrong++;
+            }
+        }
+#endif
         /*将解调比特结果输出到相应的文件中*/
         ff = fopen(bits_output_file, "a");
         for (l = 0; l < Nt * mu; l++)
@@ -253,6 +671,77 @@ int main()
         printf("-------------error bits:%d, total err_bits:%d, round:%d-----------\r", err_bits, total_error_bits, i + 1);
     }
     BER = (float)total_error_bits / (float)total_bits ;
+#ifdef BATCH_VERIFY
+    {
+        /*批处理接口校验：同样的H/y/v_tb/种子，一次调用检测全部帧*/
+        static H_real_t H_real_all[max_iter_1 * Ntr_1 * Ntr_1];
+        static H_imag_t H_imag_all[max_iter_1 * Ntr_1 * Ntr_1];
+        static y_real_t y_real_all[max_iter_1 * Ntr_1];
+        static y_imag_t y_imag_all[max_iter_1 * Ntr_1];
+        static Myreal x_hat_real_all[max_iter_1 * Ntr_1];
+        static Myimage x_hat_imag_all[max_iter_1 * Ntr_1];
+        float sigma2_all[max_iter_1];
+        int mismatch = 0;
+        for (j = 0; j < verify_frames * Nr * Nt; j++){
+            H_real_all[j] = input_H[j].real;
+            H_imag_all[j] = input_H[j].imag;
+        }
+        for (j = 0; j < verify_frames * Nr; j++){
+            y_real_all[j] = input_y[j].real;
+            y_imag_all[j] = input_y[j].imag;
+        }
+        for (j = 0; j < verify_frames; j++)
+            sigma2_all[j] = sigma2;
+#ifdef PACKED_AXI
+        /*打包端口：每帧从新的字开始*/
+        static axi_word_t H_pack_all[max_iter_1 * H_words_1], y_pack_all[max_iter_1 * y_words_1];
+        static axi_word_t x_hat_pack_all[max_iter_1 * x_words_1];
+        for (j = 0; j < verify_frames; j++) {
+            axi_pack_array(H_real_all + j * Nr * Nt, H_imag_all + j * Nr * Nt, Nr * Nt, H_pack_all + j * H_words_1);
+            axi_pack_array(y_real_all + j * Nr, y_imag_all + j * Nr, Nr, y_pack_all + j * y_words_1);
+        }
+        MHGD_detect_accel_hw_batch(x_hat_pack_all, H_pack_all, y_pack_all,
+#else
+        MHGD_detect_accel_hw_batch(x_hat_real_all, x_hat_imag_all, H_real_all, H_imag_all, y_real_all, y_imag_all,
+#endif
+#ifdef GAUSS_TABLE_MODE
+            v_tb_real, v_tb_imag,
+#endif
+            sigma2_all, seed_all, verify_frames
+        );
+#ifdef PACKED_AXI
+        for (j = 0; j < verify_frames; j++)
+            axi_unpack_array(x_hat_pack_all + j * x_words_1, Nt, x_hat_real_all + j * Nt, x_hat_imag_all + j * Nt);
+#endif
+        for (j = 0; j < verify_frames * Nt; j++){
+            if (x_hat_real_all[j] != x_hat_real_single[j] || x_hat_imag_all[j] != x_hat_imag_single[j])
+                mismatch++;
+        }
+        printf("\nBATCH_VERIFY: %d frames, %d mismatched symbols\n", verify_frames, mismatch);
+        if (mismatch)
+            return 1;
+    }
+#endif
+#ifdef CPU_VERIFY
+    printf("\nCPU_VERIFY[%s]: %d frames, BER csim = %.8f, cpu = %.8f, same symbols = %.2f%%, csim %.1f frames/s, cpu %.1f frames/s\n",
+        mhgd_cpu_kernels_get().isa, max_iter, BER, (float)cpu_error_bits / (float)total_bits,
+        100.0 * cpu_same_symbols / ((double)max_iter * Nt), max_iter / (csim_us * 1e-6), max_iter / (cpu_us * 1e-6));
+#endif
+#ifdef SOFT_OUTPUT
+    printf("\nSOFT_OUTPUT: %d bits, sign mismatches = %d, saturated = %.2f%%, mean |LLR| right = %.2f, wrong = %.2f (llr_gain = %.4f LSB/nat)\n",
+        total_bits, llr_sign_mismatch, 100.0 * llr_saturated / total_bits,
+        llr_right ? llr_abs_right / llr_right : 0.0, llr_wrong ? llr_abs_wrong / llr_wrong : 0.0, llr_gain);
+    if (llr_sign_mismatch)
+        return 1;
+#endif
+#ifdef PROFILE_STAGES
+    printf("\n");
+    prof_acc.print(stdout, 0);
+#endif
+#ifdef MULTI_CFG_VERIFY
+    if (multi_cfg_verify())
+        return 1;
+#endif
 
     /*输出 BER - 这个输出会被 Python 脚本捕获*/
     printf("\n");
@@ -0,0 +1,67 @@
+#pragma once
+/*
+ * PACKED_AXI下H/y/x_hat端口的打包格式，内核（data_distribution解包、out_packed_hw打包）与主机、testbench共用。
+ * 每个512位字从低位起依次存放per_word个复数元素，每个元素占TR::width + TI::width位，实部在低位、虚部紧随其后；
+ * 元素不跨字，字内剩余的高位为0。n个元素占words = ceil(n / per_word)个字，多帧连续存放时每帧从新的字开始。
+ * 各分量按定点数的原始位模式（range()）存放，主机打包与内核解包逐位一致。
+ * 例：H（ap_fixed<20,4>）每字12个元素，8×8的H为6个字；y每帧1个字；x_hat（ap_fixed<40,8>）每字6个元素，8个为2个字。
+ */
+#include "ap_int.h"
+
+typedef ap_uint<512> axi_word_t;
+static const int axi_word_bits = 512;
+static const int axi_word_bytes = axi_word_bits / 8;
+
+/*N个元素（分量类型TR/TI）的打包参数*/
+template<typename TR, typename TI, int N>
+struct axi_pack {
+	static const int elem_bits = TR::width + TI::width;
+	static const int per_word = axi_word_bits / elem_bits;
+	static const int words = (N + per_word - 1) / per_word;
+};
+
+/*把(re, im)写入字w的第slot个位置；内核中slot为展开后的常数*/
+template<typename TR, typename TI>
+void axi_put(axi_word_t& w, int slot, const TR& re, const TI& im)
+{
+	#pragma HLS INLINE
+	const int lo = slot * (TR::width + TI::width);
+	w.range(lo + TR::width - 1, lo) = re.range();
+	w.range(lo + TR::width + TI::width - 1, lo + TR::width) = im.range();
+}
+/*读出字w第slot个位置的元素*/
+template<typename TR, typename TI>
+void axi_get(const axi_word_t& w, int slot, TR& re, TI& im)
+{
+	#pragma HLS INLINE
+	const int lo = slot * (TR::width + TI::width);
+	re.range() = w.range(lo + TR::width - 1, lo);
+	im.range() = w.range(lo + TR::width + TI::width - 1, lo + TR::width);
+}
+/*取出字w最低位的元素并把w右移一个元素：内核逐拍解包只需常数位选与移位，不需要按slot选择的多路器*/
+template<typename TR, typename TI>
+void axi_pop(axi_word_t& w, TR& re, TI& im)
+{
+	#pragma HLS INLINE
+	re.range() = w.range(TR::width - 1, 0);
+	im.range() = w.range(TR::width + TI::width - 1, TR::width);
+	w >>= TR::width + TI::width;
+}
+
+/*主机与testbench：n个元素打包为ceil(n / per_word)个字（剩余位清零）/ 从打包的字中解出n个元素*/
+template<typename TR, typename TI>
+void axi_pack_array(const TR* re, const TI* im, int n, axi_word_t* out)
+{
+	const int per_word = axi_word_bits / (TR::width + TI::width);
+	for (int w = 0; w < (n + per_word - 1) / per_word; w++)
+		out[w] = 0;
+	for (int i = 0; i < n; i++)
+		axi_put(out[i / per_word], i % per_word, re[i], im[i]);
+}
+template<typename TR, typename TI>
+void axi_unpack_array(const axi_word_t* in, int n, TR* re, TI* im)
+{
+	const int per_word = axi_word_bits / (TR::width + TI::width);
+	for (int i = 0; i < n; i++)
+		axi_get(in[i / per_word], i % per_word, re[i], im[i]);
+}
@@ -0,0 +1,482 @@
+/*
+ * 运算模块微基准：在C级模型上逐个计时内核与参考代码中的算术模块，输出JSON，用于跟踪性能回退、
+ * 按数据（而不是经验）选择求逆等模块的实现与位宽。
+ * 用法：mhgd_bench [--min-ms T] [--filter S] [--json out.json]
+ *   --min-ms：每项至少计时T毫秒（默认50），调用次数按倍增确定；
+ *   --filter：只跑名称（group/name）中包含S的项；
+ *   --json：结果写入文件，否则写到stdout；进度与可读的表格始终打印到stderr。
+ * 每项记录：group/name/type/n、每次调用与每个元素的ns、调用次数，以及相对双精度参考的误差err（不适用时为null）：
+ *   matmul为最大绝对误差，inverse为相对Frobenius误差（取各输入的最大值），map/floor为与双精度结果不一致的比例，
+ *   demod为与逐点距离搜索QAM_Demodulation_hw不一致的比特比例（256QAM以qam_slicer_batch为参考）。
+ * 输入预先生成一组（bench_pool个），每次调用轮流取一个；原地运算的函数（求逆）每次先拷贝输入，拷贝计入时间。
+ * 计时的函数都在MHGD_accel_hw.cpp中（不同编译单元），调用不会被优化掉。
+ *
+ * 编译：make -C xclbin_host bench，或
+ *   g++ -std=c++14 -O2 -DMHGD_BENCH -I$XILINX_HLS/include MHGD_accel_hw.cpp mhgd_bench.cpp -o mhgd_bench
+ */
+#include "MHGD_accel_hw.h"
+#include "MyComplex_1.h"
+#include "qam_slicer.h"
+#include "mhgd_seed.h"
+#include "mhgd_testref.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <complex>
+#include <random>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#ifndef MHGD_BENCH
+#error "mhgd_bench需要MHGD_accel_hw.cpp中的显式实例化，请以-DMHGD_BENCH编译两个文件"
+#endif
+
+typedef ref_cd cd;
+
+static const int bench_pool = 64;/*每项预生成的输入组数*/
+static const int bench_syms = 1024;/*解调与floor每次调用处理的元素数*/
+
+struct bench_record {
+    std::string group, name, type;
+    int n;              /*矩阵阶数或每次调用的元素数*/
+    int items;          /*每次调用处理的元素数（ns_per_item的分母）*/
+    double ns_per_call;
+    long calls;
+    double err;         /*NAN表示不适用*/
+};
+
+struct bench_ctx {
+    double min_ms;
+    const char* filter;
+    std::vector<bench_record> out;
+
+    bool want(const char* group, const char* name) const
+    {
+        if (!filter)
+            return true;
+        std::string key = std::string(group) + "/" + name;
+        return key.find(filter) != std::string::npos;
+    }
+    /*f(i)执行第i次调用；调用次数自1起倍增，直到一轮的耗时不少于min_ms*/
+    template<class F>
+    void run(const char* group, const char* name, const char* type, int n, int items, double err, F f)
+    {
+        if (!want(group, name))
+            return;
+        f(0);
+        long calls = 1;
+        double ns = 0;
+        for (;;) {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (long i = 0; i < calls; i++)
+                f((int)(i % bench_pool));
+            ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - t0).count();
+            if (ns >= min_ms * 1e6 || calls >= (1L << 30))
+                break;
+            calls *= 2;
+        }
+        bench_record r = { group, name, type, n, items, ns / calls, calls, err };
+        out.push_back(r);
+        fprintf(stderr, "%-8s %-36s %-22s n=%-5d %12.1f ns/call %10.2f ns/item", group, name, type, n,
+                r.ns_per_call, r.ns_per_call / items);
+        if (isnan(err))
+            fprintf(stderr, "\n");
+        else
+            fprintf(stderr, "  err=%.3e\n", err);
+    }
+};
+
+/*********************************输入生成与双精度参考************************************/
+/*H ~ CN(0, 1/n)，n×n行主序（mhgd_testref.h）*/
+static void gen_channel(splitmix64_rng& rng, int n, std::vector<cd>& H)
+{
+    std::vector<float> Hr(n * n), Hi(n * n);
+    ref_gen_channel(rng, n, n, Hr.data(), Hi.data());
+    H.resize(n * n);
+    for (int i = 0; i < n * n; i++)
+        H[i] = cd(Hr[i], Hi[i]);
+}
+template<typename TC>
+static void to_type(const std::vector<cd>& a, TC* out)
+{
+    for (size_t i = 0; i < a.size(); i++) {
+        out[i].real = a[i].real();
+        out[i].imag = a[i].imag();
+    }
+}
+template<typename TC>
+static cd at(const TC* a, int i)
+{
+    return cd((double)a[i].real, (double)a[i].imag);
+}
+
+/*********************************矩阵乘法************************************/
+/*C = A^H * B（与H^H*H同型），A/B各bench_pool组*/
+template<typename TA, typename TR>
+static void bench_matmul(bench_ctx& ctx, const char* type, int n, splitmix64_rng& chan)
+{
+    std::vector<TA> A(bench_pool * n * n), B(bench_pool * n * n);
+    std::vector<TR> C(n * n);
+    std::vector<cd> Ha, Hb;
+    double err = 0;
+    for (int p = 0; p < bench_pool; p++) {
+        gen_channel(chan, n, Ha);
+        gen_channel(chan, n, Hb);
+        to_type(Ha, &A[p * n * n]);
+        to_type(Hb, &B[p * n * n]);
+        c_matmultiple_hw_pro<TA, TA, TR>(&A[p * n * n], 1, &B[p * n * n], 0, n, n, n, n, C.data());
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++) {
+                cd s = 0;
+                for (int k = 0; k < n; k++)
+                    s += std::conj(at(&A[p * n * n], k * n + i)) * at(&B[p * n * n], k * n + j);
+                err = fmax(err, std::abs(at(C.data(), i * n + j) - s));
+            }
+    }
+    ctx.run("matmul", "c_matmultiple_hw_pro", type, n, n * n, err, [&](int p) {
+        c_matmultiple_hw_pro<TA, TA, TR>(&A[p * n * n], 1, &B[p * n * n], 0, n, n, n, n, C.data());
+    });
+}
+
+/*********************************求逆************************************/
+template<typename TC>
+static void bench_inverse(bench_ctx& ctx, const char* name, const char* type, int n, double reg,
+                          splitmix64_rng& chan, void (*inv)(TC*))
+{
+    if (!ctx.want("inverse", name))
+        return;
+    std::vector<TC> A(bench_pool * n * n), work(n * n);
+    std::vector<cd> H, G(n * n), Ginv(n * n);
+    double err = 0;
+    for (int p = 0; p < bench_pool; p++) {
+        gen_channel(chan, n, H);
+        ref_gram_reg(H.data(), n, reg, G.data());
+        ref_inverse(G.data(), n, Ginv.data());
+        to_type(G, &A[p * n * n]);
+        memcpy(work.data(), &A[p * n * n], n * n * sizeof(TC));
+        inv(work.data());
+        double e = 0, r = 0;
+        for (int i = 0; i < n * n; i++) {
+            e += std::norm(at(work.data(), i) - Ginv[i]);
+            r += std::norm(Ginv[i]);
+        }
+        err = fmax(err, sqrt(e / r));
+    }
+    ctx.run("inverse", name, type, n, 1, err, [&](int p) {
+        memcpy(work.data(), &A[p * n * n], n * n * sizeof(TC));
+        inv(work.data());
+    });
+}
+static void inverse_lu_hw(MyComplex* A) { Inverse_LU_hw<MyComplex>(A); }
+template<int N, int RECIP>
+static void inverse_ldl_fixed(MyComplex* A) { Inverse_LDL_fixed<N, RECIP>(A); }
+
+/*Inverse_LDL_fixed中D的倒数：查表加牛顿迭代与40位除法器，输入在[2^-6, 2^6)内按对数均匀分布，err为最大相对误差*/
+static void bench_recip(bench_ctx& ctx, std::mt19937_64& gen)
+{
+    std::uniform_real_distribution<double> uni(-6.0, 6.0);
+    std::vector<like_float> d(bench_syms), r(bench_syms);
+    double err_lut = 0, err_div = 0;
+    for (int i = 0; i < bench_syms; i++) {
+        d[i] = exp2(uni(gen));
+        const double ref = 1.0 / (double)d[i];
+        err_lut = fmax(err_lut, fabs((double)recip_lut_hw(d[i]) * (double)d[i] - 1.0));
+        err_div = fmax(err_div, fabs((double)hls_internal::generic_divide((like_float)1, d[i]) / ref - 1.0));
+    }
+    ctx.run("recip", "recip_lut_hw", "ap_fixed<40,8>", bench_syms, bench_syms, err_lut, [&](int) {
+        for (int i = 0; i < bench_syms; i++)
+            r[i] = recip_lut_hw(d[i]);
+    });
+    ctx.run("recip", "generic_divide", "ap_fixed<40,8>", bench_syms, bench_syms, err_div, [&](int) {
+        for (int i = 0; i < bench_syms; i++)
+            r[i] = hls_internal::generic_divide((like_float)1, d[i]);
+    });
+}
+
+/*********************************星座映射与floor************************************/
+/*双精度参考：x/(2*dqam)取floor后映射到奇数格点并限幅，再乘dqam*/
+static double map_ref(double x, double dqam, int amp_max)
+{
+    double v = 2 * floor(x / (2 * dqam)) + 1;
+    v = v > amp_max ? amp_max : (v < -amp_max ? -amp_max : v);
+    return v * dqam;
+}
+/*浮点基线：同一算法的float实现*/
+static void map_float(float dqam, const MyComplex_f* x, MyComplex_f* x_hat, int n, int amp_max)
+{
+    const float div = 2 * dqam;
+    for (int i = 0; i < n; i++) {
+        float re = 2 * floorf(x[i].real / div) + 1, im = 2 * floorf(x[i].imag / div) + 1;
+        re = fminf(fmaxf(re, (float)-amp_max), (float)amp_max);
+        im = fminf(fmaxf(im, (float)-amp_max), (float)amp_max);
+        x_hat[i].real = re * dqam;
+        x_hat[i].imag = im * dqam;
+    }
+}
+template<typename TX, typename TH, typename XR, typename HR>
+static void bench_map(bench_ctx& ctx, const char* type, double dqam, std::mt19937_64& gen)
+{
+    const int N = Ntr_1, amp = qam_traits<mu_1>::amp_max;
+    std::uniform_real_distribution<double> uni(-1.2 * amp * dqam, 1.2 * amp * dqam);
+    std::vector<TX> x(bench_pool * N);
+    std::vector<TH> x_hat(N);
+    long bad = 0;
+    for (int p = 0; p < bench_pool; p++) {
+        for (int i = 0; i < N; i++) {
+            x[p * N + i].real = uni(gen);
+            x[p * N + i].imag = uni(gen);
+        }
+        map_hw<TX, TH, XR, HR, N, mu_1>(dqam, &x[p * N], x_hat.data());
+        for (int i = 0; i < N; i++) {
+            bad += fabs((double)x_hat[i].real - map_ref((double)x[p * N + i].real, (double)(like_float)dqam, amp)) > 1e-4;
+            bad += fabs((double)x_hat[i].imag - map_ref((double)x[p * N + i].imag, (double)(like_float)dqam, amp)) > 1e-4;
+        }
+    }
+    ctx.run("map", "map_hw", type, N, N, (double)bad / (2.0 * bench_pool * N), [&](int p) {
+        map_hw<TX, TH, XR, HR, N, mu_1>(dqam, &x[p * N], x_hat.data());
+    });
+}
+template<typename T>
+static void bench_floor(bench_ctx& ctx, const char* type, std::mt19937_64& gen)
+{
+    std::uniform_real_distribution<double> uni(-7.9, 7.9);
+    std::vector<T> v(bench_syms), r(bench_syms);
+    long bad = 0;
+    for (int i = 0; i < bench_syms; i++) {
+        v[i] = uni(gen);
+        bad += (double)fixed_floor<T>(v[i]) != floor((double)v[i]);
+    }
+    ctx.run("floor", "fixed_floor", type, bench_syms, bench_syms, (double)bad / bench_syms, [&](int) {
+        for (int i = 0; i < bench_syms; i++)
+            r[i] = fixed_floor<T>(v[i]);
+    });
+}
+
+/*********************************解调************************************/
+/*星座点（归一化）加高斯噪声，噪声标准差为最小间距的1/4*/
+template<int MU>
+static void bench_demod(bench_ctx& ctx, std::mt19937_64& gen)
+{
+    const int Ma = 1 << (MU / 2);
+    const double unit = 1.0 / sqrt((double)qam_slicer_traits<MU>::energy);
+    std::uniform_int_distribution<int> lvl(0, Ma - 1);
+    std::normal_distribution<double> g(0.0, 0.5 * unit);
+    std::vector<MyComplex> x(bench_syms);
+    std::vector<double> x_re(bench_syms), x_im(bench_syms);
+    std::vector<int> b_ref(bench_syms * MU), b_test(bench_syms * MU);
+    for (int i = 0; i < bench_syms; i++) {
+        x[i].real = (2 * lvl(gen) - (Ma - 1)) * unit + g(gen);
+        x[i].imag = (2 * lvl(gen) - (Ma - 1)) * unit + g(gen);
+        x_re[i] = (double)x[i].real;
+        x_im[i] = (double)x[i].imag;
+    }
+    const qam_slicer_batch batch(MU);
+    char type[16];
+    snprintf(type, sizeof(type), "mu=%d", MU);
+    if (MU <= 6)
+        QAM_Demodulation_hw(x.data(), bench_syms, MU, b_ref.data());
+    else
+        batch(x_re.data(), x_im.data(), bench_syms, b_ref.data());
+    if (MU <= 6)
+        ctx.run("demod", "QAM_Demodulation_hw", type, bench_syms, bench_syms, 0.0, [&](int) {
+            QAM_Demodulation_hw(x.data(), bench_syms, MU, b_test.data());
+        });
+    QAM_Slicer_hw(x.data(), bench_syms, MU, b_test.data());
+    double err = (double)unequal_times_hw(b_ref.data(), b_test.data(), bench_syms * MU) / (bench_syms * MU);
+    ctx.run("demod", "QAM_Slicer_hw", type, bench_syms, bench_syms, err, [&](int) {
+        QAM_Slicer_hw(x.data(), bench_syms, MU, b_test.data());
+    });
+    batch(x_re.data(), x_im.data(), bench_syms, b_test.data());
+    err = (double)unequal_times_hw(b_ref.data(), b_test.data(), bench_syms * MU) / (bench_syms * MU);
+    ctx.run("demod", "qam_slicer_batch", type, bench_syms, bench_syms, err, [&](int) {
+        batch(x_re.data(), x_im.data(), bench_syms, b_test.data());
+    });
+}
+
+/*********************************随机数************************************/
+static void bench_rng(bench_ctx& ctx)
+{
+    const int R = 256;/*每次调用产生的随机数个数*/
+    unsigned int seed = 12345;
+    volatile unsigned int sink_u = 0;
+    volatile double sink_d = 0;
+    ctx.run("rng", "lcg_rand_hw", "uint31", R, R, NAN, [&](int) {
+        unsigned int s = 0;
+        for (int i = 0; i < R; i++) s ^= lcg_rand_hw();
+        sink_u = s;
+    });
+    ctx.run("rng", "lcg_rand_hw_opt", "uint31", R, R, NAN, [&](int) {
+        unsigned int s = 0;
+        for (int i = 0; i < R; i++) s ^= lcg_rand_hw_opt(seed);
+        sink_u = s;
+    });
+    ctx.run("rng", "lcg_rand_1_hw_fixed", "ap_fixed<40,8>", R, R, NAN, [&](int) {
+        like_float s = 0;
+        for (int i = 0; i < R; i++) s += lcg_rand_1_hw_fixed(seed);
+        sink_d = (double)s;
+    });
+    int x_init[Ntr_1];
+    ctx.run("rng", "generateUniformRandoms_int_hw_pro_0", "int", Ntr_1, Ntr_1, NAN, [&](int) {
+        generateUniformRandoms_int_hw_pro_0<Ntr_1, mu_1>(seed, x_init);
+    });
+    like_float p_uni[10];
+    ctx.run("rng", "generateUniformRandoms_float_hw_pro", "ap_fixed<40,8>", 10, 10, NAN, [&](int) {
+        generateUniformRandoms_float_hw_pro(seed, p_uni);
+    });
+    ctx.run("rng", "gauss_rand_hw", "ap_fixed<20,4>", R, R, NAN, [&](int) {
+        MyComplex_v v;
+        double s = 0;
+        for (int i = 0; i < R; i++) {
+            gauss_rand_hw(seed, v);
+            s += (double)v.real;
+        }
+        sink_d = s;
+    });
+    /*浮点基线：标准库的均匀分布与Box-Muller同等用途的正态分布*/
+    std::mt19937 mt(12345);
+    std::uniform_real_distribution<float> fu(0.0f, 1.0f);
+    std::normal_distribution<float> fg(0.0f, sqrtf(0.5f));
+    ctx.run("rng", "std::uniform_real(mt19937)", "float", R, R, NAN, [&](int) {
+        float s = 0;
+        for (int i = 0; i < R; i++) s += fu(mt);
+        sink_d = s;
+    });
+    ctx.run("rng", "std::normal(mt19937)", "float", R, R, NAN, [&](int) {
+        float s = 0;
+        for (int i = 0; i < R; i++) s += fg(mt);
+        sink_d = s;
+    });
+}
+
+/*********************************输出************************************/
+static void json_num(FILE* f, double v)
+{
+    if (isnan(v))
+        fprintf(f, "null");
+    else
+        fprintf(f, "%.6g", v);
+}
+static void write_json(FILE* f, const bench_ctx& ctx)
+{
+    fprintf(f, "{\n  \"min_ms\": %g, \"Ntr_1\": %d, \"mu_1\": %d,\n  \"results\": [\n", ctx.min_ms, Ntr_1, mu_1);
+    for (size_t i = 0; i < ctx.out.size(); i++) {
+        const bench_record& r = ctx.out[i];
+        fprintf(f, "    {\"group\": \"%s\", \"name\": \"%s\", \"type\": \"%s\", \"n\": %d, \"calls\": %ld, \"ns_per_call\": ",
+                r.group.c_str(), r.name.c_str(), r.type.c_str(), r.n, r.calls);
+        json_num(f, r.ns_per_call);
+        fprintf(f, ", \"ns_per_item\": ");
+        json_num(f, r.ns_per_call / r.items);
+        fprintf(f, ", \"err\": ");
+        json_num(f, r.err);
+        fprintf(f, "}%s\n", i + 1 < ctx.out.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char** argv)
+{
+    bench_ctx ctx;
+    ctx.min_ms = 50;
+    ctx.filter = NULL;
+    const char* json_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc)
+            ctx.min_ms = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            ctx.filter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--min-ms T] [--filter S] [--json out.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    std::mt19937_64 gen(2024);
+    splitmix64_rng chan;
+    chan.reset(2024, 0);
+
+    /*矩阵乘法：浮点输入、ap_fixed<40,8>、内核H^H*H的位宽（H为ap_fixed<20,4>，结果为ap_fixed<24,4>）*/
+    const int mm_sizes[] = { 4, 8, 16, 32 };
+    for (int n : mm_sizes) {
+        bench_matmul<MyComplex_f, MyComplex_f>(ctx, "float", n, chan);
+        bench_matmul<MyComplex, MyComplex>(ctx, "ap_fixed<40,8>", n, chan);
+        bench_matmul<MyComplex_H, MyComplex_HH>(ctx, "ap_fixed<20,4>->24,4", n, chan);
+    }
+
+    /*求逆：正则项取16QAM、15 dB时grad_preconditioner的sigma2/dqam^2；浮点实现与Inverse_LU_hw固定为Ntr_1阶*/
+    const double dqam_16 = sqrt(1.5 / 15.0);
+    const double reg = pow(10.0, -1.5) / (dqam_16 * dqam_16);
+    bench_inverse<MyComplex_f>(ctx, "Inverse_LU", "float", Ntr_1, reg, chan, Inverse_LU);
+    bench_inverse<MyComplex_f>(ctx, "Inverse_LDL", "float", Ntr_1, reg, chan, Inverse_LDL);
+    bench_inverse<MyComplex_f>(ctx, "Inverse_LDL_pro", "float", Ntr_1, reg, chan, Inverse_LDL_pro);
+    bench_inverse<MyComplex_f>(ctx, "Inverse_QR", "float", Ntr_1, reg, chan, Inverse_QR);
+    bench_inverse<MyComplex_f>(ctx, "Inverse_Cholesky", "float", Ntr_1, reg, chan, Inverse_Cholesky);
+    bench_inverse<MyComplex>(ctx, "Inverse_LU_hw", "ap_fixed<40,8>", Ntr_1, reg, chan, inverse_lu_hw);
+    /*定点LDL两种倒数实现各测一遍：_lut为默认的recip_lut_hw，_div为LDL_RECIP_DIVIDER的除法器*/
+    const int ldl_sizes[] = { 4, Ntr_1, 16 };
+    void (*const ldl_lut[])(MyComplex*) = { inverse_ldl_fixed<4, ldl_recip_lut>, inverse_ldl_fixed<Ntr_1, ldl_recip_lut>, inverse_ldl_fixed<16, ldl_recip_lut> };
+    void (*const ldl_div[])(MyComplex*) = { inverse_ldl_fixed<4, ldl_recip_div>, inverse_ldl_fixed<Ntr_1, ldl_recip_div>, inverse_ldl_fixed<16, ldl_recip_div> };
+    for (int k = 0; k < 3; k++) {
+        bench_inverse<MyComplex>(ctx, "Inverse_LDL_fixed_lut", "ap_fixed<40,8>", ldl_sizes[k], reg, chan, ldl_lut[k]);
+        bench_inverse<MyComplex>(ctx, "Inverse_LDL_fixed_div", "ap_fixed<40,8>", ldl_sizes[k], reg, chan, ldl_div[k]);
+    }
+    bench_recip(ctx, gen);
+
+    /*星座映射：ap_fixed<40,8>与samplers_process中的z_prop（ap_fixed<20,6>）→x_prop；浮点为同算法的float基线*/
+    const double dqam = sqrt(1.5 / ((1 << mu_1) - 1));
+    bench_map<MyComplex, MyComplex, like_float, Myreal>(ctx, "ap_fixed<40,8>", dqam, gen);
+    bench_map<MyComplex_z_prop, MyComplex_x_prop, z_prop_real_t, x_prop_real_t>(ctx, "ap_fixed<20,6>->40,8", dqam, gen);
+    if (ctx.want("map", "map_float")) {
+        const int amp = qam_traits<mu_1>::amp_max;
+        std::uniform_real_distribution<double> uni(-1.2 * amp * dqam, 1.2 * amp * dqam);
+        std::vector<MyComplex_f> x(bench_pool * Ntr_1), x_hat(Ntr_1);
+        long bad = 0;
+        for (int p = 0; p < bench_pool; p++) {
+            for (int i = 0; i < Ntr_1; i++) {
+                x[p * Ntr_1 + i].real = uni(gen);
+                x[p * Ntr_1 + i].imag = uni(gen);
+            }
+            map_float(dqam, &x[p * Ntr_1], x_hat.data(), Ntr_1, amp);
+            for (int i = 0; i < Ntr_1; i++) {
+                bad += fabs(x_hat[i].real - map_ref(x[p * Ntr_1 + i].real, dqam, amp)) > 1e-4;
+                bad += fabs(x_hat[i].imag - map_ref(x[p * Ntr_1 + i].imag, dqam, amp)) > 1e-4;
+            }
+        }
+        ctx.run("map", "map_float", "float", Ntr_1, Ntr_1, (double)bad / (2.0 * bench_pool * Ntr_1), [&](int p) {
+            map_float(dqam, &x[p * Ntr_1], x_hat.data(), Ntr_1, amp);
+        });
+    }
+    bench_floor<like_float>(ctx, "ap_fixed<40,8>", gen);
+    bench_floor<z_prop_real_t>(ctx, "ap_fixed<20,6>", gen);
+    if (ctx.want("floor", "floorf")) {
+        std::uniform_real_distribution<float> uni(-7.9f, 7.9f);
+        std::vector<float> v(bench_syms), r(bench_syms);
+        for (int i = 0; i < bench_syms; i++)
+            v[i] = uni(gen);
+        ctx.run("floor", "floorf", "float", bench_syms, bench_syms, 0.0, [&](int) {
+            for (int i = 0; i < bench_syms; i++)
+                r[i] = floorf(v[i]);
+        });
+    }
+
+    bench_demod<2>(ctx, gen);
+    bench_demod<4>(ctx, gen);
+    bench_demod<6>(ctx, gen);
+    bench_demod<8>(ctx, gen);
+
+    bench_rng(ctx);
+
+    if (json_path) {
+        FILE* f = fopen(json_path, "w");
+        if (!f) {
+            fprintf(stderr, "cannot open %s\n", json_path);
+            return 1;
+        }
+        write_json(f, ctx);
+        fclose(f);
+    } else {
+        write_json(stdout, ctx);
+    }
+    return 0;
+}
@@ -0,0 +1,441 @@
+/*
+ * 多线程BER仿真驱动：在C级模型上跑大帧数、多SNR点的误码率统计。
+ * 用法：mhgd_ber <master_seed> <max_frames_per_snr> [threads] [SNR ...] [--errors N] [--csv out.csv] [--json out.json]
+ *   threads=0时取std::thread::hardware_concurrency()；SNR(dB)可为单值"15"或闭区间"0:30"、"0:2.5:30"，
+ *   未给出SNR时只跑25 dB。
+ *   --errors N：SNR点累计误比特数达到N即停止（低SNR时很快到达），否则跑满帧数上限（高SNR）。
+ *   --csv/--json：输出BER表，每点含帧数、比特数、误比特数、BER、95% Wilson置信区间与停止原因。
+ * 信道与发送符号由mhgd_testref.h的ref_gen_frame生成（同MULTI_CFG_VERIFY）：H ~ CN(0, 1/Nr)，符号在星座上均匀随机，
+ * sigma2 = Nt/Nr * 10^(-SNR/10)，参考比特由QAM_Slicer_hw解调发送符号得到。
+ *
+ * 按轮推进：每轮为所有未停止的SNR点安排一批帧（按当前误码率估计到达目标所需帧数，64~8192帧），
+ * 轮末归约并判定停止。任务划分：本轮全部(SNR点, 帧)编号为一维任务，初始按线程均分为连续区间；
+ * 每个线程从自己区间的头部每次取ber_chunk_frames帧，区间取空后轮询其他线程，从其区间尾部窃取一半（不足一块时整块取走），
+ * 所有区间都空即退出。每个区间一把互斥锁，只在取块/窃取时持有，检测本身不加锁。
+ * 每个线程独占一份暂存（H/y/x_hat/比特/高斯表）与随机源，误比特数与帧数按SNR点分线程累加，轮末归约。
+ * 第f帧的信道、符号、噪声与采样器种子只由(master_seed, SNR值, f)决定，停止判定只在轮末进行，
+ * 因此任意线程数下同一master_seed的结果逐位相同。
+ *
+ * 编译：make -C xclbin_host ber [BER_CPU=1]，或
+ *   g++ -std=c++14 -O2 -pthread -I$XILINX_HLS/include MHGD_accel_hw.cpp mhgd_ber.cpp -o mhgd_ber
+ */
+#include "MHGD_accel_hw.h"
+#include "MyComplex_1.h"
+#include "mhgd_seed.h"
+#include "mhgd_testref.h"
+#include "qam_slicer.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <chrono>
+
+// #define BER_CPU_ENGINE	// 打开后：检测改用浮点CPU引擎MHGD_detect_cpu（需同时编译MHGD_cpu.cpp），默认为定点C仿真模型MHGD_detect_accel_hw
+#ifdef BER_CPU_ENGINE
+#include "MHGD_cpu.h"
+#define BER_DETECT MHGD_detect_cpu
+#else
+#define BER_DETECT MHGD_detect_accel_hw
+#endif
+
+static const int ber_chunk_frames = 16;/*线程每次从区间中取出的帧数*/
+static const int64_t ber_round_min = 64;/*提前停止模式下每个SNR点一轮的最少/最多帧数*/
+static const int64_t ber_round_max = 8192;
+
+/*每个线程独占的状态：待处理区间、暂存、随机源与统计*/
+struct ber_worker {
+    std::mutex m;
+    int64_t lo, hi;/*尚未被取走的任务区间[lo, hi)*/
+    splitmix64_rng rng;/*逐帧随机源，起点由(该点seed, 帧号)确定*/
+    float Hr[Ntr_2], Hi[Ntr_2], yr[Ntr_1], yi[Ntr_1];
+    H_real_t H_real[Ntr_2];
+    H_imag_t H_imag[Ntr_2];
+    y_real_t y_real[Ntr_1];
+    y_imag_t y_imag[Ntr_1];
+    Myreal x_hat_real[Ntr_1];
+    Myimage x_hat_imag[Ntr_1];
+    MyComplex x[Ntr_1], x_hat[Ntr_1];
+    unsigned int seed[samplers];
+    int bits[Ntr_1 * mu_1], bits_demod[Ntr_1 * mu_1];
+#ifdef SOFT_OUTPUT
+    llr_t llr[Ntr_1 * mu_1];/*BER只统计硬判决，软输出仅为满足接口*/
+#endif
+#if defined(PROFILE_STAGES) && !defined(BER_CPU_ENGINE)
+    unsigned int prof[2 + PROF_SAMPLER_BASE + 2 * samplers];/*同上，分段计时记录不统计*/
+#endif
+#if defined(PACKED_AXI) && !defined(BER_CPU_ENGINE)
+    axi_word_t H_pack[H_words_1], y_pack[y_words_1], x_hat_pack[x_words_1];/*打包端口，CPU引擎仍为分离的实虚部*/
+#endif
+#ifdef GAUSS_TABLE_MODE
+    v_real_t v_tb_real[samplers * num_ran];
+    v_imag_t v_tb_imag[samplers * num_ran];
+#endif
+    std::vector<uint64_t> error_bits, frames;/*按SNR点累加*/
+    uint64_t steals;
+};
+
+/*一个SNR点的累计结果*/
+struct ber_point {
+    float snr_db;
+    float sigma2;
+    uint64_t seed;/*该点各帧随机源与采样器种子的起点，只由master_seed与SNR值决定*/
+    uint64_t frames, error_bits;
+    const char* stop;/*NULL：尚未结束；"errors"：达到目标误比特数；"frames"：达到帧数上限*/
+    int64_t round_frames;/*本轮该点的帧数*/
+};
+
+struct ber_campaign {
+    uint64_t master_seed;
+    int max_frames;/*每个SNR点的帧数上限*/
+    uint64_t target_errors;/*每个SNR点的目标误比特数，0表示不提前停止*/
+    std::vector<ber_point> points;
+    std::vector<int> active;/*本轮参与的点*/
+    std::vector<int64_t> round_off;/*本轮任务编号前缀和：active[i]的任务为[round_off[i], round_off[i+1])*/
+    std::vector<ber_worker*> workers;
+};
+
+/*从自己的区间头部取一块；成功时返回true并给出[b, e)*/
+static bool take_own(ber_worker& w, int64_t& b, int64_t& e)
+{
+    std::lock_guard<std::mutex> lk(w.m);
+    if (w.lo >= w.hi)
+        return false;
+    b = w.lo;
+    e = std::min(w.lo + ber_chunk_frames, w.hi);
+    w.lo = e;
+    return true;
+}
+
+/*从其他线程区间尾部窃取一半放入自己的区间；所有区间均空时返回false*/
+static bool steal(ber_campaign& c, int self)
+{
+    const int n = (int)c.workers.size();
+    for (int k = 1; k < n; k++) {
+        ber_worker& v = *c.workers[(self + k) % n];
+        int64_t b, e;
+        {
+            std::lock_guard<std::mutex> lk(v.m);
+            int64_t left = v.hi - v.lo;
+            if (left <= 0)
+                continue;
+            b = left <= ber_chunk_frames ? v.lo : v.hi - left / 2;
+            e = v.hi;
+            v.hi = b;
+        }
+        ber_worker& w = *c.workers[self];
+        std::lock_guard<std::mutex> lk(w.m);
+        w.lo = b;
+        w.hi = e;
+        w.steals++;
+        return true;
+    }
+    return false;
+}
+
+/*生成第frame帧并检测，返回误比特数*/
+static int run_frame(const ber_campaign& c, ber_worker& w, int pt, int frame)
+{
+    const int Nt = Ntr_1, Nr = Ntr_1, mu = mu_1;
+    const float sigma2 = c.points[pt].sigma2;
+    splitmix64_rng& rng = w.rng;
+    int l;
+    rng.reset(c.points[pt].seed, (uint64_t)frame);
+    ref_gen_frame<mu_1>(rng, Nt, Nr, sigma2, w.Hr, w.Hi, w.x, w.yr, w.yi);
+    for (l = 0; l < Nr * Nt; l++) {
+        w.H_real[l] = w.Hr[l];
+        w.H_imag[l] = w.Hi[l];
+    }
+    for (l = 0; l < Nr; l++) {
+        w.y_real[l] = w.yr[l];
+        w.y_imag[l] = w.yi[l];
+    }
+    for (l = 0; l < samplers; l++)
+        w.seed[l] = generate_seed(c.points[pt].seed, frame, l);
+#ifdef GAUSS_TABLE_MODE
+    for (l = 0; l < samplers * num_ran; l++) {
+        float a, b;
+        rng.gauss2(a, b);
+        w.v_tb_real[l] = a * sqrtf(0.5f);
+        w.v_tb_imag[l] = b * sqrtf(0.5f);
+    }
+#endif
+#if defined(PACKED_AXI) && !defined(BER_CPU_ENGINE)
+    axi_pack_array(w.H_real, w.H_imag, Nr * Nt, w.H_pack);
+    axi_pack_array(w.y_real, w.y_imag, Nr, w.y_pack);
+    BER_DETECT(w.x_hat_pack, w.H_pack, w.y_pack,
+#else
+    BER_DETECT(w.x_hat_real, w.x_hat_imag, w.H_real, w.H_imag, w.y_real, w.y_imag,
+#endif
+#ifdef GAUSS_TABLE_MODE
+        w.v_tb_real, w.v_tb_imag,
+#endif
+        sigma2, w.seed
+#ifdef SOFT_OUTPUT
+        , w.llr, mhgd_llr_gain(sigma2, mu_1)
+#endif
+#if defined(PROFILE_STAGES) && !defined(BER_CPU_ENGINE)
+        , w.prof
+#endif
+    );
+#if defined(PACKED_AXI) && !defined(BER_CPU_ENGINE)
+    axi_unpack_array(w.x_hat_pack, Nt, w.x_hat_real, w.x_hat_imag);
+#endif
+    for (l = 0; l < Nt; l++) {
+        w.x_hat[l].real = w.x_hat_real[l];
+        w.x_hat[l].imag = w.x_hat_imag[l];
+    }
+    QAM_Slicer_hw(w.x, Nt, mu, w.bits);
+    QAM_Slicer_hw(w.x_hat, Nt, mu, w.bits_demod);
+    return unequal_times_hw(w.bits_demod, w.bits, Nt * mu);
+}
+
+static void ber_worker_main(ber_campaign* c, int self)
+{
+    ber_worker& w = *c->workers[self];
+    for (;;) {
+        int64_t b, e;
+        while (take_own(w, b, e)) {
+            for (int64_t t = b; t < e; t++) {
+                int i = (int)(std::upper_bound(c->round_off.begin(), c->round_off.end(), t) - c->round_off.begin()) - 1;
+                int pt = c->active[i];
+                int f = (int)(c->points[pt].frames + (t - c->round_off[i]));
+                w.error_bits[pt] += run_frame(*c, w, pt, f);
+                w.frames[pt]++;
+            }
+        }
+        if (!steal(*c, self))
+            return;
+    }
+}
+
+/*
+ * 下一轮的帧数：未设目标误比特数时按ber_round_max推进；否则按当前误码率估计到达目标还需的帧数，
+ * 尚无误码时逐轮翻倍。只依赖已完成的计数，与线程数无关。
+ */
+static int64_t next_round(const ber_campaign& c, const ber_point& p)
+{
+    int64_t n;
+    if (c.target_errors == 0)
+        n = ber_round_max;
+    else if (p.error_bits == 0)
+        n = (int64_t)p.frames;
+    else
+        n = (int64_t)((double)(c.target_errors - p.error_bits) * (double)p.frames / (double)p.error_bits) + 1;
+    n = std::max(ber_round_min, std::min(ber_round_max, n));
+    return std::min(n, (int64_t)c.max_frames - (int64_t)p.frames);
+}
+
+/*BER的95% Wilson置信区间，按比特独立近似（同一帧内的错误比特相关，实际不确定度略大）*/
+static void wilson_ci(uint64_t err, uint64_t n, double& lo, double& hi)
+{
+    const double z = 1.959963984540054;
+    if (n == 0) {
+        lo = 0; hi = 1;
+        return;
+    }
+    double p = (double)err / (double)n, z2n = z * z / (double)n;
+    double center = (p + z2n / 2) / (1 + z2n);
+    double half = z * sqrt(p * (1 - p) / (double)n + z2n / (4.0 * (double)n)) / (1 + z2n);
+    lo = std::max(0.0, center - half);
+    hi = std::min(1.0, center + half);
+}
+
+/*解析一个SNR参数：单值"15"，或闭区间"a:b"（步长1）/"a:step:b"*/
+static bool parse_snr(const char* arg, std::vector<float>& out)
+{
+    double v[3];
+    int n = sscanf(arg, "%lf:%lf:%lf", &v[0], &v[1], &v[2]);
+    if (n == 1) {
+        out.push_back((float)v[0]);
+        return true;
+    }
+    double a = v[0], step = n == 3 ? v[1] : 1.0, b = n == 3 ? v[2] : v[1];
+    if (n < 2 || step == 0 || (b - a) / step < 0)
+        return false;
+    int count = (int)floor((b - a) / step + 1e-6) + 1;
+    for (int k = 0; k < count; k++)
+        out.push_back((float)(a + k * step));
+    return true;
+}
+
+static void write_csv(const char* path, const ber_campaign& c)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) { perror(path); return; }
+    fprintf(f, "snr_db,frames,bits,error_bits,ber,ci95_low,ci95_high,stop\n");
+    for (size_t i = 0; i < c.points.size(); i++) {
+        const ber_point& p = c.points[i];
+        uint64_t bits = p.frames * Ntr_1 * mu_1;
+        double lo, hi;
+        wilson_ci(p.error_bits, bits, lo, hi);
+        fprintf(f, "%.2f,%llu,%llu,%llu,%.9g,%.9g,%.9g,%s\n", p.snr_db, (unsigned long long)p.frames, (unsigned long long)bits,
+            (unsigned long long)p.error_bits, bits ? (double)p.error_bits / (double)bits : 0.0, lo, hi, p.stop);
+    }
+    fclose(f);
+}
+
+static void write_json(const char* path, const ber_campaign& c, const char* engine)
+{
+    FILE* f = fopen(path, "w");
+    if (!f) { perror(path); return; }
+    fprintf(f, "{\n  \"master_seed\": %llu,\n  \"Nt\": %d, \"Nr\": %d, \"mu\": %d, \"samplers\": %d, \"engine\": \"%s\",\n",
+        (unsigned long long)c.master_seed, Ntr_1, Ntr_1, mu_1, samplers, engine);
+    fprintf(f, "  \"max_frames\": %d, \"target_errors\": %llu,\n  \"points\": [\n", c.max_frames, (unsigned long long)c.target_errors);
+    for (size_t i = 0; i < c.points.size(); i++) {
+        const ber_point& p = c.points[i];
+        uint64_t bits = p.frames * Ntr_1 * mu_1;
+        double lo, hi;
+        wilson_ci(p.error_bits, bits, lo, hi);
+        fprintf(f, "    {\"snr_db\": %.2f, \"frames\": %llu, \"bits\": %llu, \"error_bits\": %llu, \"ber\": %.9g, \"ci95\": [%.9g, %.9g], \"stop\": \"%s\"}%s\n",
+            p.snr_db, (unsigned long long)p.frames, (unsigned long long)bits, (unsigned long long)p.error_bits,
+            bits ? (double)p.error_bits / (double)bits : 0.0, lo, hi, p.stop, i + 1 < c.points.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+int main(int argc, char** argv)
+{
+    ber_campaign c;
+    const char* csv_path = NULL;
+    const char* json_path = NULL;
+    std::vector<char*> pos;/*位置参数，pos[0]为程序名*/
+    c.target_errors = 0;
+    pos.push_back(argv[0]);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--errors") == 0 && i + 1 < argc)
+            c.target_errors = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csv_path = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else
+            pos.push_back(argv[i]);
+    }
+    if (pos.size() < 3) {
+        fprintf(stderr, "usage: %s <master_seed> <max_frames_per_snr> [threads] [SNR_dB | a:b | a:step:b ...]\n"
+                        "          [--errors N] [--csv out.csv] [--json out.json]\n", argv[0]);
+        return 1;
+    }
+    c.master_seed = parse_master_seed((int)pos.size(), pos.data());
+    c.max_frames = atoi(pos[2]);
+    int threads = pos.size() > 3 ? atoi(pos[3]) : 0;
+    if (threads <= 0)
+        threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0)
+        threads = 1;
+    std::vector<float> snr_db;
+    for (size_t i = 4; i < pos.size(); i++) {
+        if (!parse_snr(pos[i], snr_db)) {
+            fprintf(stderr, "bad SNR argument: %s\n", pos[i]);
+            return 1;
+        }
+    }
+    if (snr_db.empty())
+        snr_db.push_back(25);
+    const int n_snr = (int)snr_db.size();
+    for (int s = 0; s < n_snr; s++) {
+        ber_point p;
+        p.snr_db = snr_db[s];
+        p.sigma2 = (float)Ntr_1 / (float)Ntr_1 * pow(10.0f, -snr_db[s] / 10.0f);
+        /*按SNR值（0.001 dB分辨率）取种子，同一SNR点在不同扫描列表中得到相同的帧序列*/
+        p.seed = splitmix64(c.master_seed ^ splitmix64((uint64_t)llround(snr_db[s] * 1000.0)));
+        p.frames = 0;
+        p.error_bits = 0;
+        p.stop = NULL;
+        p.round_frames = 0;
+        c.points.push_back(p);
+    }
+#ifdef BER_CPU_ENGINE
+    const char* engine = mhgd_cpu_kernels_get().isa;
+#else
+    const char* engine = "csim";
+#endif
+    printf("master seed = %llu, %dx%d mu=%d samplers=%d, %d SNR points, <= %d frames/SNR, target errors = %llu, %d threads, engine = %s\n",
+        (unsigned long long)c.master_seed, Ntr_1, Ntr_1, mu_1, samplers, n_snr, c.max_frames,
+        (unsigned long long)c.target_errors, threads, engine);
+
+    for (int k = 0; k < threads; k++) {
+        ber_worker* w = new ber_worker;
+        w->error_bits.assign(n_snr, 0);
+        w->frames.assign(n_snr, 0);
+        w->steals = 0;
+        c.workers.push_back(w);
+    }
+
+    /*
+     * 按轮推进：每轮为所有未结束的点各安排next_round()帧，合成一个任务区间交给线程池，
+     * 轮末归约计数并判定各点是否停止。停止判定只在轮末进行，结果与线程数无关。
+     */
+    auto t0 = std::chrono::high_resolution_clock::now();
+    int64_t total_frames = 0;
+    int rounds = 0;
+    for (;;) {
+        c.active.clear();
+        c.round_off.assign(1, 0);
+        for (int s = 0; s < n_snr; s++) {
+            ber_point& p = c.points[s];
+            if (p.stop)
+                continue;
+            p.round_frames = next_round(c, p);
+            c.active.push_back(s);
+            c.round_off.push_back(c.round_off.back() + p.round_frames);
+        }
+        if (c.active.empty())
+            break;
+        /*初始划分：本轮任务[0, tasks)按线程均分*/
+        const int64_t tasks = c.round_off.back();
+        for (int k = 0; k < threads; k++) {
+            c.workers[k]->lo = tasks * k / threads;
+            c.workers[k]->hi = tasks * (k + 1) / threads;
+        }
+        std::vector<std::thread> pool;
+        for (int k = 0; k < threads; k++)
+            pool.push_back(std::thread(ber_worker_main, &c, k));
+        for (int k = 0; k < threads; k++)
+            pool[k].join();
+        /*归约*/
+        for (size_t i = 0; i < c.active.size(); i++) {
+            ber_point& p = c.points[c.active[i]];
+            p.frames = 0;
+            p.error_bits = 0;
+            for (int k = 0; k < threads; k++) {
+                p.frames += c.workers[k]->frames[c.active[i]];
+                p.error_bits += c.workers[k]->error_bits[c.active[i]];
+            }
+            if (c.target_errors && p.error_bits >= c.target_errors)
+                p.stop = "errors";
+            else if (p.frames >= (uint64_t)c.max_frames)
+                p.stop = "frames";
+        }
+        total_frames += tasks;
+        rounds++;
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double wall_s = std::chrono::duration<double>(t1 - t0).count();
+
+    uint64_t steals = 0;
+    for (int k = 0; k < threads; k++)
+        steals += c.workers[k]->steals;
+    for (int s = 0; s < n_snr; s++) {
+        const ber_point& p = c.points[s];
+        uint64_t bits = p.frames * Ntr_1 * mu_1;
+        double lo, hi;
+        wilson_ci(p.error_bits, bits, lo, hi);
+        printf("SNR = %5.1f dB  frames = %llu  error bits = %llu  BER = %.6e  95%% CI = [%.3e, %.3e]  stop: %s\n",
+            p.snr_db, (unsigned long long)p.frames, (unsigned long long)p.error_bits,
+            bits ? (double)p.error_bits / (double)bits : 0.0, lo, hi, p.stop);
+    }
+    printf("[Perf] %d threads, %lld frames in %d rounds, wall %.3f s, %.1f frames/s, %llu steals\n",
+        threads, (long long)total_frames, rounds, wall_s, total_frames / wall_s, (unsigned long long)steals);
+    if (csv_path)
+        write_csv(csv_path, c);
+    if (json_path)
+        write_json(json_path, c, engine);
+    for (int k = 0; k < threads; k++)
+        delete c.workers[k];
+    return 0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+/*
+ * 二进制帧数据集（.bin）：替代H_SNR=xx.txt / y_SNR=xx.txt / bits_SNR=xx.txt三个文本文件。
+ * 布局：64字节文件头 + frames条定长记录，第f帧记录位于 header_bytes + f*record_bytes，
+ * 每条记录依次为：
+ *   H    : Nr*Nt个复数，行主序(H[i*Nt+j]为第i根接收天线、第j根发射天线)，实虚交错
+ *   y    : Nr个复数，实虚交错
+ *   bits : Nt*mu个比特，每比特1字节(0/1)
+ *   pad  : 补零至8字节对齐
+ * dtype=MHGD_DTYPE_F32时复数分量为float32（小端，与文本文件%f读入后的值逐位一致）。
+ * 读取端用mmap整体映射，按帧取指针，不拷贝、不解析，帧数只受文件大小限制。
+ * 转换工具见mhgd_dataset_convert.cpp。
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MHGD_DATASET_MAGIC "MHGDSET"	/*8字节，含结尾'\0'*/
+#define MHGD_DATASET_VERSION 1
+#define MHGD_DTYPE_F32 0
+
+struct mhgd_dataset_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;	/*记录区起始偏移*/
+    uint32_t Nt, Nr, mu;
+    uint32_t dtype;
+    uint64_t frames;
+    uint64_t record_bytes;	/*单帧记录长度(含对齐填充)*/
+    float snr_db;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(mhgd_dataset_header) == 64, "mhgd_dataset_header must be 64 bytes");
+
+/*单帧记录长度*/
+static inline uint64_t mhgd_record_bytes(uint32_t Nt, uint32_t Nr, uint32_t mu)
+{
+    uint64_t n = (uint64_t)Nr * Nt * 2 * sizeof(float) + (uint64_t)Nr * 2 * sizeof(float) + (uint64_t)Nt * mu;
+    return (n + 7) & ~(uint64_t)7;
+}
+
+static inline void mhgd_header_init(mhgd_dataset_header& h, uint32_t Nt, uint32_t Nr, uint32_t mu, uint64_t frames, float snr_db)
+{
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MHGD_DATASET_MAGIC, sizeof(h.magic));
+    h.version = MHGD_DATASET_VERSION;
+    h.header_bytes = sizeof(mhgd_dataset_header);
+    h.Nt = Nt; h.Nr = Nr; h.mu = mu;
+    h.dtype = MHGD_DTYPE_F32;
+    h.frames = frames;
+    h.record_bytes = mhgd_record_bytes(Nt, Nr, mu);
+    h.snr_db = snr_db;
+}
+
+/*只读映射的数据集。open失败时打印原因并返回false*/
+class mhgd_dataset {
+public:
+    mhgd_dataset() : base_(NULL), size_(0), hdr_(NULL) {}
+    ~mhgd_dataset() { close(); }
+
+    bool open(const char* path)
+    {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) { perror(path); return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(mhgd_dataset_header)) {
+            fprintf(stderr, "%s: too small for a dataset header\n", path);
+            ::close(fd);
+            return false;
+        }
+        size_ = (size_t)st.st_size;
+        base_ = (const uint8_t*)mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);	/*映射建立后即可关闭fd*/
+        if (base_ == (const uint8_t*)MAP_FAILED) { base_ = NULL; perror(path); return false; }
+        madvise((void*)base_, size_, MADV_SEQUENTIAL);
+        hdr_ = (const mhgd_dataset_header*)base_;
+        if (memcmp(hdr_->magic, MHGD_DATASET_MAGIC, sizeof(hdr_->magic)) != 0
+            || hdr_->version != MHGD_DATASET_VERSION || hdr_->dtype != MHGD_DTYPE_F32
+            || hdr_->record_bytes != mhgd_record_bytes(hdr_->Nt, hdr_->Nr, hdr_->mu)) {
+            fprintf(stderr, "%s: not a v%d float32 MHGD dataset\n", path, MHGD_DATASET_VERSION);
+            close();
+            return false;
+        }
+        if (hdr_->header_bytes + hdr_->frames * hdr_->record_bytes > size_) {
+            fprintf(stderr, "%s: truncated (%llu frames declared)\n", path, (unsigned long long)hdr_->frames);
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        if (base_)
+            munmap((void*)base_, size_);
+        base_ = NULL; size_ = 0; hdr_ = NULL;
+    }
+
+    const mhgd_dataset_header& header() const { return *hdr_; }
+    uint64_t frames() const { return hdr_->frames; }
+
+    /*第f帧的H/y：实虚交错的float数组；bits：Nt*mu个0/1字节*/
+    const float* H(uint64_t f) const { return (const float*)record(f); }
+    const float* y(uint64_t f) const { return H(f) + 2 * hdr_->Nr * hdr_->Nt; }
+    const uint8_t* bits(uint64_t f) const { return (const uint8_t*)(y(f) + 2 * hdr_->Nr); }
+
+private:
+    const uint8_t* record(uint64_t f) const { return base_ + hdr_->header_bytes + f * hdr_->record_bytes; }
+
+    const uint8_t* base_;
+    size_t size_;
+    const mhgd_dataset_header* hdr_;
+
+    mhgd_dataset(const mhgd_dataset&);
+    mhgd_dataset& operator=(const mhgd_dataset&);
+};
@@ -0,0 +1,96 @@
+/*
+ * 文本数据 -> 二进制帧数据集（格式见mhgd_dataset.h）
+ * 用法：mhgd_dataset_convert H.txt y.txt bits.txt out.bin Nt Nr mu SNR_dB
+ * 逐帧读取三个文本文件，任一文件在帧边界处读完即停止，帧数写入文件头；
+ * 某一帧只读到一部分或遇到无法解析的内容时报错退出（返回1），不生成输出文件。
+ * 编译：g++ -O2 mhgd_dataset_convert.cpp -o mhgd_dataset_convert
+ */
+#include "mhgd_dataset.h"
+#include <vector>
+
+enum read_status { READ_OK, READ_EOF, READ_BAD };
+
+/*帧开头即到文件末尾为READ_EOF；读到一部分后结束或内容无法解析为READ_BAD*/
+static read_status read_end(FILE* f, uint32_t done)
+{
+    return (done == 0 && feof(f) && !ferror(f)) ? READ_EOF : READ_BAD;
+}
+
+/*读取n个复数（每行"实部 虚部"）*/
+static read_status read_complex(FILE* f, float* dst, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        if (fscanf(f, "%f %f", &dst[2 * i], &dst[2 * i + 1]) != 2)
+            return read_end(f, 2 * i);
+    return READ_OK;
+}
+
+/*读取n个比特（空白分隔的整数，非0即1）*/
+static read_status read_bits(FILE* f, uint8_t* dst, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        int b;
+        if (fscanf(f, "%d", &b) != 1)
+            return read_end(f, i);
+        dst[i] = (uint8_t)(b != 0);
+    }
+    return READ_OK;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 9) {
+        fprintf(stderr, "usage: %s H.txt y.txt bits.txt out.bin Nt Nr mu SNR_dB\n", argv[0]);
+        return 1;
+    }
+    uint32_t Nt = (uint32_t)atoi(argv[5]), Nr = (uint32_t)atoi(argv[6]), mu = (uint32_t)atoi(argv[7]);
+    float snr_db = (float)atof(argv[8]);
+    FILE* fH = fopen(argv[1], "r");
+    FILE* fy = fopen(argv[2], "r");
+    FILE* fb = fopen(argv[3], "r");
+    FILE* fo = fopen(argv[4], "wb");
+    if (!fH || !fy || !fb || !fo) {
+        fprintf(stderr, "cannot open input/output files\n");
+        return 1;
+    }
+
+    mhgd_dataset_header hdr;
+    mhgd_header_init(hdr, Nt, Nr, mu, 0, snr_db);
+    fwrite(&hdr, sizeof(hdr), 1, fo);	/*先占位，结束后回填帧数*/
+
+    std::vector<uint8_t> rec(hdr.record_bytes, 0);
+    float* H = (float*)rec.data();
+    float* y = H + 2 * Nr * Nt;
+    uint8_t* bits = (uint8_t*)(y + 2 * Nr);
+    uint64_t frames = 0;
+    for (;;) {
+        const char* bad = NULL;
+        read_status st = read_complex(fH, H, Nr * Nt);
+        if (st == READ_BAD) bad = argv[1];
+        if (st == READ_OK) {
+            st = read_complex(fy, y, Nr);
+            if (st == READ_BAD) bad = argv[2];
+        }
+        if (st == READ_OK) {
+            st = read_bits(fb, bits, Nt * mu);
+            if (st == READ_BAD) bad = argv[3];
+        }
+        if (bad) {
+            fprintf(stderr, "%s: short or malformed input at frame %llu\n", bad, (unsigned long long)frames);
+            fclose(fH); fclose(fy); fclose(fb); fclose(fo);
+            remove(argv[4]);
+            return 1;
+        }
+        if (st == READ_EOF)
+            break;
+        fwrite(rec.data(), 1, rec.size(), fo);
+        frames++;
+    }
+
+    hdr.frames = frames;
+    fseek(fo, 0, SEEK_SET);
+    fwrite(&hdr, sizeof(hdr), 1, fo);
+    fclose(fH); fclose(fy); fclose(fb); fclose(fo);
+    printf("%s: %llu frames, Nt=%u Nr=%u mu=%u SNR=%.1f dB\n", argv[4], (unsigned long long)frames, Nt, Nr, mu, snr_db);
+    return 0;
+}
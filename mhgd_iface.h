@@ -0,0 +1,21 @@
+#pragma once
+/*
+ * 内核顶层（MHGD_detect_accel_hw，mhgd_cfg_default）与主机程序（xclbin_host/host.cpp）共用的端口尺寸。
+ * 内核的MHGD_accel_hw.h与主机的host_func.h都从这里取值，保证两边对端口布局的约定一致；不依赖HLS头文件。
+ */
+
+static const int mhgd_ntr = 8;/*发射&接收天线数*/
+static const int mhgd_iters = 10;/*每个采样器的迭代数*/
+static const int mhgd_num_ran = mhgd_iters * mhgd_ntr;/*GAUSS_TABLE_MODE下每个采样器的高斯表长度：v_tb中第k个采样器的表位于k*mhgd_num_ran*/
+static const int mhgd_max_batch = 64;/*批处理顶层MHGD_detect_accel_hw_batch单次调用的最大帧数（端口depth；主机每次调用的帧数不得超过它）*/
+
+#define LLR_MAX 127	/*SOFT_OUTPUT下int8 LLR对称饱和，不使用-128；候选中缺少某一比特取值时直接输出±LLR_MAX*/
+/*
+ * SOFT_OUTPUT下顶层的llr_gain为LLR的量化增益（LSB/nat）：llr = round(LLR * llr_gain)，下游按LLR = llr / llr_gain还原。
+ * mhgd_llr_gain为推荐取值：单比特翻转的典型LLR约为d_min^2/sigma2（单位能量M-QAM的d_min^2 = 6/(M-1)），
+ * 取增益使其量化为LLR_MAX/4，高SNR下LLR不会整体饱和，可靠度更高的比特另有4倍余量。
+ */
+static inline float mhgd_llr_gain(float sigma2, int mu)
+{
+	return (LLR_MAX / 4.0f) * sigma2 * (float)((1 << mu) - 1) / 6.0f;
+}
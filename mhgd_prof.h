@@ -0,0 +1,134 @@
+#pragma once
+/*
+ * PROFILE_STAGES下内核每帧写出的分段计时记录及其解码。
+ * 记录为mhgd_prof_words(samplers)个32位字：[0] = MHGD_PROF_MAGIC，[1] = 单位 << 16 | 采样器数，
+ * [2 + p]为时间点p相对PROF_START的值。板卡上单位为周期（各级在时间点上锁存内核内的自由运行计数器），
+ * C仿真中为实数乘法次数（复数乘法与平方范数，各级串行执行，相邻时间点之差即该段的运算量），MOCK_DEVICE下只有总时长（ns）。
+ * C仿真testbench（main_hw.cpp）与主机程序（xclbin_host/host.cpp）共用，不依赖HLS头文件。
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+#define MHGD_PROF_MAGIC 0x464F5250u	/*"PROF"*/
+
+enum mhgd_prof_unit {
+    MHGD_PROF_CYCLES = 0,
+    MHGD_PROF_MULS = 1,
+    MHGD_PROF_NS = 2
+};
+
+/*时间点；采样器k为PROF_SAMPLER_BASE + 2k（数据与初始化完成、进入samplers_process）与 + 2k + 1（结果写出）*/
+enum {
+    PROF_START = 0,         /*data_distribution开始*/
+    PROF_DIST_END,          /*H/y（及v_tb）读入并分发完毕*/
+    PROF_PRECOND_END,       /*shared_data_cal中grad_preconditioner（H^H*H与求逆）完成*/
+    PROF_SHARED_END,        /*pmat与全部共享量扇出完成*/
+    PROF_CMP_END,           /*比较（SOFT_OUTPUT下含LLR）完成*/
+    PROF_SAMPLER_BASE
+};
+
+static inline int mhgd_prof_points(int samplers) { return PROF_SAMPLER_BASE + 2 * samplers; }
+static inline int mhgd_prof_words(int samplers) { return 2 + mhgd_prof_points(samplers); }
+
+/*按帧累加的分段统计*/
+enum {
+    PROF_STAGE_DIST,
+    PROF_STAGE_PRECOND,
+    PROF_STAGE_SHARED,
+    PROF_STAGE_INIT,
+    PROF_STAGE_SAMPLE,
+    PROF_STAGE_CMP,
+    PROF_STAGE_TOTAL,
+    PROF_STAGES
+};
+
+struct mhgd_prof_acc {
+    int unit, samplers;
+    long frames;
+    double stage[PROF_STAGES];
+
+    mhgd_prof_acc() : unit(-1), samplers(0), frames(0)
+    {
+        for (int i = 0; i < PROF_STAGES; i++)
+            stage[i] = 0;
+    }
+
+    /*
+     * 周期：各段按依赖关系取跨度（数据分发、预条件矩阵、其余共享量、最慢采样器的初始化、
+     * 最慢采样器的samplers_process、最后一个采样器结束到比较完成），各采样器并行，因此各段之和不等于总周期。
+     * 乘法次数：各级串行执行，按执行顺序取差，采样器两段为所有采样器之和。
+     * 记录无效或单位/采样器数与之前的帧不一致时返回false。
+     */
+    bool add(const uint32_t* rec)
+    {
+        if (rec[0] != MHGD_PROF_MAGIC)
+            return false;
+        const int u = (int)(rec[1] >> 16), s = (int)(rec[1] & 0xFFFF);
+        if (frames && (u != unit || s != samplers))
+            return false;
+        unit = u;
+        samplers = s;
+        const uint32_t* t = rec + 2;
+        double d[PROF_STAGES] = {0};
+        if (unit == MHGD_PROF_CYCLES) {
+            uint32_t ready = 0, end = 0, sample = 0;
+            for (int k = 0; k < s; k++) {
+                const uint32_t r = t[PROF_SAMPLER_BASE + 2 * k], e = t[PROF_SAMPLER_BASE + 2 * k + 1];
+                ready = r > ready ? r : ready;
+                end = e > end ? e : end;
+                sample = e - r > sample ? e - r : sample;
+            }
+            d[PROF_STAGE_DIST] = t[PROF_DIST_END];
+            d[PROF_STAGE_PRECOND] = (double)t[PROF_PRECOND_END] - t[PROF_DIST_END];
+            d[PROF_STAGE_SHARED] = (double)t[PROF_SHARED_END] - t[PROF_PRECOND_END];
+            d[PROF_STAGE_INIT] = (double)ready - t[PROF_SHARED_END];
+            d[PROF_STAGE_SAMPLE] = sample;
+            d[PROF_STAGE_CMP] = (double)t[PROF_CMP_END] - end;
+        } else if (unit == MHGD_PROF_MULS) {
+            uint32_t prev = t[PROF_SHARED_END];
+            for (int k = 0; k < s; k++) {
+                const uint32_t r = t[PROF_SAMPLER_BASE + 2 * k], e = t[PROF_SAMPLER_BASE + 2 * k + 1];
+                d[PROF_STAGE_INIT] += r - prev;
+                d[PROF_STAGE_SAMPLE] += e - r;
+                prev = e;
+            }
+            d[PROF_STAGE_DIST] = t[PROF_DIST_END];
+            d[PROF_STAGE_PRECOND] = t[PROF_PRECOND_END] - t[PROF_DIST_END];
+            d[PROF_STAGE_SHARED] = t[PROF_SHARED_END] - t[PROF_PRECOND_END];
+            d[PROF_STAGE_CMP] = t[PROF_CMP_END] - prev;
+        }
+        d[PROF_STAGE_TOTAL] = t[PROF_CMP_END];
+        for (int i = 0; i < PROF_STAGES; i++)
+            stage[i] += d[i];
+        frames++;
+        return true;
+    }
+
+    /*打印每帧平均值；周期记录按clock_mhz换算为us*/
+    void print(FILE* f, double clock_mhz) const
+    {
+        static const char* const name[PROF_STAGES] = {
+            "data_distribution", "preconditioner", "shared (pmat+fanout)",
+            "sampler init", "samplers_process", "comparison", "total"
+        };
+        static const char* const unit_name[] = { "cycles", "real muls", "ns" };
+        if (!frames) {
+            fprintf(f, "[Prof] no records\n");
+            return;
+        }
+        fprintf(f, "[Prof] %ld frames, %d samplers, per-frame average (%s%s)\n", frames, samplers, unit_name[unit],
+                unit == MHGD_PROF_MULS ? ", sampler stages summed over samplers" : "");
+        const double total = stage[PROF_STAGE_TOTAL] / frames;
+        for (int i = 0; i < PROF_STAGES; i++) {
+            if (unit == MHGD_PROF_NS && i != PROF_STAGE_TOTAL)
+                continue;
+            const double v = stage[i] / frames;
+            fprintf(f, "  %-22s %12.1f", name[i], v);
+            if (unit == MHGD_PROF_CYCLES)
+                fprintf(f, "  %9.2f us", v / clock_mhz);
+            if (total > 0)
+                fprintf(f, "  %6.1f%%", 100.0 * v / total);
+            fprintf(f, "\n");
+        }
+    }
+};
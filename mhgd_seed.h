@@ -0,0 +1,48 @@
+#pragma once
+/*
+ * 随机种子序列：seed = SplitMix64(master_seed, frame, sampler_id)。
+ * 纯整数运算、无系统调用，可在逐帧热循环中直接调用；不同(frame, sampler_id)经SplitMix64充分混合，
+ * 各采样器、各帧之间的种子互不相关。master_seed相同则整次仿真可复现。
+ * C仿真testbench（main_hw.cpp）、BER驱动（mhgd_ber.cpp）与主机程序（xclbin_host/host.cpp）共用；
+ * splitmix64_rng为同一混合函数上的随机序列，供testbench逐帧生成信道与噪声。
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+static inline uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static inline unsigned int generate_seed(uint64_t master_seed, int frame, int sampler_id) {
+    uint64_t key = splitmix64(master_seed) ^ ((uint64_t)(unsigned int)frame << 32) ^ (uint64_t)(unsigned int)sampler_id;
+    return static_cast<unsigned int>(splitmix64(key) >> 32);
+}
+
+/*主种子：命令行给出时使用之（可复现），否则每次运行取一次时钟*/
+static inline uint64_t parse_master_seed(int argc, char** argv) {
+    if (argc > 1)
+        return strtoull(argv[1], NULL, 0);
+    return splitmix64((uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count());
+}
+
+/*SplitMix64随机序列：reset(seed, frame)确定起点，同一(seed, frame)给出相同的序列*/
+struct splitmix64_rng {
+    uint64_t s;
+    void reset(uint64_t seed, uint64_t frame) { s = splitmix64(seed ^ (frame * 0xD1B54A32D192ED03ULL)); }
+    uint64_t next() { s += 0x9E3779B97F4A7C15ULL; return splitmix64(s); }
+    /*(0, 1]上的均匀分布*/
+    double uniform() { return ((next() >> 11) + 1) * (1.0 / 9007199254740992.0); }
+    /*Box-Muller，一次给出两个独立的N(0, 1)*/
+    void gauss2(float& a, float& b)
+    {
+        double r = sqrt(-2.0 * log(uniform())), t = 6.283185307179586 * uniform();
+        a = (float)(r * cos(t));
+        b = (float)(r * sin(t));
+    }
+};
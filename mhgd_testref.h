@@ -0,0 +1,94 @@
+#pragma once
+/*
+ * testbench的双精度参考与帧生成，C仿真testbench（main_hw.cpp的INV_VERIFY/MULTI_CFG_VERIFY）、
+ * BER驱动（mhgd_ber.cpp）与微基准（mhgd_bench.cpp）共用；不参与综合。
+ * 帧生成的随机源RNG需提供next()与gauss2(a, b)（两个独立的N(0, 1)），一般为mhgd_seed.h的splitmix64_rng，
+ * 同一随机序列给出逐位相同的帧。
+ */
+#include "MHGD_accel_hw.h"
+#include "MyComplex_1.h"
+#include <math.h>
+#include <complex>
+#include <vector>
+
+typedef std::complex<double> ref_cd;
+
+/*G = H^H*H + reg*I，H为n×n行主序；与grad_preconditioner_updater_hw求逆的矩阵同型（Hermitian正定）*/
+static inline void ref_gram_reg(const ref_cd* H, int n, double reg, ref_cd* G)
+{
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            ref_cd s = (i == j) ? ref_cd(reg, 0) : ref_cd(0, 0);
+            for (int k = 0; k < n; k++)
+                s += std::conj(H[k * n + i]) * H[k * n + j];
+            G[i * n + j] = s;
+        }
+}
+
+/*n×n行主序矩阵求逆：Gauss-Jordan（部分主元）*/
+static inline void ref_inverse(const ref_cd* A, int n, ref_cd* Ainv)
+{
+    std::vector<ref_cd> aug(n * 2 * n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < 2 * n; j++)
+            aug[i * 2 * n + j] = (j < n) ? A[i * n + j] : ref_cd(j - n == i ? 1 : 0, 0);
+    for (int c = 0; c < n; c++) {
+        int p = c;
+        for (int i = c + 1; i < n; i++)
+            if (std::abs(aug[i * 2 * n + c]) > std::abs(aug[p * 2 * n + c])) p = i;
+        for (int j = 0; j < 2 * n; j++) std::swap(aug[c * 2 * n + j], aug[p * 2 * n + j]);
+        ref_cd piv = aug[c * 2 * n + c];
+        for (int j = 0; j < 2 * n; j++) aug[c * 2 * n + j] /= piv;
+        for (int i = 0; i < n; i++) {
+            if (i == c) continue;
+            ref_cd fac = aug[i * 2 * n + c];
+            for (int j = 0; j < 2 * n; j++) aug[i * 2 * n + j] -= fac * aug[c * 2 * n + j];
+        }
+    }
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            Ainv[i * n + j] = aug[i * 2 * n + n + j];
+}
+
+/*H ~ CN(0, 1/Nr)，Nr×Nt行主序，实部与虚部分开给出*/
+template<class RNG>
+void ref_gen_channel(RNG& rng, int Nr, int Nt, float* Hr, float* Hi)
+{
+    const float h_std = sqrtf(0.5f / Nr);
+    for (int l = 0; l < Nr * Nt; l++) {
+        float a, b;
+        rng.gauss2(a, b);
+        Hr[l] = a * h_std;
+        Hi[l] = b * h_std;
+    }
+}
+
+/*
+ * 一帧：H ~ CN(0, 1/Nr)，发送符号x在2^MU-QAM星座上均匀随机（已乘dqam），y = H*x + n，n ~ CN(0, sigma2)。
+ * 参考比特由调用方用QAM_Slicer_hw解调x得到，因此与星座的比特映射无关。
+ */
+template<int MU, class RNG>
+void ref_gen_frame(RNG& rng, int Nt, int Nr, float sigma2, float* Hr, float* Hi, MyComplex* x, float* yr, float* yi)
+{
+    const int M = 1 << MU;
+    const float dqam = sqrtf(1.5f / (float)(M - 1)), n_std = sqrtf(sigma2 / 2);
+    ref_gen_channel(rng, Nr, Nt, Hr, Hi);
+    for (int l = 0; l < Nt; l++) {
+        const MyComplex* s = &qam_traits<MU>::table()[rng.next() % M];
+        x[l].real = (float)s->real * dqam;
+        x[l].imag = (float)s->imag * dqam;
+    }
+    for (int r = 0; r < Nr; r++) {
+        float a, b;
+        rng.gauss2(a, b);
+        a *= n_std;
+        b *= n_std;
+        for (int l = 0; l < Nt; l++) {
+            float xr = (float)x[l].real, xi = (float)x[l].imag;
+            a += Hr[r * Nt + l] * xr - Hi[r * Nt + l] * xi;
+            b += Hr[r * Nt + l] * xi + Hi[r * Nt + l] * xr;
+        }
+        yr[r] = a;
+        yi[r] = b;
+    }
+}
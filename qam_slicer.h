@@ -0,0 +1,210 @@
+#pragma once
+/*
+ * 方形Gray QAM硬判决（slicer），替代QPSK/_16QAM/_64QAM_Demodulation_hw中对每个星座点求距离再argmin的做法。
+ * 每轴：t = x*sqrt(E)（E = 2/10/42/170，与原函数同式、同位宽计算），按门限thr_j = 2j-Ma（j=1..Ma-1，Ma为单轴电平数）
+ * 量化出电平序号k（电平 = 2k-(Ma-1)），比特为k的Gray码k^(k>>1)，高位在前，先实部后虚部。
+ * 这与MHGD_accel_hw.cpp中三张星座表的比特映射一致，因此不需要查表。
+ * t恰好落在门限上时，原函数的argmin取星座表中下标较小的点，折算到各轴为：QPSK与64QAM实部取下方电平，
+ * 64QAM虚部取上方电平，16QAM取Gray码较小者（只有+2门限取上方电平）。tie_upper_re/im的第j位为1表示门限j取上方电平。
+ * 256QAM没有原函数，门限上一律取下方电平。
+ *
+ * qam_slicer_hw<MU>：HLS实现，每符号一次乘法加Ma-1个比较器，II=1。
+ * qam_slicer_batch：主机批量实现。构造时把每个门限折算到x域（满足判决条件的最小定点x），
+ * 判决只剩比较与计数。输入为double：Myreal转double无损；float输入的结果等同于先截断到Myreal再判决。
+ * 支持AVX2时每次处理4个符号。
+ */
+#include "MyComplex_1.h"
+#include "hls_math.h"
+#include <math.h>
+#include <stdint.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__SYNTHESIS__)
+#define QAM_SLICER_X86 1
+#include <immintrin.h>
+#endif
+
+template<int MU> struct qam_slicer_traits;/*只支持MU=2/4/6/8*/
+template<> struct qam_slicer_traits<2> {
+	static const int energy = 2;/*未归一化星座平均能量，t = x*sqrt(energy)*/
+	static const unsigned tie_upper_re = 0, tie_upper_im = 0;
+};
+template<> struct qam_slicer_traits<4> {
+	static const int energy = 10;
+	static const unsigned tie_upper_re = 1u << 3, tie_upper_im = 1u << 3;
+};
+template<> struct qam_slicer_traits<6> {
+	static const int energy = 42;
+	static const unsigned tie_upper_re = 0, tie_upper_im = 0xFEu;
+};
+template<> struct qam_slicer_traits<8> {
+	static const int energy = 170;
+	static const unsigned tie_upper_re = 0, tie_upper_im = 0;
+};
+
+/*单轴电平序号：x按原函数的方式缩放后与Ma-1个门限比较计数*/
+template<int MU>
+int qam_slicer_level(Myreal x, unsigned tie_upper)
+{
+#pragma HLS INLINE
+	const int Ma = 1 << (MU / 2);
+	Myreal t = x * hls::sqrt((ap_fixed<40,8>)qam_slicer_traits<MU>::energy);
+	int k = 0;
+THRESHOLD_LOOP:
+	for (int j = 1; j < Ma; j++) {
+#pragma HLS UNROLL
+		Myreal thr = 2 * j - Ma;
+		k += ((tie_upper >> j) & 1) ? (t >= thr) : (t > thr);
+	}
+	return k;
+}
+
+template<int MU>
+void qam_slicer_hw(MyComplex* x_hat, int Nt, int* bits_demod)
+{
+	const int H = MU / 2;
+SLICE_LOOP:
+	for (int i = 0; i < Nt; i++) {
+#pragma HLS PIPELINE II=1
+		int k_re = qam_slicer_level<MU>(x_hat[i].real, qam_slicer_traits<MU>::tie_upper_re);
+		int k_im = qam_slicer_level<MU>(x_hat[i].imag, qam_slicer_traits<MU>::tie_upper_im);
+		int g_re = k_re ^ (k_re >> 1), g_im = k_im ^ (k_im >> 1);
+	BIT_LOOP:
+		for (int b = 0; b < H; b++) {
+#pragma HLS UNROLL
+			bits_demod[MU * i + b] = (g_re >> (H - 1 - b)) & 1;
+			bits_demod[MU * i + H + b] = (g_im >> (H - 1 - b)) & 1;
+		}
+	}
+}
+
+/*
+ * 与QAM_Demodulation_hw接口相同，逐位一致（DEMOD_VERIFY）。前提是输入在星座范围附近：64QAM原函数在|t|超过约8.5后
+ * 距离平方和溢出like_float而判决出错，slicer无此问题；检测器输出的x_hat总在星座点上，不受影响。
+ */
+inline void QAM_Slicer_hw(MyComplex* x_hat, int Nt, int mu, int* bits_demod)
+{
+	switch (mu)
+	{
+	case 2:
+		qam_slicer_hw<2>(x_hat, Nt, bits_demod);
+		break;
+	case 4:
+		qam_slicer_hw<4>(x_hat, Nt, bits_demod);
+		break;
+	case 6:
+		qam_slicer_hw<6>(x_hat, Nt, bits_demod);
+		break;
+	case 8:
+		qam_slicer_hw<8>(x_hat, Nt, bits_demod);
+		break;
+	default:
+		break;
+	}
+}
+
+#ifndef __SYNTHESIS__
+/*主机批量判决：x_re/x_im各n个符号，bits输出n*mu个0/1，布局同QAM_Demodulation_hw*/
+class qam_slicer_batch {
+public:
+	explicit qam_slicer_batch(int mu) : mu_(mu), levels_(1 << (mu / 2)), avx2_(false)
+	{
+		switch (mu) {
+		case 2: init_cut<2>(); break;
+		case 4: init_cut<4>(); break;
+		case 6: init_cut<6>(); break;
+		case 8: init_cut<8>(); break;
+		default: levels_ = 1; break;
+		}
+#ifdef QAM_SLICER_X86
+		__builtin_cpu_init();
+		avx2_ = __builtin_cpu_supports("avx2");
+#endif
+	}
+
+	void operator()(const double* x_re, const double* x_im, int n, int* bits) const
+	{
+		int i = 0;
+#ifdef QAM_SLICER_X86
+		if (avx2_)
+			i = slice_avx2(x_re, x_im, n, bits);
+#endif
+		for (; i < n; i++)
+			emit(i, count(x_re[i], cut_re_), count(x_im[i], cut_im_), bits);
+	}
+
+	int mu() const { return mu_; }
+
+private:
+	/*cut[j-1]：越过门限j（含门限上按规则取上方电平的情形）所需的最小x，在Myreal网格（2^-32）上*/
+	template<int MU>
+	void init_cut()
+	{
+		for (int j = 1; j < levels_; j++) {
+			cut_re_[j - 1] = search_cut<MU>(j, qam_slicer_traits<MU>::tie_upper_re);
+			cut_im_[j - 1] = search_cut<MU>(j, qam_slicer_traits<MU>::tie_upper_im);
+		}
+	}
+	/*
+	 * 二分查找Myreal原始值（2^-32为单位）上第一个电平序号>=j的点。
+	 * 只在t = x*sqrt(E)不溢出Myreal（|t| < 128）的范围内查找，电平序号在此范围内随x单调不减；
+	 * 范围外定点实现的t会回绕，批量实现则按最外侧电平判决。
+	 */
+	template<int MU>
+	static double search_cut(int j, unsigned tie_upper)
+	{
+		const int64_t x_max = (int64_t)ldexp(127.0 / sqrt((double)qam_slicer_traits<MU>::energy), 32);
+		int64_t lo = -x_max, hi = x_max;
+		while (lo < hi) {
+			int64_t mid = lo + (hi - lo) / 2;
+			if (qam_slicer_level<MU>((Myreal)ldexp((double)mid, -32), tie_upper) >= j)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return ldexp((double)lo, -32);
+	}
+	int count(double x, const double* cut) const
+	{
+		int k = 0;
+		for (int j = 0; j < levels_ - 1; j++)
+			k += x >= cut[j];
+		return k;
+	}
+	void emit(int i, int k_re, int k_im, int* bits) const
+	{
+		const int H = mu_ / 2;
+		int g_re = k_re ^ (k_re >> 1), g_im = k_im ^ (k_im >> 1);
+		for (int b = 0; b < H; b++) {
+			bits[mu_ * i + b] = (g_re >> (H - 1 - b)) & 1;
+			bits[mu_ * i + H + b] = (g_im >> (H - 1 - b)) & 1;
+		}
+	}
+#ifdef QAM_SLICER_X86
+	/*每次4个符号：比较结果为全1（即-1）的64位掩码，累减得到电平序号；返回已处理的符号数*/
+	__attribute__((target("avx2")))
+	int slice_avx2(const double* x_re, const double* x_im, int n, int* bits) const
+	{
+		int i = 0;
+		for (; i + 4 <= n; i += 4) {
+			__m256d re = _mm256_loadu_pd(x_re + i), im = _mm256_loadu_pd(x_im + i);
+			__m256i k_re = _mm256_setzero_si256(), k_im = _mm256_setzero_si256();
+			for (int j = 0; j < levels_ - 1; j++) {
+				k_re = _mm256_sub_epi64(k_re, _mm256_castpd_si256(_mm256_cmp_pd(re, _mm256_set1_pd(cut_re_[j]), _CMP_GE_OQ)));
+				k_im = _mm256_sub_epi64(k_im, _mm256_castpd_si256(_mm256_cmp_pd(im, _mm256_set1_pd(cut_im_[j]), _CMP_GE_OQ)));
+			}
+			alignas(32) int64_t kr[4], ki[4];
+			_mm256_store_si256((__m256i*)kr, k_re);
+			_mm256_store_si256((__m256i*)ki, k_im);
+			for (int l = 0; l < 4; l++)
+				emit(i + l, (int)kr[l], (int)ki[l], bits);
+		}
+		/*返回前清零YMM高位，避免后续SSE代码的状态切换开销*/
+		_mm256_zeroupper();
+		return i;
+	}
+#endif
+
+	int mu_, levels_;
+	bool avx2_;
+	double cut_re_[15], cut_im_[15];
+};
+#endif
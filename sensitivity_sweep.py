@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""
+位宽灵敏度扫描驱动：对MyComplex_1.h中"// 变量: xxx"下的各定点类型生成候选位宽组合，
+每组用sensitivity_types.hpp.jinja2渲染一份sensitivity_types.hpp，以-DSENSITIVITY_ANALYSIS_MODE编译一次C级模型的
+BER驱动（mhgd_ber），在同一组帧上测BER（帧由master_seed、SNR与帧号决定，与位宽无关，各组完全相同），
+最后输出BER-总位宽的Pareto前沿。
+
+候选位宽（可组合，基线总是包含在内）：
+  --frac-steps 2,4,8   每个变量组（同名_real/_imag为一组）单独减少小数位，每个步长一组候选，小数位最少减到0
+  --int-steps 1        每个变量组单独减少整数位（小数位不变），整数位最少为1（符号位）
+  --uniform-steps 2,4  所有变量组同时减少小数位
+  --spec file.json     显式给出的组合：[{"name": "...", "widths": {"H_real": [18, 4], ...}}, ...]
+  --vars a,b           只扫描这些变量组（默认全部）
+总位宽为所有变量字宽W之和；err_ratio为相对基线的误比特数之比。
+
+各组的编译与仿真在--jobs个进程中并行（默认CPU核数），每组的mhgd_ber只用1个线程。
+输出（--out目录，默认build/sensitivity）：<组名>/下的sensitivity_types.hpp、mhgd_ber、ber.json，
+以及sweep.json（全部组合）与pareto.csv（前沿）。
+
+用法：
+  python3 sensitivity_sweep.py --frac-steps 2,4,8 --int-steps 1 --frames 2000 --snr 15 20 25 \\
+      [-I $XILINX_HLS/include] [--jobs N] [--out DIR] [-D MHGD_SAMPLERS=8]
+模板渲染使用jinja2；未安装时使用内置的简化渲染（只支持该模板用到的for循环与变量替换）。
+"""
+import argparse
+import concurrent.futures
+import csv
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+REPO = os.path.dirname(os.path.abspath(__file__))
+TYPES_HEADER = os.path.join(REPO, "MyComplex_1.h")
+TEMPLATE = os.path.join(REPO, "sensitivity_types.hpp.jinja2")
+SOURCES = [os.path.join(REPO, "MHGD_accel_hw.cpp"), os.path.join(REPO, "mhgd_ber.cpp")]
+
+
+def parse_baseline(path):
+    """MyComplex_1.h中#else分支的基线位宽，返回有序的{变量名: (W, I)}"""
+    text = open(path, encoding="utf-8").read()
+    widths = {}
+    for m in re.finditer(r"// 变量: (\w+)\s*\ntypedef ap_fixed<\s*(\d+)\s*,\s*(-?\d+)\s*>\s*(\w+)_t\s*;", text):
+        if m.group(1) != m.group(4):
+            raise SystemExit("%s: comment '%s' does not match typedef %s_t" % (path, m.group(1), m.group(4)))
+        widths[m.group(1)] = (int(m.group(2)), int(m.group(3)))
+    if not widths:
+        raise SystemExit("%s: no '// 变量:' typedefs found" % path)
+    return widths
+
+
+def group_of(name):
+    for suffix in ("_real", "_imag"):
+        if name.endswith(suffix):
+            return name[: -len(suffix)]
+    return name
+
+
+def render(template, widths):
+    """渲染sensitivity_types.hpp.jinja2，模板变量vars = {变量名: {init_W, init_I}}"""
+    ctx = {name: {"init_W": w, "init_I": i} for name, (w, i) in widths.items()}
+    try:
+        import jinja2
+        return jinja2.Template(template, keep_trailing_newline=True).render(vars=ctx)
+    except ImportError:
+        pass
+
+    def subst(body, scope):
+        def value(m):
+            obj = scope
+            for part in m.group(1).split("."):
+                obj = obj[part]
+            return str(obj)
+        return re.sub(r"\{\{\s*([\w.]+)\s*\}\}", value, body)
+
+    def loop(m):
+        key, cfg, body = m.group(1), m.group(2), m.group(3)
+        return "".join(subst(body, {key: k, cfg: v}) for k, v in ctx.items())
+
+    out = re.sub(r"\{%\s*for\s+(\w+)\s*,\s*(\w+)\s+in\s+vars\.items\(\)\s*%\}(.*?)\{%\s*endfor\s*%\}", loop, template,
+                 flags=re.S)
+    if "{%" in out or "{{" in out:
+        raise SystemExit("jinja2 is not installed and the template uses syntax beyond the built-in renderer")
+    return out
+
+
+def narrow(wi, frac_step=0, int_step=0):
+    """减少小数位/整数位后的(W, I)；小数位不小于0，整数位不小于1"""
+    w, i = wi
+    f = max(w - i - frac_step, 0)
+    i = max(i - int_step, 1) if int_step else i
+    return (i + f, i)
+
+
+def make_variants(base, args):
+    groups = []
+    for name in base:
+        g = group_of(name)
+        if g not in groups:
+            groups.append(g)
+    if args.vars:
+        wanted = args.vars.split(",")
+        unknown = [g for g in wanted if g not in groups]
+        if unknown:
+            raise SystemExit("unknown variable groups: %s (known: %s)" % (",".join(unknown), ",".join(groups)))
+        groups = [g for g in groups if g in wanted]
+    members = {g: [n for n in base if group_of(n) == g] for g in groups}
+
+    variants = [("baseline", dict(base))]
+
+    def add(name, widths):
+        if widths != base and all(widths != v for _, v in variants):
+            variants.append((name, widths))
+
+    for step in args.frac_steps:
+        for g in groups:
+            w = dict(base)
+            for n in members[g]:
+                w[n] = narrow(base[n], frac_step=step)
+            add("%s_f-%d" % (g, step), w)
+    for step in args.int_steps:
+        for g in groups:
+            w = dict(base)
+            for n in members[g]:
+                w[n] = narrow(base[n], int_step=step)
+            add("%s_i-%d" % (g, step), w)
+    for step in args.uniform_steps:
+        w = dict(base)
+        for g in groups:
+            for n in members[g]:
+                w[n] = narrow(base[n], frac_step=step)
+        add("uniform_f-%d" % step, w)
+    if args.spec:
+        for k, item in enumerate(json.load(open(args.spec))):
+            w = dict(base)
+            for n, wi in item["widths"].items():
+                if n not in base:
+                    raise SystemExit("%s: unknown variable %s" % (args.spec, n))
+                if int(wi[0]) < 1:
+                    raise SystemExit("%s: %s has W < 1" % (args.spec, n))
+                w[n] = (int(wi[0]), int(wi[1]))
+            add(item.get("name", "spec%d" % k), w)
+    return variants
+
+
+def run_variant(name, widths, template, args):
+    """渲染、编译并运行一组位宽，返回结果记录"""
+    vdir = os.path.join(args.out, name)
+    os.makedirs(vdir, exist_ok=True)
+    with open(os.path.join(vdir, "sensitivity_types.hpp"), "w", encoding="utf-8") as f:
+        f.write(render(template, widths))
+    exe = os.path.join(vdir, "mhgd_ber")
+    rec = {"name": name, "total_bits": sum(w for w, _ in widths.values()), "status": "ok"}
+    cmd = [args.cxx, "-std=c++14", "-O2", "-w", "-pthread", "-DSENSITIVITY_ANALYSIS_MODE", "-I", vdir, "-I", REPO]
+    cmd += ["-I" + d for d in args.include] + ["-D" + d for d in args.define] + SOURCES + ["-o", exe]
+    t0 = time.time()
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    rec["compile_s"] = round(time.time() - t0, 2)
+    if p.returncode:
+        with open(os.path.join(vdir, "compile.log"), "w") as f:
+            f.write(p.stdout)
+        rec["status"] = "compile_failed"
+        return rec
+    json_path = os.path.join(vdir, "ber.json")
+    if os.path.exists(json_path):
+        os.remove(json_path)
+    cmd = [exe, str(args.seed), str(args.frames), "1"] + args.snr + ["--json", json_path]
+    t0 = time.time()
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    rec["run_s"] = round(time.time() - t0, 2)
+    with open(os.path.join(vdir, "run.log"), "w") as f:
+        f.write(p.stdout)
+    if p.returncode or not os.path.exists(json_path):
+        rec["status"] = "run_failed"
+        return rec
+    points = json.load(open(json_path))["points"]
+    rec["points"] = [{"snr_db": q["snr_db"], "ber": q["ber"], "error_bits": q["error_bits"]} for q in points]
+    rec["error_bits"] = sum(q["error_bits"] for q in points)
+    rec["bits"] = sum(q["bits"] for q in points)
+    rec["ber"] = rec["error_bits"] / rec["bits"] if rec["bits"] else 0.0
+    return rec
+
+
+def pareto(records):
+    """总位宽与BER都不被其他组合同时超过（一项更优、另一项不差）的组合"""
+    ok = sorted((r for r in records if r["status"] == "ok"), key=lambda r: (r["total_bits"], r["ber"]))
+    front, best = [], None
+    for r in ok:
+        if best is None or r["ber"] < best:
+            front.append(r)
+            best = r["ber"]
+    return front
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Bit-width sensitivity sweep over MyComplex_1.h types (BER vs total bits)")
+    ints = lambda s: [int(x) for x in s.split(",") if x]
+    ap.add_argument("--frac-steps", type=ints, default=[], help="per-group fractional-bit reductions, e.g. 2,4,8")
+    ap.add_argument("--int-steps", type=ints, default=[], help="per-group integer-bit reductions, e.g. 1")
+    ap.add_argument("--uniform-steps", type=ints, default=[], help="fractional-bit reductions applied to all groups")
+    ap.add_argument("--spec", help="JSON list of explicit width sets")
+    ap.add_argument("--vars", help="comma-separated variable groups to sweep (default: all)")
+    ap.add_argument("--seed", type=int, default=1, help="mhgd_ber master seed (fixes the frame set)")
+    ap.add_argument("--frames", type=int, default=2000, help="frames per SNR point")
+    ap.add_argument("--snr", nargs="+", default=["20"], help="SNR points/ranges passed to mhgd_ber")
+    ap.add_argument("--jobs", type=int, default=os.cpu_count() or 1)
+    ap.add_argument("--out", default=os.path.join(REPO, "build", "sensitivity"))
+    ap.add_argument("--cxx", default=os.environ.get("CXX", "g++"))
+    ap.add_argument("-I", dest="include", action="append",
+                    default=[os.path.join(os.environ["XILINX_HLS"], "include")] if "XILINX_HLS" in os.environ else [],
+                    help="include directory for ap_fixed/hls headers (default: $XILINX_HLS/include)")
+    ap.add_argument("-D", dest="define", action="append", default=[], help="extra preprocessor define")
+    ap.add_argument("--dry-run", action="store_true", help="only render the headers and list the variants")
+    args = ap.parse_args()
+
+    if os.path.exists(os.path.join(REPO, "sensitivity_types.hpp")):
+        raise SystemExit("remove %s: it would shadow the per-variant headers" % os.path.join(REPO, "sensitivity_types.hpp"))
+    base = parse_baseline(TYPES_HEADER)
+    template = open(TEMPLATE, encoding="utf-8").read()
+    variants = make_variants(base, args)
+    os.makedirs(args.out, exist_ok=True)
+    print("%d variants, %d frames x %s dB, seed %d, %d jobs" % (len(variants), args.frames, " ".join(args.snr),
+                                                                 args.seed, args.jobs))
+    if args.dry_run:
+        for name, widths in variants:
+            vdir = os.path.join(args.out, name)
+            os.makedirs(vdir, exist_ok=True)
+            with open(os.path.join(vdir, "sensitivity_types.hpp"), "w", encoding="utf-8") as f:
+                f.write(render(template, widths))
+            print("  %-28s total_bits=%d" % (name, sum(w for w, _ in widths.values())))
+        return 0
+
+    records = []
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futs = {pool.submit(run_variant, n, w, template, args): (n, w) for n, w in variants}
+        for fut in concurrent.futures.as_completed(futs):
+            n, w = futs[fut]
+            rec = fut.result()
+            rec["changes"] = {k: list(v) for k, v in w.items() if v != base[k]}
+            records.append(rec)
+            print("  %-28s %-15s bits=%4d  ber=%s" % (n, rec["status"], rec["total_bits"],
+                                                      "%.4e" % rec["ber"] if "ber" in rec else "-"), flush=True)
+
+    order = {n: k for k, (n, _) in enumerate(variants)}
+    records.sort(key=lambda r: order[r["name"]])
+    base_rec = records[0]
+    for r in records:
+        if r["status"] == "ok" and base_rec["status"] == "ok":
+            r["err_ratio"] = r["error_bits"] / base_rec["error_bits"] if base_rec["error_bits"] else None
+    front = pareto(records)
+    for r in records:
+        r["pareto"] = r in front
+
+    with open(os.path.join(args.out, "sweep.json"), "w") as f:
+        json.dump({"seed": args.seed, "frames": args.frames, "snr": args.snr,
+                   "baseline": {k: list(v) for k, v in base.items()}, "variants": records}, f, indent=2)
+    with open(os.path.join(args.out, "pareto.csv"), "w", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["total_bits", "ber", "err_ratio", "name", "changes"])
+        for r in front:
+            ratio = r.get("err_ratio")
+            w.writerow([r["total_bits"], "%.6e" % r["ber"], "" if ratio is None else "%.4f" % ratio, r["name"],
+                        " ".join("%s=<%d,%d>" % (k, v[0], v[1]) for k, v in r["changes"].items())])
+
+    print("Pareto front (total bits vs BER):")
+    for r in front:
+        print("  %4d bits  BER %.4e  %s" % (r["total_bits"], r["ber"], r["name"]))
+    failed = [r["name"] for r in records if r["status"] != "ok"]
+    if failed:
+        print("failed: %s (see compile.log / run.log)" % ", ".join(failed))
+    print("results: %s, %s" % (os.path.join(args.out, "sweep.json"), os.path.join(args.out, "pareto.csv")))
+    return 1 if base_rec["status"] != "ok" else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+v++链接配置生成（make all时由makefile按CU/PACKED/GAUSS_TABLE/SOFT/PROFILE调用，CU=1也由本脚本生成）：
+[connectivity]段为N个CU的实例化、逐CU的HBM端口映射与SLR分配，其余各段（[hls]/[vivado]/[profile]）取自下面的HEAD/TAIL。
+输出文件内容不变时不重写，makefile每次调用本脚本也不会触发重新链接。
+
+HBM分配：U50共32个HBM伪通道，平均分给N个CU，每个CU占连续的32 // N个通道（第c个CU从c * (32 // N)开始），
+该CU的各个存储端口在自己的通道组内依次轮转，不同CU之间不共享通道，互不争抢带宽。
+端口集合随编译选项变化（须与内核一致）：
+  默认          x_hat_real/x_hat_imag/H_real/H_imag/y_real/y_imag/seeds
+  --packed      x_hat/H/y/seeds（PACKED_AXI）
+  --gauss-table 另加v_tb_real/v_tb_imag（GAUSS_TABLE_MODE）
+  --soft        另加llr（SOFT_OUTPUT，位于seeds之后；标量llr_gain走控制接口，不需要映射）
+  --profile     另加prof（PROFILE_STAGES）
+  --kernel MHGD_detect_accel_hw_batch
+                批处理内核：sigma2为逐帧数组（m_axi），位于seeds之前；没有llr/prof端口，标量frames走控制接口
+SLR分配：CU按--slrs给出的列表轮流放置（默认SLR0,SLR1）。U50的HBM控制器在SLR0，放在SLR1的CU跨SLR访存，
+时序较紧时可改为--slrs SLR0。
+CU命名为<kernel>_1 ... <kernel>_N，主机按同样的名字打开各CU（host.cpp）。
+
+用法：
+  python3 gen_cu_cfg.py --cu 2 [--kernel NAME] [--packed] [--gauss-table] [--soft] [--profile] [-o out.cfg]
+"""
+import argparse
+import os
+import sys
+
+HBM_CHANNELS = 32
+
+HEAD = """debug=1
+save-temps=1
+
+[hls]
+jobs=8
+
+[vivado]
+synth.jobs=32     # Vivado 综合阶段的并行作业数
+impl.jobs=8       # Vivado 实现（布局布线）阶段的并行作业数
+
+# check the platform information:  platforminfo -p xilinx_u50_gen3x16_xdma_5_202210_1
+# 内存接口用sp
+[connectivity]
+"""
+
+TAIL = """
+[profile]
+data=all:all:all
+"""
+
+
+def batch_kernel(args):
+    return args.kernel.endswith("_batch")
+
+
+def ports(args):
+    if args.packed:
+        io = ["x_hat", "H", "y"]
+    else:
+        io = ["x_hat_real", "x_hat_imag", "H_real", "H_imag", "y_real", "y_imag"]
+    if args.gauss_table:
+        io += ["v_tb_real", "v_tb_imag"]
+    if batch_kernel(args):
+        io.append("sigma2")
+    io.append("seeds")
+    if args.soft:
+        io.append("llr")
+    if args.profile:
+        io.append("prof")
+    return io
+
+
+def connectivity(args):
+    names = ["%s_%d" % (args.kernel, c + 1) for c in range(args.cu)]
+    span = HBM_CHANNELS // args.cu
+    slrs = args.slrs.split(",")
+    lines = ["# 由gen_cu_cfg.py生成：%d个CU，每个CU占%d个HBM通道" % (args.cu, span),
+             "nk=%s:%d:%s" % (args.kernel, args.cu, ".".join(names))]
+    for c, name in enumerate(names):
+        base = c * span
+        for i, p in enumerate(ports(args)):
+            lines.append("sp=%s.%s:HBM[%d]" % (name, p, base + i % span))
+    if not batch_kernel(args):
+        lines.append("#控制接口用sc")
+        lines.append("# sc=%s.sigma2:CTRL" % names[0])
+    lines.append("")
+    lines.append("# configure the slr. ")
+    for c, name in enumerate(names):
+        lines.append("slr=%s:%s" % (name, slrs[c % len(slrs)]))
+    return lines
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Generate a v++ link config with N compute units and per-CU HBM mapping")
+    ap.add_argument("--cu", type=int, required=True, help="number of compute units (1..%d)" % HBM_CHANNELS)
+    ap.add_argument("--kernel", default="MHGD_detect_accel_hw",
+                    help="kernel name; a *_batch kernel maps its sigma2 array and has no llr/prof ports")
+    ap.add_argument("--packed", action="store_true", help="kernel built with PACKED_AXI")
+    ap.add_argument("--gauss-table", action="store_true", help="kernel built with GAUSS_TABLE_MODE")
+    ap.add_argument("--soft", action="store_true", help="kernel built with SOFT_OUTPUT")
+    ap.add_argument("--profile", action="store_true", help="kernel built with PROFILE_STAGES")
+    ap.add_argument("--slrs", default="SLR0,SLR1", help="comma-separated SLRs, assigned to CUs round-robin")
+    ap.add_argument("-o", "--out", help="output file (default: stdout)")
+    args = ap.parse_args()
+    if not 1 <= args.cu <= HBM_CHANNELS:
+        raise SystemExit("--cu must be in 1..%d" % HBM_CHANNELS)
+    if batch_kernel(args) and (args.soft or args.profile):
+        raise SystemExit("%s has no llr/prof ports (--soft/--profile)" % args.kernel)
+
+    text = HEAD + "\n".join(connectivity(args)) + "\n" + TAIL
+    if args.out:
+        os.makedirs(os.path.dirname(os.path.abspath(args.out)), exist_ok=True)
+        if os.path.exists(args.out):
+            with open(args.out) as f:
+                if f.read() == text:
+                    return
+        with open(args.out, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,43 +2,42 @@
 #include <cstring>
 #include <fstream>
 #include <cmath>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include <atomic>
+#ifdef MOCK_DEVICE
+#include <complex>
+#include <future>
+#include <mutex>
+#else
 // XRT includes
 #include "xrt/xrt_bo.h"
 #include <experimental/xrt_xclbin.h>
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_kernel.h"
+#endif
 // TB includes
 #include "host_func.h"
 #include "MyComplex_1.h"
+#include "mhgd_dataset.h"
+#include "mhgd_seed.h"
+#include "spsc_ring.h"
+#include "qam_slicer.h"
+#ifdef PROFILE_STAGES
+#include "mhgd_prof.h"
+#endif
+#ifdef PACKED_AXI
+#include "mhgd_axi_pack.h"
+#endif
 #include <string.h>
 #include <stdio.h>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
 
-MyComplex QPSK_Constellation_hw[4] = {{-1,-1},{-1,1},{1,-1},{1,1}};
-MyComplex _16QAM_Constellation_hw[16] = {{-3.0,-3.0},{-3.0,-1.0},{-3.0,3.0},{-3.0,1.0},{-1.0,-3.0},{-1.0,-1.0},{-1.0,3.0},{-1.0,1.0},{3.0,-3.0},{3.0,-1.0},{3.0,3.0},{3.0,1.0},{1.0,-3.0},{1.0,-1.0},{1.0,3.0},{1.0,1.0}};
-MyComplex _64QAM_Constellation_hw[64] = {{-7.0, 7.0},  {-5.0, 7.0},  {-3.0, 7.0}, {-1.0, 7.0}, 
-                                         {1.0, 7.0},   {3.0, 7.0},   {5.0, 7.0},  {7.0, 7.0},
-                                         {-7.0, 5.0},  {-5.0, 5.0},  {-3.0, 5.0}, {-1.0, 5.0},
-                                         {1.0, 5.0},   {3.0, 5.0},   {5.0, 5.0},  {7.0, 5.0},
-                                         {-7.0, 3.0},  {-5.0, 3.0},  {-3.0, 3.0}, {-1.0, 3.0},
-                                         {1.0, 3.0},   {3.0, 3.0},   {5.0, 3.0},  {7.0, 3.0},
-                                         {-7.0, 1.0},  {-5.0, 1.0},  {-3.0, 1.0}, {-1.0, 1.0},
-                                         {1.0, 1.0},   {3.0, 1.0},   {5.0, 1.0},  {7.0, 1.0},
-                                         {-7.0, -1.0}, {-5.0, -1.0}, {-3.0, -1.0},{-1.0, -1.0},
-                                         {1.0, -1.0},  {3.0, -1.0},  {5.0, -1.0}, {7.0, -1.0},
-                                         {-7.0, -3.0}, {-5.0, -3.0}, {-3.0, -3.0},{-1.0, -3.0},
-                                         {1.0, -3.0},  {3.0, -3.0},  {5.0, -3.0}, {7.0, -3.0},
-                                         {-7.0, -5.0}, {-5.0, -5.0}, {-3.0, -5.0},{-1.0, -5.0},
-                                         {1.0, -5.0},  {3.0, -5.0},  {5.0, -5.0}, {7.0, -5.0},
-                                         {-7.0, -7.0}, {-5.0, -7.0}, {-3.0, -7.0},{-1.0, -7.0},
-                                         {1.0, -7.0},  {3.0, -7.0},  {5.0, -7.0}, {7.0, -7.0}};
 void read_gaussian_data_hw(const char* filename, MyComplex* data, int size, int offset);
 void read_gaussian_data_hw_1(const char* filename, MyComplex* array, int n, int offset);
-void QAM_Demodulation_hw_de(Myreal* x_hat_real, Myimage* x_hat_imag, int Nt, int mu, int* bits_demod);
-void QPSK_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod);
-void _16QAM_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod);
-void _64QAM_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod);
-int argmin_hw(like_float* array, int n);
 int unequal_times_hw(int* array1, int* array2, int n);
 
 
@@ -85,586 +84,813 @@ void read_gaussian_data_hw_1(const char* filename, MyComplex_v* array, int n, in
 }
 
 
-void QAM_Demodulation_hw_de(MyComplex* x_hat, int Nt, int mu, int* bits_demod)
+/*计算误bit数*/
+int unequal_times_hw(int* array1, int* array2, int n)
 {
-	switch (mu)
+	int unequal = 0; int i = 0;
+	for (i = 0; i < n; i++)
 	{
-	case 2:
-		QPSK_Demodulation_hw(x_hat, Nt, bits_demod);
-		break;
-	case 4:
-		_16QAM_Demodulation_hw(x_hat, Nt, bits_demod);
-		break;
-	case 6:
-		_64QAM_Demodulation_hw(x_hat, Nt, bits_demod);
-		break;
-	default:
-		break;
+		if (array1[i] != array2[i])
+			unequal++;
 	}
+	return unequal;
 }
 
-/*QPSK解调*/
-void QPSK_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod)
+/**********************************************************************************/
+/*************************************帧流水线*************************************/
+/**********************************************************************************/
+/*
+ * 主机端为num_cu个CU各建一个pipe_depth槽位的环：每个槽位独占一组输入/输出BO（分配在该CU所连的HBM通道上）
+ * 和一个run句柄（XRT下启动前一次性创建并绑定全部参数，每帧只上传数据后start()），同一时刻最多承载一次内核调用；同一CU上的帧按发射顺序完成，环头即最早完成的帧。
+ * 默认每次调用检测一帧；MHGD_BATCH下每个槽位承载batch_frames个连续帧，一次调用批处理内核检测（数据末尾不足时以实际帧数调用）。
+ * 每一帧先由调度器选定CU：默认按帧号轮询（第f帧发往CU f % num_cu），CU_SCHED_LEAST_LOADED下发往在途帧最少的CU。
+ * 所选CU的槽位全满时先等待其环头的帧完成并解调，再写入新帧并启动。
+ * pipe_depth=2时，某CU上第k帧运行的同时，主机上传第k+1帧、解调第k-1帧；num_cu=1、pipe_depth=1退化为原来的串行流程。
+ * MOCK_DEVICE下槽位用主机内存代替BO，每个CU由后台线程模拟：固定延时后给出迫零(ZF)检测结果，
+ * 同一CU的多个run经该CU的互斥量串行执行，不同CU之间并行，用于在没有板卡时验证流水线与调度逻辑。
+ */
+/*读取线程产出的一帧（已量化为内核输入类型）*/
+struct host_frame {
+    int frame;
+    H_real_t H_real[Ntr_2]; H_imag_t H_imag[Ntr_2];
+    y_real_t y_real[Ntr_1]; y_imag_t y_imag[Ntr_1];
+    int bits[Ntr_1 * mu_1];
+};
+typedef spsc_ring<host_frame, frame_ring_depth> frame_ring;
+
+/*
+ * 读取线程：逐帧解析文本文件（或从映射的数据集中取帧）并送入ring，最多max_frames帧，读完即close。
+ * 内存占用只有ring的frame_ring_depth帧，与数据集长度无关。
+ */
+static void frame_producer(frame_ring* ring, const mhgd_dataset* ds, std::istream* fin_H, std::istream* fin_y,
+                           std::istream* fin_bits, int max_frames)
 {
-	int i = 0; int j = 0; int best_id = 0;
-	MyComplex temp[4];
-	MyComplex temp_1[4];
-	like_float temp_2;
-	like_float distance[4] = {0, 0, 0, 0};
-	/*for one in x_hat*/
-	for (i = 0; i < Nt; i++)
-	{
-		for (j = 0; j < 4; j++)
-		{
-			temp_1[j].real = x_hat[i].real * hls::sqrt((ap_fixed<64,32>)2.0);
-			temp_1[j].imag = x_hat[i].imag * hls::sqrt((ap_fixed<64,32>)2.0);
-			temp[j].real = temp_1[j].real - QPSK_Constellation_hw[j].real;
-			temp[j].imag = temp_1[j].imag - QPSK_Constellation_hw[j].imag;
-		}
-		for (j = 0; j < 4; j++)
-		{
-			temp_2 = (temp[j].real * temp[j].real + temp[j].imag * temp[j].imag);
-			distance[j] = hls::sqrt((ap_fixed<64,32>)temp_2);
-		}
-		best_id = argmin_hw(distance, 4);
-		switch (best_id)
-		{
-		case 0:
-			bits_demod[2 * i] = 0; bits_demod[2 * i + 1] = 0;
-			break;
-		case 1:
-			bits_demod[2 * i] = 0; bits_demod[2 * i + 1] = 1;
-			break;
-		case 2:
-			bits_demod[2 * i] = 1; bits_demod[2 * i + 1] = 0;
-			break;
-		case 3:
-			bits_demod[2 * i] = 1; bits_demod[2 * i + 1] = 1;
-			break;
-		default:
-			break;
-		}
-	}
+    host_frame fr;
+    for (int f = 0; f < max_frames; ++f) {
+        fr.frame = f;
+        if (ds) {
+            const float* Hf = ds->H(f);
+            const float* yf = ds->y(f);
+            const uint8_t* bf = ds->bits(f);
+            for (int j = 0; j < Ntr_1 * Ntr_1; ++j) {
+                fr.H_real[j] = Hf[2 * j];
+                fr.H_imag[j] = Hf[2 * j + 1];
+            }
+            for (int j = 0; j < Ntr_1; ++j) {
+                fr.y_real[j] = yf[2 * j];
+                fr.y_imag[j] = yf[2 * j + 1];
+            }
+            for (int j = 0; j < Ntr_1 * mu_1; ++j)
+                fr.bits[j] = bf[j];
+        } else {
+            for (int j = 0; j < Ntr_1 * Ntr_1; ++j)
+                *fin_H >> fr.H_real[j] >> fr.H_imag[j];
+            for (int j = 0; j < Ntr_1; ++j)
+                *fin_y >> fr.y_real[j] >> fr.y_imag[j];
+            for (int j = 0; j < Ntr_1 * mu_1; ++j)
+                *fin_bits >> fr.bits[j];
+            if (!*fin_H || !*fin_y || !*fin_bits)
+                break;  // 文本文件不足max_frames帧
+        }
+        ring->push(fr);
+    }
+    ring->close();
 }
 
-/*16QAM解调*/
-void _16QAM_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod)
+#ifdef PACKED_AXI
+/*打包端口每帧的字数（mhgd_axi_pack.h）*/
+static const int H_words = axi_pack<H_real_t, H_imag_t, Ntr_2>::words;
+static const int y_words = axi_pack<y_real_t, y_imag_t, Ntr_1>::words;
+static const int x_words = axi_pack<Myreal, Myimage, Ntr_1>::words;
+#endif
+
+struct frame_slot {
+#ifdef MOCK_DEVICE
+#ifdef PACKED_AXI
+    std::vector<axi_word_t> x_hat_mem, H_mem, y_mem;  /*各batch_frames帧*/
+#else
+    std::vector<Myreal> x_hat_real_mem, x_hat_imag_mem;
+    std::vector<H_real_t> H_real_mem;
+    std::vector<H_imag_t> H_imag_mem;
+    std::vector<y_real_t> y_real_mem;
+    std::vector<y_imag_t> y_imag_mem;
+#endif
+    std::vector<unsigned int> seeds_mem;
+#ifdef MHGD_BATCH
+    std::vector<float> sigma2_mem;
+#endif
+#ifdef SOFT_OUTPUT
+    std::vector<int8_t> llr_mem;
+#endif
+#ifdef PROFILE_STAGES
+    std::vector<unsigned int> prof_mem;
+#endif
+    std::future<void> run;
+#else
+#ifdef PACKED_AXI
+    xrt::bo bo_x_hat, bo_H, bo_y;
+#else
+    xrt::bo bo_x_hat_real, bo_x_hat_imag;
+    xrt::bo bo_H_real, bo_H_imag;
+    xrt::bo bo_y_real, bo_y_imag;
+#endif
+    xrt::bo bo_seeds;
+#ifdef MHGD_BATCH
+    xrt::bo bo_sigma2;  /*批处理内核的sigma2为逐帧数组（m_axi）*/
+#endif
+#ifdef SOFT_OUTPUT
+    xrt::bo bo_llr;
+#endif
+#ifdef PROFILE_STAGES
+    xrt::bo bo_prof;
+#endif
+    xrt::run run;
+#endif
+    // 主机侧指针（XRT下为BO映射地址），各有batch_frames帧，第b帧位于b*x_words（打包）或b*Ntr_1、b*Ntr_2处
+#ifdef PACKED_AXI
+    axi_word_t* x_hat; axi_word_t* H; axi_word_t* y;  /*x_words/H_words/y_words个字*/
+#else
+    Myreal* x_hat_real; Myimage* x_hat_imag;
+    H_real_t* H_real; H_imag_t* H_imag;
+    y_real_t* y_real; y_imag_t* y_imag;
+#endif
+    unsigned int* seeds;  /*第b帧第i个采样器的种子位于b*samplers + i*/
+#ifdef MHGD_BATCH
+    float* sigma2;
+#endif
+#ifdef SOFT_OUTPUT
+    int8_t* llr;  /*内核写出的Ntr_1*mu_1个int8 LLR（llr_t为ap_int<8>），比特顺序同QAM_Slicer_hw*/
+#endif
+#ifdef PROFILE_STAGES
+    unsigned int* prof;  /*内核写出的分段计时记录（mhgd_prof.h）*/
+#endif
+    int frame;  /*当前承载的首帧号，-1表示空闲*/
+    int n;      /*承载的帧数（1..batch_frames），帧号为frame..frame+n-1*/
+    int bits[batch_frames][Ntr_1 * mu_1];  /*各帧的参考比特*/
+    int64_t t_start_ns;              /*start()时刻（steady_ns）*/
+    std::atomic<int64_t> t_done_ns;  /*内核完成时刻（steady_ns），由完成回调或模拟线程写入，0表示尚未写入*/
+};
+
+/*单调时钟的纳秒计数，用于跨线程传递完成时刻*/
+static int64_t steady_ns()
 {
-	int i = 0; int j = 0; int best_id = 0;
-	MyComplex temp[16];
-	MyComplex temp_1[16];
-	like_float temp_2;
-	like_float distance[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-	/*for one in x_hat*/
-	for (i = 0; i < Nt; i++)
-	{
-		for (j = 0; j < 16; j++)
-		{
-			temp_1[j].real = x_hat[i].real * hls::sqrt((ap_fixed<64,32>)10.0);
-			temp_1[j].imag = x_hat[i].imag * hls::sqrt((ap_fixed<64,32>)10.0);
-			temp[j].real = temp_1[j].real - _16QAM_Constellation_hw[j].real;
-			temp[j].imag = temp_1[j].imag - _16QAM_Constellation_hw[j].imag;
-		}
-		/*find the closest one*/
-		for (j = 0; j < 16; j++)
-		{
-			temp_2 = (temp[j].real * temp[j].real + temp[j].imag * temp[j].imag);
-			distance[j] = hls::sqrt((ap_fixed<64,32>)temp_2);
-		}
-		best_id = argmin_hw(distance, 16);
-		bits_demod[4 * i] = (best_id >> 3) & 0x01;
-		bits_demod[4 * i + 1] = (best_id >> 2) & 0x01;
-		bits_demod[4 * i + 2] = (best_id >> 1) & 0x01;
-		bits_demod[4 * i + 3] = best_id & 0x01;
-	}
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
-/*64QAM解调*/
-void _64QAM_Demodulation_hw(MyComplex* x_hat, int Nt, int* bits_demod)
+/*一个计算单元及其槽位环*/
+struct cu_ctx {
+#ifdef MOCK_DEVICE
+    std::mutex busy;  /*模拟CU：同一时刻只执行一个run*/
+    int kernel_us;    /*模拟的单帧延时（一次调用n帧延时n倍）*/
+#else
+    xrt::kernel krnl;
+#ifdef GAUSS_TABLE_MODE
+    xrt::bo bo_v_tb_real, bo_v_tb_imag;  /*v_tb各帧共用且内核只读，每个CU一组（在该CU的HBM通道上）*/
+#endif
+#endif
+    frame_slot slots[pipe_depth];
+    int head;      /*最早发射、尚未回收的槽位*/
+    int inflight;  /*在途帧数（0..pipe_depth）*/
+    int frames;    /*累计处理的帧数*/
+    int64_t last_done_ns;  /*该CU上最近回收的一次调用的完成时刻：新调用在它之前无法开始执行（CU命令队列中的等待）*/
+};
+
+#ifdef MOCK_DEVICE
+#ifdef SOFT_OUTPUT
+/*模拟内核的软输出：在迫零解上对全部星座点做max-log，量化规则同内核（llr = round(LLR * llr_gain)，对称饱和）*/
+static void mock_llr(const Myreal* x_hat_real, const Myimage* x_hat_imag, float llr_scale, int8_t* llr)
 {
-	int i = 0; int j = 0; int best_id = 0;
-	MyComplex temp[64];
-	MyComplex temp_1[64];
-	like_float temp_2;
-	like_float distance[64] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-	int int_real; int int_imag;
-	/*for one in x_hat*/
-	for (i = 0; i < Nt; i++)
-	{
-		for (j = 0; j < 64; j++)
-		{
-			temp_1[j].real = x_hat[i].real * hls::sqrt((ap_fixed<64,32>)42.0);
-			temp_1[j].imag = x_hat[i].imag * hls::sqrt((ap_fixed<64,32>)42.0);
-			temp[j].real = temp_1[j].real - _64QAM_Constellation_hw[j].real;
-			temp[j].imag = temp_1[j].imag - _64QAM_Constellation_hw[j].imag;
-			distance[j] = temp[j].real * temp[j].real + temp[j].imag * temp[j].imag;
-		}
-		best_id = argmin_hw(distance, 64);
-		switch ((int)_64QAM_Constellation_hw[best_id].real)
-		{
-		case -7:
-			bits_demod[6 * i] = 0; bits_demod[6 * i + 1] = 0; bits_demod[6 * i + 2] = 0;
-			break;
-		case -5:
-			bits_demod[6 * i] = 0; bits_demod[6 * i + 1] = 0; bits_demod[6 * i + 2] = 1;
-			break;
-		case -3:
-			bits_demod[6 * i] = 0; bits_demod[6 * i + 1] = 1; bits_demod[6 * i + 2] = 1;
-			break;
-		case -1:
-			bits_demod[6 * i] = 0; bits_demod[6 * i + 1] = 1; bits_demod[6 * i + 2] = 0;
-			break;
-		case 1:
-			bits_demod[6 * i] = 1; bits_demod[6 * i + 1] = 1; bits_demod[6 * i + 2] = 0;
-			break;
-		case 3:
-			bits_demod[6 * i] = 1; bits_demod[6 * i + 1] = 1; bits_demod[6 * i + 2] = 1;
-			break;
-		case 5:
-			bits_demod[6 * i] = 1; bits_demod[6 * i + 1] = 0; bits_demod[6 * i + 2] = 1;
-			break;
-		case 7:
-			bits_demod[6 * i] = 1; bits_demod[6 * i + 1] = 0; bits_demod[6 * i + 2] = 0;
-			break;
-		default:
-			break;
-		}
-		switch ((int)_64QAM_Constellation_hw[best_id].imag)
-		{
-		case -7:
-			bits_demod[6 * i + 3] = 0; bits_demod[6 * i + 4] = 0; bits_demod[6 * i + 5] = 0;
-			break;
-		case -5:
-			bits_demod[6 * i + 3] = 0; bits_demod[6 * i + 4] = 0; bits_demod[6 * i + 5] = 1;
-			break;
-		case -3:
-			bits_demod[6 * i + 3] = 0; bits_demod[6 * i + 4] = 1; bits_demod[6 * i + 5] = 1;
-			break;
-		case -1:
-			bits_demod[6 * i + 3] = 0; bits_demod[6 * i + 4] = 1; bits_demod[6 * i + 5] = 0;
-			break;
-		case 1:
-			bits_demod[6 * i + 3] = 1; bits_demod[6 * i + 4] = 1; bits_demod[6 * i + 5] = 0;
-			break;
-		case 3:
-			bits_demod[6 * i + 3] = 1; bits_demod[6 * i + 4] = 1; bits_demod[6 * i + 5] = 1;
-			break;
-		case 5:
-			bits_demod[6 * i + 3] = 1; bits_demod[6 * i + 4] = 0; bits_demod[6 * i + 5] = 1;
-			break;
-		case 7:
-			bits_demod[6 * i + 3] = 1; bits_demod[6 * i + 4] = 0; bits_demod[6 * i + 5] = 0;
-			break;
-		default:
-			break;
-		}
-	}
+    static const qam_slicer_batch slicer(mu_1);
+    const int L = 1 << (mu_1 / 2), M = 1 << mu_1;
+    const double dqam = sqrt(1.5 / (M - 1));
+    double pt_re[1 << mu_1], pt_im[1 << mu_1];
+    int pt_bits[(1 << mu_1) * mu_1];
+    for (int p = 0; p < M; p++) {
+        pt_re[p] = (2 * (p / L) - (L - 1)) * dqam;
+        pt_im[p] = (2 * (p % L) - (L - 1)) * dqam;
+    }
+    slicer(pt_re, pt_im, M, pt_bits);
+    for (int i = 0; i < Ntr_1; i++) {
+        double d[mu_1][2];
+        for (int b = 0; b < mu_1; b++)
+            d[b][0] = d[b][1] = INFINITY;
+        for (int p = 0; p < M; p++) {
+            double er = (double)x_hat_real[i] - pt_re[p], ei = (double)x_hat_imag[i] - pt_im[p];
+            double e = er * er + ei * ei;
+            for (int b = 0; b < mu_1; b++) {
+                double& m = d[b][pt_bits[p * mu_1 + b]];
+                m = (e < m) ? e : m;
+            }
+        }
+        for (int b = 0; b < mu_1; b++) {
+            double v = std::round((d[b][1] - d[b][0]) * llr_scale);
+            llr[i * mu_1 + b] = (int8_t)((v > LLR_MAX) ? LLR_MAX : (v < -LLR_MAX) ? -LLR_MAX : v);
+        }
+    }
 }
-int argmin_hw(like_float* array, int n)
+#endif
+/*模拟内核：H x = y 的迫零解（列主元高斯消元），结果由主机解调器判决*/
+static void mock_kernel(cu_ctx* cu, frame_slot* s
+#ifdef SOFT_OUTPUT
+    , float llr_scale
+#endif
+)
 {
-	int i = 0; int best_id = 0;
-	like_float minval = array[0];
-	for (i = 1; i < n; i++)
-	{
-		if (minval > array[i])
-		{
-			minval = array[i];
-			best_id = i;
-		}
-	}
-	return best_id;
+    std::lock_guard<std::mutex> lock(cu->busy);
+#ifdef PROFILE_STAGES
+    auto t_run = std::chrono::high_resolution_clock::now();
+#endif
+    std::this_thread::sleep_for(std::chrono::microseconds(cu->kernel_us * s->n));
+    for (int b = 0; b < s->n; ++b) {
+#ifdef PACKED_AXI
+        /*与内核一样从打包的字中解出H/y，结果再打包写回，从而同时检验主机的打包格式*/
+        H_real_t H_real[Ntr_2]; H_imag_t H_imag[Ntr_2];
+        y_real_t y_real[Ntr_1]; y_imag_t y_imag[Ntr_1];
+        Myreal x_hat_real[Ntr_1]; Myimage x_hat_imag[Ntr_1];
+        axi_unpack_array(s->H + b * H_words, Ntr_2, H_real, H_imag);
+        axi_unpack_array(s->y + b * y_words, Ntr_1, y_real, y_imag);
+#else
+        const H_real_t* H_real = s->H_real + b * Ntr_2; const H_imag_t* H_imag = s->H_imag + b * Ntr_2;
+        const y_real_t* y_real = s->y_real + b * Ntr_1; const y_imag_t* y_imag = s->y_imag + b * Ntr_1;
+        Myreal* x_hat_real = s->x_hat_real + b * Ntr_1; Myimage* x_hat_imag = s->x_hat_imag + b * Ntr_1;
+#endif
+        typedef std::complex<double> cd;
+        cd A[Ntr_1][Ntr_1 + 1];
+        for (int i = 0; i < Ntr_1; ++i) {
+            for (int j = 0; j < Ntr_1; ++j)
+                A[i][j] = cd((double)H_real[i * Ntr_1 + j], (double)H_imag[i * Ntr_1 + j]);
+            A[i][Ntr_1] = cd((double)y_real[i], (double)y_imag[i]);
+        }
+        for (int c = 0; c < Ntr_1; ++c) {
+            int p = c;
+            for (int i = c + 1; i < Ntr_1; ++i)
+                if (std::abs(A[i][c]) > std::abs(A[p][c])) p = i;
+            for (int j = 0; j <= Ntr_1; ++j) std::swap(A[c][j], A[p][j]);
+            for (int i = 0; i < Ntr_1; ++i) {
+                if (i == c) continue;
+                cd f = A[i][c] / A[c][c];
+                for (int j = c; j <= Ntr_1; ++j) A[i][j] -= f * A[c][j];
+            }
+        }
+        for (int i = 0; i < Ntr_1; ++i) {
+            cd x = A[i][Ntr_1] / A[i][i];
+            x_hat_real[i] = x.real();
+            x_hat_imag[i] = x.imag();
+        }
+#ifdef SOFT_OUTPUT
+        mock_llr(x_hat_real, x_hat_imag, llr_scale, s->llr);  // SOFT_OUTPUT下n恒为1
+#endif
+#ifdef PACKED_AXI
+        axi_pack_array(x_hat_real, x_hat_imag, Ntr_1, s->x_hat + b * x_words);
+#endif
+    }
+#ifdef PROFILE_STAGES
+    /*模拟内核没有分级，只给出总时长（ns）*/
+    std::memset(s->prof, 0, mhgd_prof_words(samplers) * sizeof(unsigned int));
+    s->prof[0] = MHGD_PROF_MAGIC;
+    s->prof[1] = (MHGD_PROF_NS << 16) | samplers;
+    s->prof[2 + PROF_CMP_END] = (unsigned int)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - t_run).count();
+#endif
+    s->t_done_ns = steady_ns();
 }
-/*计算误bit数*/
-int unequal_times_hw(int* array1, int* array2, int n)
+#else
+/*XRT完成回调（在XRT的线程中执行）：只记录完成时刻*/
+static void run_done(const void*, ert_cmd_state, void* data)
 {
-	int unequal = 0; int i = 0;
-	for (i = 0; i < n; i++)
-	{
-		if (array1[i] != array2[i])
-			unequal++;
-	}
-	return unequal;
-}
-
-unsigned int generate_seed(int sampler_id) {
-    // 获取当前时间（秒级精度）
-    time_t now = time(0);
-    
-    // 获取高精度时间（纳秒级）
-    auto now_high_res = std::chrono::high_resolution_clock::now();
-    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        now_high_res.time_since_epoch()
-    ).count();
-    
-    // 混合多种时间源
-    unsigned int seed = static_cast<unsigned int>(now) ^ 
-                       static_cast<unsigned int>(nanos) ^ 
-                       (static_cast<unsigned int>(nanos >> 32)) ^
-                       (sampler_id * 0x9E3779B9);  // 黄金比例常数
-    return seed;
+    static_cast<frame_slot*>(data)->t_done_ns = steady_ns();
 }
+#endif
 
-int main(){
+int main(int argc, char** argv){
+    float SNR = 25.0;
+    const uint64_t master_seed = parse_master_seed(argc, argv);
+    std::cout << "master seed = " << master_seed << " (复现: ./host " << master_seed << ")\n";
+    // ./host <seed> <dataset.bin>：从二进制数据集读取，帧数与SNR取自文件头；否则读取文本文件的max_iter_1帧
+    // SOFT_OUTPUT下可再给出./host <seed> <dataset.bin> <llr.bin>：按帧号顺序写出各帧的Ntr_1*mu_1个int8 LLR
+    mhgd_dataset ds;
+    const bool use_ds = argc > 2;
+    int n_frames = max_iter_1;
+    if (use_ds) {
+        if (!ds.open(argv[2])) throw std::runtime_error("Failed to open dataset");
+        const mhgd_dataset_header& hdr = ds.header();
+        if (hdr.Nt != Ntr_1 || hdr.Nr != Ntr_1 || hdr.mu != mu_1) throw std::runtime_error("Dataset shape does not match Ntr_1/mu_1");
+        SNR = hdr.snr_db;
+        n_frames = (int)hdr.frames;
+        std::cout << "数据集:" << argv[2] << ", " << n_frames << "帧\n";
+    }
+    cu_ctx cus[num_cu];
+#ifdef MOCK_DEVICE
+    for (int c = 0; c < num_cu; ++c)
+        cus[c].kernel_us = mock_kernel_us + c * mock_cu_skew_us;
+    std::cout << "MOCK_DEVICE: 内核由主机线程模拟, " << num_cu << "个CU, 单帧延时 " << mock_kernel_us
+              << " us (+" << mock_cu_skew_us << " us/CU)\n";
+#else
     // ====================== 初始化 FPGA 设备 ======================
-    std::cout << "初始化 FPGA 设备, done! \n";
     int device_index = 0;
     std::string xclbin_path = "/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/hlsKernel/output/MHGD_accel.xclbin";
-    float SNR = 25.0;
 
     auto device = xrt::device(device_index);
     auto uuid = device.load_xclbin(xclbin_path);
-    auto krnl = xrt::kernel(device, uuid, "MHGD_detect_accel_hw");
+    // 各CU按链接配置中的实例名打开（gen_cu_cfg.py：<kernel_name>_1 ... _N），BO按各自的group_id分配
+    for (int c = 0; c < num_cu; ++c)
+        cus[c].krnl = xrt::kernel(device, uuid, std::string(kernel_name) + ":{" + kernel_name + "_" + std::to_string(c + 1) + "}");
+    std::cout << "初始化 FPGA 设备(" << num_cu << "个" << kernel_name << " CU), done! \n";
+#endif
 
     // ====================== 计算 SNR 相关参数 (sigma2)======================
     const float signal_power = static_cast<float>(Ntr_1) / Ntr_1;
-    float sigma2 = (float)Ntr_1 / (float)Ntr_1 * pow(10.0f, -SNR / 10.0f);
+    float sigma2 = signal_power * pow(10.0f, -SNR / 10.0f);
     std::cout<<"sigma2 = "<<sigma2<<std::endl;
+#ifdef SOFT_OUTPUT
+    const float llr_gain = mhgd_llr_gain(sigma2, mu_1);  // LLR量化增益（LSB/nat），下游按LLR = llr / llr_gain还原
+    std::cout << "llr_gain = " << llr_gain << " LSB/nat" << std::endl;
+    FILE* llr_file = NULL;
+    if (argc > 3) {
+        llr_file = fopen(argv[3], "wb");
+        if (!llr_file) throw std::runtime_error("Failed to open LLR output file");
+    }
+#endif
     std::cout << "计算 SNR 相关参数, done! \n";
 
     // ====================== 分配设备内存 ======================
-    // 根据 HLS 接口的 depth 确定缓冲区大小
-    size_t x_size = Ntr_1 * sizeof(Myreal);
-    size_t H_single_size = Ntr_1 * Ntr_1 * sizeof(H_real_t);  // 单个H矩阵的实部或虚部大小
-    size_t y_single_size = Ntr_1 * sizeof(y_real_t);          // 单个y向量的实部或虚部大小
-    size_t v_tb_size = Ntr_1 * iter_1 * sizeof(v_real_t); // depth=256
-    std::cout << "计算x, H, y, v_tb的size, done! \n";
-
-    auto bo_x_hat_real = xrt::bo(device, x_size, krnl.group_id(0));//krnl.group_id()
-    auto bo_x_hat_imag = xrt::bo(device, x_size, krnl.group_id(1));
-    std::cout<<"x内存分配完成!\n";
-    auto bo_H_real = xrt::bo(device, H_single_size, krnl.group_id(2));
-    auto bo_H_imag = xrt::bo(device, H_single_size, krnl.group_id(3));
-    std::cout<<"H内存分配完成!\n";
-    auto bo_y_real = xrt::bo(device, y_single_size, krnl.group_id(4));
-    auto bo_y_imag = xrt::bo(device, y_single_size, krnl.group_id(5));
-    std::cout<<"y内存分配完成!\n";
-    auto bo_v_tb_real = xrt::bo(device, v_tb_size, krnl.group_id(6));
-    auto bo_v_tb_imag = xrt::bo(device, v_tb_size, krnl.group_id(7));
-    auto bo_v_tb_real_2 = xrt::bo(device, v_tb_size, krnl.group_id(8));
-    auto bo_v_tb_imag_2 = xrt::bo(device, v_tb_size, krnl.group_id(9));
-    auto bo_v_tb_real_3 = xrt::bo(device, v_tb_size, krnl.group_id(10));
-    auto bo_v_tb_imag_3 = xrt::bo(device, v_tb_size, krnl.group_id(11));
-    auto bo_v_tb_real_4 = xrt::bo(device, v_tb_size, krnl.group_id(12));
-    auto bo_v_tb_imag_4 = xrt::bo(device, v_tb_size, krnl.group_id(13));
-    std::cout<<"v_tb内存分配完成!\n";
-    std::cout << "分配设备内存, done! \n";
-    // ====================== 映射主机内存 ======================
-    auto x_hat_real_host = bo_x_hat_real.map<Myreal*>();
-    auto x_hat_imag_host = bo_x_hat_imag.map<Myimage*>();
-    auto H_real_host = bo_H_real.map<H_real_t*>();
-    auto H_imag_host = bo_H_imag.map<H_imag_t*>();
-    auto y_real_host = bo_y_real.map<y_real_t*>();
-    auto y_imag_host = bo_y_imag.map<y_imag_t*>();
-    auto v_tb_real_host = bo_v_tb_real.map<v_real_t*>();
-    auto v_tb_imag_host = bo_v_tb_imag.map<v_imag_t*>();
-    auto v_tb_real_host_2 = bo_v_tb_real_2.map<v_real_t*>();
-    auto v_tb_imag_host_2 = bo_v_tb_imag_2.map<v_imag_t*>();
-    auto v_tb_real_host_3 = bo_v_tb_real_3.map<v_real_t*>();
-    auto v_tb_imag_host_3 = bo_v_tb_imag_3.map<v_imag_t*>();
-    auto v_tb_real_host_4 = bo_v_tb_real_4.map<v_real_t*>();
-    auto v_tb_imag_host_4 = bo_v_tb_imag_4.map<v_imag_t*>();
-    
-    
-    std::fill(x_hat_real_host, x_hat_real_host + (x_size / sizeof(Myreal)), 0);
-    std::fill(x_hat_imag_host, x_hat_imag_host + (x_size / sizeof(Myreal)), 0);
-    std::fill(H_real_host, H_real_host + (H_single_size/ sizeof(H_real_t)), 0);
-    std::fill(H_imag_host, H_imag_host + (H_single_size/ sizeof(H_imag_t)), 0);
-    std::fill(y_real_host, y_real_host + (y_single_size/ sizeof(y_real_t)), 0);
-    std::fill(y_imag_host, y_imag_host + (y_single_size/ sizeof(y_imag_t)), 0);
-    std::fill(v_tb_real_host, v_tb_real_host + (v_tb_size/ sizeof(v_real_t)), 0);
-    std::fill(v_tb_imag_host, v_tb_imag_host + (v_tb_size/ sizeof(v_imag_t)), 0);
-    std::fill(v_tb_real_host_2, v_tb_real_host_2 + (v_tb_size/ sizeof(v_real_t)), 0);
-    std::fill(v_tb_imag_host_2, v_tb_imag_host_2 + (v_tb_size/ sizeof(v_imag_t)), 0);
-    std::fill(v_tb_real_host_3, v_tb_real_host_3 + (v_tb_size/ sizeof(v_real_t)), 0);
-    std::fill(v_tb_imag_host_3, v_tb_imag_host_3 + (v_tb_size/ sizeof(v_imag_t)), 0);
-    std::fill(v_tb_real_host_4, v_tb_real_host_4 + (v_tb_size/ sizeof(v_real_t)), 0);
-    std::fill(v_tb_imag_host_4, v_tb_imag_host_4 + (v_tb_size/ sizeof(v_imag_t)), 0);
-    std::cout << "映射主机内存, done! \n";
-
-    // ====================== 文件路径生成 ======================
-    char H_file[256], y_file[256], bits_file[256];//, output_file[256];
-    snprintf(H_file, sizeof(H_file), H_FILE_TEMPLATE, SNR);
-    snprintf(y_file, sizeof(y_file), Y_FILE_TEMPLATE, SNR);
-    snprintf(bits_file, sizeof(bits_file), BITS_FILE_TEMPLATE, SNR);
-    //snprintf(output_file, sizeof(output_file), OUTPUT_FILE_TEMPLATE, SNR);
-    std::cout << "文件路径生成, done! \n";
-    std::cout << "H文件:"<<H_file<<"\n";
-    std::cout << "y文件:"<<y_file<<"\n";
-    std::cout << "原始bit文件:"<<bits_file<<"\n";
-
-    // ====================== 读取输入文件 ======================
-    // 定义预存数组
-    std::cout<<"定义预存数组\n";
-    MyComplex_H input_H[max_iter_1 * Ntr_1 * Ntr_1];
-    std::cout<<"定义预存数组H\n";
-    MyComplex_y input_y[max_iter_1 * Ntr_1];
-    std::cout<<"定义预存数组y\n";
-    int origin_bits[Ntr_1 * mu_1 * max_iter_1];
-    std::cout<<"定义预存数组origin_bits\n";
-    // 读取 H 矩阵（实部+虚部）
-    std::cout<<"H文件读取准备begin\n";
-    std::ifstream fin_H(H_file);
-    std::cout<<"H文件读取begin\n";
-    if (!fin_H) throw std::runtime_error("Failed to open H matrix file");
-    for (int i = 0; i < max_iter_1 * Ntr_1 * Ntr_1; ++i) {
-        fin_H >> input_H[i].real >> input_H[i].imag;
+    // 根据 HLS 接口的 depth 确定缓冲区大小（MOCK_DEVICE下槽位为主机内存，不需要BO大小）；每个槽位batch_frames帧
+#ifndef MOCK_DEVICE
+#ifdef PACKED_AXI
+    size_t x_size = batch_frames * x_words * axi_word_bytes;
+    size_t H_single_size = batch_frames * H_words * axi_word_bytes;  // H矩阵（实虚部打包）大小
+    size_t y_single_size = batch_frames * y_words * axi_word_bytes;  // y向量（实虚部打包）大小
+#else
+    size_t x_size = batch_frames * Ntr_1 * sizeof(Myreal);
+    size_t H_single_size = batch_frames * Ntr_1 * Ntr_1 * sizeof(H_real_t);  // H矩阵的实部或虚部大小
+    size_t y_single_size = batch_frames * Ntr_1 * sizeof(y_real_t);          // y向量的实部或虚部大小
+#endif
+#ifdef GAUSS_TABLE_MODE
+    size_t v_tb_size = samplers * mhgd_num_ran * sizeof(v_real_t); // 各采样器的表顺序存放，与内核的num_ran一致
+#endif
+    size_t seeds_size = batch_frames * samplers * sizeof(unsigned int);
+#ifdef MHGD_BATCH
+    size_t sigma2_size = batch_frames * sizeof(float);
+#endif
+#ifdef SOFT_OUTPUT
+    size_t llr_size = Ntr_1 * mu_1 * sizeof(int8_t);
+#endif
+#ifdef PROFILE_STAGES
+    size_t prof_size = mhgd_prof_words(samplers) * sizeof(unsigned int);
+#endif
+#endif
+    // 内核参数序号：x_hat/H/y在前（PACKED_AXI下3个端口，否则实虚部分开共6个），
+    // 其后依次为v_tb实虚部（仅GAUSS_TABLE_MODE）、标量sigma2、seeds、llr与标量llr_gain（仅SOFT_OUTPUT）、prof（仅PROFILE_STAGES）；
+    // 批处理内核为v_tb实虚部（仅GAUSS_TABLE_MODE）、sigma2数组、seeds、标量frames
+#ifndef MOCK_DEVICE
+#ifdef PACKED_AXI
+    const int arg_io = 3;
+#else
+    const int arg_io = 6;
+#endif
+#ifdef GAUSS_TABLE_MODE
+    const int arg_sigma2 = arg_io + 2;
+#else
+    const int arg_sigma2 = arg_io;
+#endif
+    const int arg_seeds = arg_sigma2 + 1;
+#ifdef MHGD_BATCH
+    const int arg_frames = arg_seeds + 1;
+#endif
+#ifdef SOFT_OUTPUT
+    const int arg_llr = arg_seeds + 1;
+    const int arg_llr_gain = arg_llr + 1;
+#endif
+#ifdef PROFILE_STAGES
+#ifdef SOFT_OUTPUT
+    const int arg_prof = arg_llr_gain + 1;
+#else
+    const int arg_prof = arg_seeds + 1;
+#endif
+#endif
+#endif
+
+#if defined(GAUSS_TABLE_MODE) && !defined(MOCK_DEVICE)
+    for (int c = 0; c < num_cu; ++c) {
+        cus[c].bo_v_tb_real = xrt::bo(device, v_tb_size, cus[c].krnl.group_id(arg_io));
+        cus[c].bo_v_tb_imag = xrt::bo(device, v_tb_size, cus[c].krnl.group_id(arg_io + 1));
     }
-    fin_H.close();
-    std::cout << "读取H文件, done! \n";
-    // 读取 y 向量
-    std::ifstream fin_y(y_file);
-    std::cout<<"y文件读取begin\n";
-    if (!fin_y) throw std::runtime_error("Failed to open y vector file");
-    for (int i = 0; i < max_iter_1 * Ntr_1; ++i) {
-        fin_y >> input_y[i].real >> input_y[i].imag;
+#endif
+    for (int c = 0; c < num_cu; ++c)
+    for (int k = 0; k < pipe_depth; ++k) {
+        frame_slot& s = cus[c].slots[k];
+#ifndef MOCK_DEVICE
+        const xrt::kernel& krnl = cus[c].krnl;
+#endif
+#ifdef MOCK_DEVICE
+#ifdef PACKED_AXI
+        s.x_hat_mem.resize(batch_frames * x_words); s.H_mem.resize(batch_frames * H_words); s.y_mem.resize(batch_frames * y_words);
+        s.x_hat = s.x_hat_mem.data(); s.H = s.H_mem.data(); s.y = s.y_mem.data();
+#else
+        s.x_hat_real_mem.resize(batch_frames * Ntr_1); s.x_hat_imag_mem.resize(batch_frames * Ntr_1);
+        s.H_real_mem.resize(batch_frames * Ntr_2); s.H_imag_mem.resize(batch_frames * Ntr_2);
+        s.y_real_mem.resize(batch_frames * Ntr_1); s.y_imag_mem.resize(batch_frames * Ntr_1);
+        s.x_hat_real = s.x_hat_real_mem.data(); s.x_hat_imag = s.x_hat_imag_mem.data();
+        s.H_real = s.H_real_mem.data(); s.H_imag = s.H_imag_mem.data();
+        s.y_real = s.y_real_mem.data(); s.y_imag = s.y_imag_mem.data();
+#endif
+        s.seeds_mem.resize(batch_frames * samplers);
+        s.seeds = s.seeds_mem.data();
+#ifdef MHGD_BATCH
+        s.sigma2_mem.resize(batch_frames);
+        s.sigma2 = s.sigma2_mem.data();
+#endif
+#ifdef SOFT_OUTPUT
+        s.llr_mem.resize(Ntr_1 * mu_1);
+        s.llr = s.llr_mem.data();
+#endif
+#ifdef PROFILE_STAGES
+        s.prof_mem.resize(mhgd_prof_words(samplers));
+        s.prof = s.prof_mem.data();
+#endif
+#else
+#ifdef PACKED_AXI
+        s.bo_x_hat = xrt::bo(device, x_size, krnl.group_id(0));
+        s.bo_H = xrt::bo(device, H_single_size, krnl.group_id(1));
+        s.bo_y = xrt::bo(device, y_single_size, krnl.group_id(2));
+        s.x_hat = s.bo_x_hat.map<axi_word_t*>();
+        s.H = s.bo_H.map<axi_word_t*>();
+        s.y = s.bo_y.map<axi_word_t*>();
+#else
+        s.bo_x_hat_real = xrt::bo(device, x_size, krnl.group_id(0));
+        s.bo_x_hat_imag = xrt::bo(device, x_size, krnl.group_id(1));
+        s.bo_H_real = xrt::bo(device, H_single_size, krnl.group_id(2));
+        s.bo_H_imag = xrt::bo(device, H_single_size, krnl.group_id(3));
+        s.bo_y_real = xrt::bo(device, y_single_size, krnl.group_id(4));
+        s.bo_y_imag = xrt::bo(device, y_single_size, krnl.group_id(5));
+        s.x_hat_real = s.bo_x_hat_real.map<Myreal*>(); s.x_hat_imag = s.bo_x_hat_imag.map<Myimage*>();
+        s.H_real = s.bo_H_real.map<H_real_t*>(); s.H_imag = s.bo_H_imag.map<H_imag_t*>();
+        s.y_real = s.bo_y_real.map<y_real_t*>(); s.y_imag = s.bo_y_imag.map<y_imag_t*>();
+#endif
+        s.bo_seeds = xrt::bo(device, seeds_size, krnl.group_id(arg_seeds));
+        s.seeds = s.bo_seeds.map<unsigned int*>();
+#ifdef MHGD_BATCH
+        s.bo_sigma2 = xrt::bo(device, sigma2_size, krnl.group_id(arg_sigma2));
+        s.sigma2 = s.bo_sigma2.map<float*>();
+#endif
+#ifdef SOFT_OUTPUT
+        s.bo_llr = xrt::bo(device, llr_size, krnl.group_id(arg_llr));
+        s.llr = s.bo_llr.map<int8_t*>();
+#endif
+#ifdef PROFILE_STAGES
+        s.bo_prof = xrt::bo(device, prof_size, krnl.group_id(arg_prof));
+        s.prof = s.bo_prof.map<unsigned int*>();
+#endif
+#endif
+#ifdef MHGD_BATCH
+        // 各帧SNR相同，sigma2数组只需写入一次
+        for (int b = 0; b < batch_frames; ++b)
+            s.sigma2[b] = sigma2;
+#ifndef MOCK_DEVICE
+        s.bo_sigma2.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+#endif
+#endif
+#ifndef MOCK_DEVICE
+        // run句柄随槽位复用：BO与标量参数在此一次绑定，之后每帧只需（批处理下）更新frames再start()
+        s.run = xrt::run(krnl);
+#ifdef PACKED_AXI
+        s.run.set_arg(0, s.bo_x_hat);
+        s.run.set_arg(1, s.bo_H);
+        s.run.set_arg(2, s.bo_y);
+#else
+        s.run.set_arg(0, s.bo_x_hat_real);
+        s.run.set_arg(1, s.bo_x_hat_imag);
+        s.run.set_arg(2, s.bo_H_real);
+        s.run.set_arg(3, s.bo_H_imag);
+        s.run.set_arg(4, s.bo_y_real);
+        s.run.set_arg(5, s.bo_y_imag);
+#endif
+#ifdef GAUSS_TABLE_MODE
+        s.run.set_arg(arg_io, cus[c].bo_v_tb_real);
+        s.run.set_arg(arg_io + 1, cus[c].bo_v_tb_imag);
+#endif
+#ifdef MHGD_BATCH
+        s.run.set_arg(arg_sigma2, s.bo_sigma2);
+        s.run.set_arg(arg_seeds, s.bo_seeds);
+        s.run.set_arg(arg_frames, batch_frames);
+#else
+        s.run.set_arg(arg_sigma2, sigma2);
+        s.run.set_arg(arg_seeds, s.bo_seeds);
+#endif
+#ifdef SOFT_OUTPUT
+        s.run.set_arg(arg_llr, s.bo_llr);
+        s.run.set_arg(arg_llr_gain, llr_gain);
+#endif
+#ifdef PROFILE_STAGES
+        s.run.set_arg(arg_prof, s.bo_prof);
+#endif
+        s.run.add_callback(ERT_CMD_STATE_COMPLETED, run_done, &s);
+#endif
+        s.frame = -1;
+        s.n = 0;
     }
-    fin_y.close();
-    std::cout << "读取y文件, done! \n";
-    //读取原始bit数据
-    std::ifstream fin_bits(bits_file);
-    std::cout<<"原始bit文件读取begin\n";
-    if (!fin_bits) throw std::runtime_error("Failed to open bits file");
-    for (int i = 0; i < Ntr_1 * mu_1 * max_iter_1; ++i) {
-        fin_bits >> origin_bits[i];
-    }
-    fin_bits.close();
-    std::cout << "读取原始比特文件, done! \n";
-    //读取gauss随机数据
-    MyComplex_v v_tb[Ntr_1 * iter_1];
-    MyComplex_v v_tb_2[Ntr_1 * iter_1];
-    MyComplex_v v_tb_3[Ntr_1 * iter_1];
-    MyComplex_v v_tb_4[Ntr_1 * iter_1];
-    std::cout<<"高斯随机数据读取begin\n";
-    read_gaussian_data_hw_1("/home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt", v_tb, Ntr_1 * iter_1, 0);
-    read_gaussian_data_hw_1("/home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt", v_tb_2, Ntr_1 * iter_1, 0);
-    read_gaussian_data_hw_1("/home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt", v_tb_3, Ntr_1 * iter_1, 0);
-    read_gaussian_data_hw_1("/home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt", v_tb_4, Ntr_1 * iter_1, 0);
-    for (int i = 0; i < Ntr_1 * iter_1; ++i) {
-        v_tb_real_host[i] = v_tb[i].real;
-        v_tb_imag_host[i] = v_tb[i].imag;
+    for (int c = 0; c < num_cu; ++c) {
+        cus[c].head = 0;
+        cus[c].inflight = 0;
+        cus[c].frames = 0;
+        cus[c].last_done_ns = 0;
     }
-    for (int i = 0; i < Ntr_1 * iter_1; ++i) {
-        v_tb_real_host_2[i] = v_tb_2[i].real;
-        v_tb_imag_host_2[i] = v_tb_2[i].imag;
+    std::cout << "分配" << num_cu << "x" << pipe_depth << "组槽位内存, done! \n";
+
+    // ====================== 打开输入文件 ======================
+    // 帧数据由读取线程按需解析，这里只打开文件
+    std::ifstream fin_H, fin_y, fin_bits;
+    if (!use_ds) {
+        char H_file[256], y_file[256], bits_file[256];//, output_file[256];
+        snprintf(H_file, sizeof(H_file), H_FILE_TEMPLATE, SNR);
+        snprintf(y_file, sizeof(y_file), Y_FILE_TEMPLATE, SNR);
+        snprintf(bits_file, sizeof(bits_file), BITS_FILE_TEMPLATE, SNR);
+        //snprintf(output_file, sizeof(output_file), OUTPUT_FILE_TEMPLATE, SNR);
+        std::cout << "H文件:"<<H_file<<"\n";
+        std::cout << "y文件:"<<y_file<<"\n";
+        std::cout << "原始bit文件:"<<bits_file<<"\n";
+        fin_H.open(H_file);
+        if (!fin_H) throw std::runtime_error("Failed to open H matrix file");
+        fin_y.open(y_file);
+        if (!fin_y) throw std::runtime_error("Failed to open y vector file");
+        fin_bits.open(bits_file);
+        if (!fin_bits) throw std::runtime_error("Failed to open bits file");
     }
-    for (int i = 0; i < Ntr_1 * iter_1; ++i) {
-        v_tb_real_host_3[i] = v_tb_3[i].real;
-        v_tb_imag_host_3[i] = v_tb_3[i].imag;
-    }
-    for (int i = 0; i < Ntr_1 * iter_1; ++i) {
-        v_tb_real_host_4[i] = v_tb_4[i].real;
-        v_tb_imag_host_4[i] = v_tb_4[i].imag;
+#if defined(GAUSS_TABLE_MODE) && !defined(MOCK_DEVICE)
+    //读取gauss随机数据
+    MyComplex_v v_tb[mhgd_num_ran];
+    read_gaussian_data_hw_1("/home/ggg_wufuqi/hls/MHGD/gaussian_random_values.txt", v_tb, mhgd_num_ran, 0);
+    for (int c = 0; c < num_cu; ++c) {
+        auto v_tb_real_host = cus[c].bo_v_tb_real.map<v_real_t*>();
+        auto v_tb_imag_host = cus[c].bo_v_tb_imag.map<v_imag_t*>();
+        for (int k = 0; k < samplers; ++k) {
+            for (int i = 0; i < mhgd_num_ran; ++i) {
+                v_tb_real_host[k * mhgd_num_ran + i] = v_tb[i].real;
+                v_tb_imag_host[k * mhgd_num_ran + i] = v_tb[i].imag;
+            }
+        }
+        cus[c].bo_v_tb_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        cus[c].bo_v_tb_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
     }
     std::cout << "读取gauss随机数据文件, done! \n";
-    // ====================== 同步数据到设备 ======================
-    bo_x_hat_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_x_hat_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_H_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_H_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_y_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_y_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_real_2.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_imag_2.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_real_3.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_imag_3.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_real_4.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    bo_v_tb_imag_4.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    std::cout << "同步数据到设备, done! \n";
-    
-    // ====================== 执行内核 ======================
+#endif
+
+    // ====================== 流水线执行 ======================
     int total_error_bits = 0;
     int total_bits = 0;
-    //std::ofstream fout(output_file);
-    //if (!fout) throw std::runtime_error("Failed to create output file");
-    std::cout << "准备进入for循环! \n";
-    for (int iter = 0; iter < max_iter_1; iter++) {
-        // 定义当前迭代的H矩阵以及y向量
-        H_real_t current_H_real[Ntr_1 * Ntr_1];
-        H_imag_t current_H_imag[Ntr_1 * Ntr_1];
-        y_real_t current_y_real[Ntr_1];
-        y_imag_t current_y_imag[Ntr_1];
-        int current_bits[Ntr_1 * mu_1];
-        // 设置当前迭代的输入数据偏移
-        const int H_offset = iter * Ntr_1 * Ntr_1;
-        const int y_offset = iter * Ntr_1;
-        const int bits_offset = iter * Ntr_1 * mu_1;
-        // H和y分离实部/虚部地读取，originbits直接读取
-        for (int j = 0; j < Ntr_1 * Ntr_1; ++j) {
-            current_H_real[j] = input_H[H_offset + j].real;
-            current_H_imag[j] = input_H[H_offset + j].imag;
+    /*每次调用的三段耗时（us）：start->回收（含主机未及时回收的时间）、start->完成（含在CU命令队列中等前一次调用）、
+      执行（从CU空出或start起到完成，即扣除排队后的内核时间）*/
+    double retire_us_sum = 0, done_us_sum = 0, exec_us_sum = 0;
+    int n_calls = 0;  /*内核调用次数（MHGD_BATCH下每次至多batch_frames帧）*/
+#ifdef SOFT_OUTPUT
+    /*LLR符号须与硬判决一致，另统计饱和比例与正确/错误比特的平均|LLR|（同C仿真main_hw.cpp）*/
+    int llr_sign_mismatch = 0, llr_saturated = 0, llr_right = 0, llr_wrong = 0;
+    double llr_abs_right = 0, llr_abs_wrong = 0;
+#endif
+#ifdef PROFILE_STAGES
+    mhgd_prof_acc prof_acc;
+#endif
+
+    /*写入n帧（帧号连续）并上传、在CU cu上启动（不等待完成）*/
+    auto issue = [&](cu_ctx& cu, frame_slot& s, const host_frame* frs, int n) {
+        for (int b = 0; b < n; ++b) {
+            const host_frame& fr = frs[b];
+#ifdef PACKED_AXI
+            axi_pack_array(fr.H_real, fr.H_imag, Ntr_2, s.H + b * H_words);
+            axi_pack_array(fr.y_real, fr.y_imag, Ntr_1, s.y + b * y_words);
+#else
+            std::memcpy(s.H_real + b * Ntr_2, fr.H_real, sizeof(fr.H_real));
+            std::memcpy(s.H_imag + b * Ntr_2, fr.H_imag, sizeof(fr.H_imag));
+            std::memcpy(s.y_real + b * Ntr_1, fr.y_real, sizeof(fr.y_real));
+            std::memcpy(s.y_imag + b * Ntr_1, fr.y_imag, sizeof(fr.y_imag));
+#endif
+            std::memcpy(s.bits[b], fr.bits, sizeof(fr.bits));
+            /*随机种子产生（与逐帧调用相同，批处理结果逐位一致）*/
+            for (int i = 0; i < samplers; i++)
+                s.seeds[b * samplers + i] = generate_seed(master_seed, fr.frame, i);
         }
-        for (int j = 0; j < Ntr_1; ++j) {
-            current_y_real[j] = input_y[y_offset + j].real;
-            current_y_imag[j] = input_y[y_offset + j].imag;
+        s.frame = frs[0].frame;
+        s.n = n;
+        s.t_done_ns = 0;
+        s.t_start_ns = steady_ns();
+#ifdef MOCK_DEVICE
+#ifdef SOFT_OUTPUT
+        s.run = std::async(std::launch::async, mock_kernel, &cu, &s, llr_gain / sigma2);
+#else
+        s.run = std::async(std::launch::async, mock_kernel, &cu, &s);
+#endif
+#else
+        (void)cu;  // run句柄初始化时已绑定到该CU的内核
+#ifdef PACKED_AXI
+        s.bo_H.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        s.bo_y.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+#else
+        s.bo_H_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        s.bo_H_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        s.bo_y_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        s.bo_y_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+#endif
+        s.bo_seeds.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+#ifdef MHGD_BATCH
+        if (n != batch_frames)
+            s.run.set_arg(arg_frames, n);  // 只有数据末尾的一批不满（该槽位之后不再使用）
+#endif
+        s.run.start();
+#endif
+    };
+    /*等待槽位上的各帧完成，回读x_hat并逐帧解调、统计误码，然后释放槽位*/
+    const qam_slicer_batch slicer(mu_1);
+    auto retire = [&](cu_ctx& cu, frame_slot& s) {
+#ifdef MOCK_DEVICE
+        s.run.get();
+#else
+        s.run.wait();
+#endif
+        const int64_t t_retire = steady_ns();
+        // 完成回调与wait()的返回先后没有保证，稍等回调写入完成时刻
+        int64_t t_done;
+        while ((t_done = s.t_done_ns.load()) == 0)
+            std::this_thread::yield();
+        const int64_t t_exec = (s.t_start_ns > cu.last_done_ns) ? s.t_start_ns : cu.last_done_ns;
+        retire_us_sum += (t_retire - s.t_start_ns) / 1e3;
+        done_us_sum += (t_done - s.t_start_ns) / 1e3;
+        exec_us_sum += (t_done - t_exec) / 1e3;
+        cu.last_done_ns = t_done;
+        ++n_calls;
+#ifndef MOCK_DEVICE
+#ifdef PACKED_AXI
+        s.bo_x_hat.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+#else
+        s.bo_x_hat_real.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        s.bo_x_hat_imag.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+#endif
+#ifdef SOFT_OUTPUT
+        s.bo_llr.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+#endif
+#ifdef PROFILE_STAGES
+        s.bo_prof.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+#endif
+#endif
+#ifdef PROFILE_STAGES
+        if (!prof_acc.add(s.prof))
+            std::cerr << "帧" << s.frame << "的分段计时记录无效（内核未以PROFILE_STAGES编译？）\n";
+#endif
+        for (int b = 0; b < s.n; ++b) {
+            int bits_demod[Ntr_1 * mu_1];
+            double x_hat_re[Ntr_1], x_hat_im[Ntr_1];
+#ifdef PACKED_AXI
+            Myreal x_hat_real[Ntr_1]; Myimage x_hat_imag[Ntr_1];
+            axi_unpack_array(s.x_hat + b * x_words, Ntr_1, x_hat_real, x_hat_imag);
+#else
+            const Myreal* x_hat_real = s.x_hat_real + b * Ntr_1; const Myimage* x_hat_imag = s.x_hat_imag + b * Ntr_1;
+#endif
+            for (int i = 0; i < Ntr_1; i++) {
+                x_hat_re[i] = (double)x_hat_real[i];
+                x_hat_im[i] = (double)x_hat_imag[i];
+            }
+            slicer(x_hat_re, x_hat_im, Ntr_1, bits_demod);
+            int error_bits = unequal_times_hw(bits_demod, s.bits[b], Ntr_1 * mu_1);
+            total_error_bits += error_bits;
+            total_bits += mu_1 * Ntr_1;
+#ifdef SOFT_OUTPUT
+            for (int l = 0; l < Ntr_1 * mu_1; l++) {
+                const int q = s.llr[l];
+                llr_sign_mismatch += bits_demod[l] ? (q > 0) : (q < 0);
+                llr_saturated += (q == LLR_MAX || q == -LLR_MAX);
+                if (bits_demod[l] == s.bits[b][l]) {
+                    llr_abs_right += abs(q);
+                    llr_right++;
+                } else {
+                    llr_abs_wrong += abs(q);
+                    llr_wrong++;
+                }
+            }
+            if (llr_file) {
+                // 多CU时帧可能乱序完成，按帧号定位写入
+                fseek(llr_file, (long)(s.frame + b) * Ntr_1 * mu_1, SEEK_SET);
+                fwrite(s.llr, 1, Ntr_1 * mu_1, llr_file);
+            }
+#endif
+            std::cout << "Iter " << s.frame + b + 1 << "/" << n_frames
+                      << ", Errors: " << error_bits
+                      << ", Total Errors: " << total_error_bits << std::endl;
         }
-        for (int j = 0; j < Ntr_1 * mu_1; ++j) {
-            current_bits[j] = origin_bits[j + bits_offset];
+        s.frame = -1;
+    };
+    /*回收CU cu最早发射的帧（同一CU上的帧按序完成）*/
+    auto retire_head = [&](cu_ctx& cu) {
+        retire(cu, cu.slots[cu.head]);
+        cu.head = (cu.head + 1) % pipe_depth;
+        --cu.inflight;
+    };
+#ifdef CU_SCHED_LEAST_LOADED
+    /*槽位上的帧是否已完成（不阻塞）*/
+    auto slot_done = [&](frame_slot& s) -> bool {
+#ifdef MOCK_DEVICE
+        return s.run.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+#else
+        return s.run.state() == ERT_CMD_STATE_COMPLETED;
+#endif
+    };
+#endif
+    /*为下一帧选择CU*/
+    int next_cu = 0;
+    auto pick_cu = [&]() -> int {
+#ifdef CU_SCHED_LEAST_LOADED
+        // 先回收各CU已完成的帧，使在途帧数反映真实负载；并列时从上次所选的下一个CU开始比较，避免总偏向CU0
+        for (int c = 0; c < num_cu; ++c)
+            while (cus[c].inflight > 0 && slot_done(cus[c].slots[cus[c].head]))
+                retire_head(cus[c]);
+        int best = next_cu;
+        for (int k = 1; k < num_cu; ++k) {
+            int c = (next_cu + k) % num_cu;
+            if (cus[c].inflight < cus[best].inflight)
+                best = c;
         }
-
-        // 写入H的实部和虚部
-        void* bo_H_real_ptr = bo_H_real.map<void*>(); // 映射到主机指针
-        std::memcpy(bo_H_real_ptr, current_H_real, H_single_size); // 拷贝数据
-        void* bo_H_imag_ptr = bo_H_imag.map<void*>();
-        std::memcpy(bo_H_imag_ptr, current_H_imag, H_single_size);
-        // 写入y的实部和虚部
-        void* bo_y_real_ptr = bo_y_real.map<void*>();
-        std::memcpy(bo_y_real_ptr, current_y_real, y_single_size);
-        void* bo_y_imag_ptr = bo_y_imag.map<void*>();
-        std::memcpy(bo_y_imag_ptr, current_y_imag, y_single_size);
-
-        // // [!] 打印输入数据
-        // std::cout << "\n\n[DEBUG] ===== Iteration " << iter << " Input Data =====\n";
-        // // 打印H矩阵 (仅打印前2x2部分)
-        // std::cout << "H Matrix (first 2x2 elements):\n";
-        // for (int i = 0; i < 2; ++i) {
-        //     for (int j = 0; j < 2; ++j) {
-        //         int idx = i * Ntr_1 + j;
-        //         std::cout << "H[" << i << "][" << j << "] = (" 
-        //                   << current_H_real[idx] << " + " 
-        //                   << current_H_imag[idx] << "j)\t";
-        //     }
-        //     std::cout << std::endl;
-        // }
-
-        // // 打印y向量 (前5个元素)
-        // std::cout << "\ny Vector (first 5 elements):\n";
-        // for (int i = 0; i < 5; ++i) {
-        //     std::cout << "y[" << i << "] = (" 
-        //               << current_y_real[i] << " + " 
-        //               << current_y_imag[i] << "j)\n";
-        // }
-
-        // // 打印v_tb (前5个元素)
-        // std::cout << "\nv_tb (first 5 elements):\n";
-        // for (int i = 0; i < 5; ++i) {
-        //     std::cout << "v_tb[" << i << "] = (" 
-        //               << v_tb_real_host[i] << " + " 
-        //               << v_tb_imag_host[i] << "j)\n";
-        // }
-
-        // // 打印origin_bits (前5个元素)
-        // std::cout << "\norigin_bits (first 5 elements):\n";
-        // for (int i = 0; i < 5; ++i) {
-        //     std::cout << "origin_bits[" << i << "] = " 
-        //               << current_bits[i] << "\n";
-        // }
-
-        // // 打印sigma2
-        // std::cout << "\nsigma2 = " << sigma2 << std::endl;
-        /*随机种子产生*/
-        unsigned int seed[samplers];
-        for (int i = 0; i < samplers; i++) {
-           seed[i] = generate_seed(i);
-           std::this_thread::sleep_for(std::chrono::microseconds(100 * (i + 1)));
+        if (cus[best].inflight == pipe_depth) {
+            // 所有CU都满载：等最早发射的帧（其CU最先空出槽位）
+            for (int c = 0; c < num_cu; ++c)
+                if (cus[c].slots[cus[c].head].t_start_ns < cus[best].slots[cus[best].head].t_start_ns)
+                    best = c;
         }
-
-        //同步数据到设备
-        bo_H_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_H_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_y_real.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        bo_y_imag.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-
-        // 记录开始时间点
-        auto start_time = std::chrono::high_resolution_clock::now();
-
-        // 执行内核
-        auto run = krnl(bo_x_hat_real,          // group_id(0)
-                        bo_x_hat_imag,          // group_id(1)
-                        bo_H_real,              // group_id(2)
-                        bo_H_imag,              // group_id(3)
-                        bo_y_real,              // group_id(4)
-                        bo_y_imag,              // group_id(5)
-                        bo_v_tb_real,           // group_id(6)
-                        bo_v_tb_imag,           // group_id(7)
-                        bo_v_tb_real_2,           // group_id(6)
-                        bo_v_tb_imag_2,           // group_id(7)
-                        bo_v_tb_real_3,           // group_id(6)
-                        bo_v_tb_imag_3,           // group_id(7)
-                        bo_v_tb_real_4,           // group_id(6)
-                        bo_v_tb_imag_4,           // group_id(7)
-                        sigma2,                  // 标量参数
-                        seed[0],
-                        seed[1],
-                        seed[2],
-                        seed[3]
-        );
-        run.wait();
-        // 计算耗时
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-        // 打印耗时（保留3位小数）
-        std::cout << "[Perf] Iter " << iter 
-        << " Kernel Time: " 
-        << std::fixed << std::setprecision(3) 
-        << duration.count() / 1000.0  // 转换为毫秒
-        << " ms\n";
-        std::cout << "(for)内核结束第" << iter + 1 << "次结束!\n";
-        // 回读结果
-        bo_x_hat_real.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-        bo_x_hat_imag.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-
-        std::cout << "\n[DEBUG] ===== Pre-Demodulation Data (Iter " << iter << ") =====" << std::endl;
-        // 解调
-        int bits_demod[Ntr_1 * mu_1];
-        MyComplex x_hat[8];
-	    for(int i=0; i<8; i++){
-	    	x_hat[i].real = x_hat_real_host[i];
-	    	x_hat[i].imag = x_hat_imag_host[i];
-	    }
-        // 打印x_hat前5个元素的实部虚部
-        std::cout << "x_hat_real_host (first 5 elements):" << std::endl;
-        for (int i = 0; i < 5 && i < Ntr_1; ++i) {
-            std::cout << "x_hat_real[" << i << "] = " << x_hat[i].real 
-                      << std::endl;
-        }
-
-        std::cout << "x_hat_imag_host (first 5 elements):" << std::endl;
-        for (int i = 0; i < 5 && i < Ntr_1; ++i) {
-            std::cout << "x_hat_imag[" << i << "] = " << x_hat[i].imag
-                      << std::endl;
-        }
-        QAM_Demodulation_hw_de(x_hat, Ntr_1, mu_1, bits_demod);
-        std::cout << "(for)解调结束第" << iter + 1 << "次结束!\n";
-        // ============== 新增：打印解调结果 ==============
-        //const int print_count = 20; // 打印前20个比特
-        //std::cout << "\n[DEMOD DEBUG] === Iter " << iter << " Demod Result ===" << std::endl;
-        //std::cout << "First " << print_count << " bits: [";
-        //for (int i = 0; i < print_count; ++i) {
-        //    if (i >= Ntr_1 * mu_1) break; // 安全边界检查
-
-        //    // 标注非法值（非0/1）
-        //    const int bit = bits_demod[i];
-        //    if (bit != 0 && bit != 1) {
-        //        std::cout << "\033[31m" << bit << "\033[0m"; // 红色显示非法值
-        //    } else {
-        //        std::cout << bit;
-        //    }
-
-        //    if (i != print_count - 1) std::cout << ", ";
-        //}
-        //std::cout << "]" << std::endl;
-
-        //// 写入解调结果
-        //for (int i = 0; i < Ntr_1 * mu_1; ++i) {
-        //    fout << bits_demod[i] << std::endl;
-        //}
-
-        // 计算误码率
-        int error_bits = 0;
-        error_bits = unequal_times_hw(bits_demod, current_bits, Ntr_1 * mu_1);
-        total_error_bits += error_bits;
-        total_bits += mu_1 * Ntr_1;
-        std::cout << "Iter " << iter + 1 << "/" << max_iter_1 
-                  << ", Errors: " << error_bits 
-                  << ", Total Errors: " << total_error_bits << std::endl;
-    }
+        next_cu = (best + 1) % num_cu;
+        return best;
+#else
+        int c = next_cu;
+        next_cu = (next_cu + 1) % num_cu;
+        return c;
+#endif
+    };
+
+    static frame_ring ring;  // 读取线程 -> 启动循环
+    std::thread producer(frame_producer, &ring, use_ds ? &ds : (const mhgd_dataset*)NULL,
+                         &fin_H, &fin_y, &fin_bits, n_frames);
+    auto t_begin = std::chrono::high_resolution_clock::now();
+    static host_frame frs[batch_frames];
+    int f = 0, n = 0;
+    /*把攒下的n帧发往选定CU*/
+    auto dispatch = [&]() {
+        cu_ctx& cu = cus[pick_cu()];
+        if (cu.inflight == pipe_depth)
+            retire_head(cu);
+        issue(cu, cu.slots[(cu.head + cu.inflight) % pipe_depth], frs, n);
+        ++cu.inflight;
+        cu.frames += n;
+        f += n;
+        n = 0;
+    };
+    while (ring.pop(frs[n]))
+        if (++n == batch_frames)
+            dispatch();
+    if (n > 0)
+        dispatch();  // 末尾不足batch_frames帧
+    producer.join();
+    n_frames = f;  // 文本文件可能不足max_iter_1帧
+    // 排空：逐个CU按发射顺序回收剩余槽位
+    for (int c = 0; c < num_cu; ++c)
+        while (cus[c].inflight > 0)
+            retire_head(cus[c]);
+    auto t_total = std::chrono::high_resolution_clock::now();
+    double wall_s = std::chrono::duration_cast<std::chrono::microseconds>(t_total - t_begin).count() / 1e6;
 
     // ====================== 计算最终 BER ======================
     const float BER = (float)total_error_bits / (float)total_bits;
-    std::cout << "\nFinal Result - SNR: " << SNR 
+    std::cout << "\nFinal Result - SNR: " << SNR
               << ", BER: " << BER << std::endl;
+    std::cout << std::fixed << std::setprecision(3)
+              << "[Perf] cu=" << num_cu << ", pipe_depth=" << pipe_depth << ", batch=" << batch_frames
+              << ", frames=" << n_frames << ", calls=" << n_calls
+              << ", wall=" << wall_s * 1000.0 << " ms"
+              << ", sustained=" << n_frames / wall_s << " frames/s"
+              << std::endl;
+    std::cout << "[Perf] avg per call: start->retire=" << retire_us_sum / n_calls / 1000.0
+              << " ms, start->done(含CU排队)=" << done_us_sum / n_calls / 1000.0
+              << " ms, exec=" << exec_us_sum / n_calls / 1000.0 << " ms" << std::endl;
+    // 单帧成本：吞吐的倒数（多CU并行摊薄），以及单次调用的执行时间按帧平均（批处理摊薄启动与传输开销）
+    std::cout << "[Perf] per frame: wall=" << wall_s * 1e6 / n_frames << " us"
+              << ", exec=" << exec_us_sum / n_frames << " us" << std::endl;
+#ifdef CU_SCHED_LEAST_LOADED
+    std::cout << "[Sched] least-loaded:";
+#else
+    std::cout << "[Sched] round-robin:";
+#endif
+    for (int c = 0; c < num_cu; ++c)
+        std::cout << " CU" << c << "=" << cus[c].frames;
+    std::cout << " frames" << std::endl;
+#ifdef SOFT_OUTPUT
+    std::cout << std::setprecision(2)
+              << "[LLR] bits=" << total_bits << ", sign mismatches=" << llr_sign_mismatch
+              << ", saturated=" << 100.0 * llr_saturated / total_bits << "%"
+              << ", mean |LLR| right=" << (llr_right ? llr_abs_right / llr_right : 0.0)
+              << ", wrong=" << (llr_wrong ? llr_abs_wrong / llr_wrong : 0.0)
+              << " (llr_gain=" << std::setprecision(4) << llr_gain << " LSB/nat)" << std::endl;
+    if (llr_file)
+        fclose(llr_file);
+#endif
+#ifdef PROFILE_STAGES
+    prof_acc.print(stdout, prof_clock_mhz);
+#endif
 
     return 0;
-}
\ No newline at end of file
+}
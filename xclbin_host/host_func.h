@@ -1,6 +1,7 @@
 #pragma once
 #include "MyComplex_1.h"
 #include "hls_math.h"
+#include "mhgd_iface.h"
 
 
 typedef struct _IO_FILE FILE;
@@ -16,11 +17,39 @@ const char* GAUSS_TEMPLATE_3 = "/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_g
 const char* GAUSS_TEMPLATE_4 = "/home/ggg_wufuqi/hls/MIMO_detect-main/mimo_cpp_gai/gaussian_random_values_plus_4.txt";
 
 /*算法参数*/
-static const int Ntr_1 = 8;/*发射&接收天线数*/
+static const int Ntr_1 = mhgd_ntr;/*发射&接收天线数*/
 static const int Ntr_2 = 64;/*NtorNr^2*/
-static const int iter_1 = 8;/*采样器的采样数*/
 static const int mu_1 = 2;/*调制阶数*/
 static const int mmse_init_1 = 0;/*是否使用MMSE检测的结果作为MCMC采样的初始值*/
 static const int lr_approx_1 = 0;
-static const int samplers = 4; /*采样器数量*/
-static const int max_iter_1 = 100;/*希望仿真的最大轮数*/
\ No newline at end of file
+// #define GAUSS_TABLE_MODE	/*须与内核编译选项一致：打开时内核带v_tb端口，由主机提供高斯表*/
+// #define SOFT_OUTPUT	/*须与内核编译选项一致：打开时内核在seeds之后带llr输出口与标量llr_gain，主机逐帧回读int8 LLR*/
+// #define PACKED_AXI	/*须与内核编译选项一致：打开时H/y/x_hat以512位字打包传输（格式见mhgd_axi_pack.h），内核只有3个数据端口*/
+#ifndef MHGD_SAMPLERS
+#define MHGD_SAMPLERS 4
+#endif
+static const int samplers = MHGD_SAMPLERS; /*采样器数量，须与内核编译时的MHGD_SAMPLERS一致*/
+static const int max_iter_1 = 100;/*希望仿真的最大轮数（文本输入时；二进制数据集的帧数取自文件头）*/
+static const int pipe_depth = 2;/*主机流水线槽位数：2为乒乓双缓冲，1退化为串行的上传-运行-回读*/
+#ifndef MHGD_CU
+#define MHGD_CU 1
+#endif
+static const int num_cu = MHGD_CU;/*内核计算单元(CU)数，须与链接配置一致（gen_cu_cfg.py --cu）；每个CU各有pipe_depth个槽位*/
+// #define CU_SCHED_LEAST_LOADED	/*打开时新帧发给在途帧最少的CU，否则按帧号轮询*/
+// #define MHGD_BATCH 16	/*打开时主机调用批处理内核MHGD_detect_accel_hw_batch，每次调用检测MHGD_BATCH帧（不超过mhgd_max_batch），须与链接的内核一致*/
+#ifdef MHGD_BATCH
+#if defined(SOFT_OUTPUT) || defined(PROFILE_STAGES)
+#error "批处理内核没有llr/prof端口，MHGD_BATCH不能与SOFT_OUTPUT/PROFILE_STAGES同时打开"
+#endif
+static const int batch_frames = MHGD_BATCH;/*每个槽位（一次内核调用）承载的帧数*/
+static const char* const kernel_name = "MHGD_detect_accel_hw_batch";
+#else
+static const int batch_frames = 1;
+static const char* const kernel_name = "MHGD_detect_accel_hw";
+#endif
+static_assert(batch_frames >= 1 && batch_frames <= mhgd_max_batch, "MHGD_BATCH must be in 1..mhgd_max_batch");
+// #define MOCK_DEVICE	/*打开时不访问XRT/板卡，内核由主机线程模拟(固定延时+迫零检测)，用于无卡验证主机流水线*/
+static const int mock_kernel_us = 200;/*MOCK_DEVICE下模拟的单帧内核延时(us)*/
+static const int mock_cu_skew_us = 0;/*MOCK_DEVICE下第c个CU的单帧延时再加c*mock_cu_skew_us(us)，模拟快慢不一的CU以检验调度*/
+static const double prof_clock_mhz = 100.0;/*PROFILE_STAGES下把周期换算为us所用的内核时钟(MHz)，须与makefile中的CLOCK_FREQ_MHZ一致*/
+static const int frame_ring_depth = 64;/*读取线程与启动循环之间的帧队列深度（2的幂），决定主机侧帧缓存的内存上限*/
@@ -0,0 +1,49 @@
+#pragma once
+/*
+ * 单生产者/单消费者无锁环形队列（容量N须为2的幂）。
+ * 生产者只写tail_，消费者只写head_，二者各占一条cache line，push/pop不加锁、不进系统调用；
+ * 队满/队空时push/pop以yield自旋等待。生产者结束后调用close()，消费者pop在取空后返回false。
+ */
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+template<typename T, size_t N>
+class spsc_ring {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_ring capacity must be a power of two");
+public:
+    spsc_ring() : head_(0), tail_(0), closed_(false) {}
+
+    /*生产者：写入一项，队满时等待*/
+    void push(const T& v)
+    {
+        const size_t t = tail_.load(std::memory_order_relaxed);
+        while (t - head_.load(std::memory_order_acquire) == N)
+            std::this_thread::yield();
+        buf_[t & (N - 1)] = v;
+        tail_.store(t + 1, std::memory_order_release);
+    }
+
+    /*生产者：不再写入*/
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    /*消费者：取出一项；队空且已close时返回false*/
+    bool pop(T& v)
+    {
+        const size_t h = head_.load(std::memory_order_relaxed);
+        while (tail_.load(std::memory_order_acquire) == h) {
+            if (closed_.load(std::memory_order_acquire) && tail_.load(std::memory_order_acquire) == h)
+                return false;
+            std::this_thread::yield();
+        }
+        v = buf_[h & (N - 1)];
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+    alignas(64) std::atomic<bool> closed_;
+    T buf_[N];
+};